@@ -0,0 +1,22 @@
+# 校验、摘要算法基准测试（命令行程序）：检查"123456789"等测试向量，测量全部CRC、累加和、
+# 摘要算法在4B~16MiB各数据长度下的ns/B、GB/s和cycles/B，结果可保存为JSON并与基线比较。
+# 用法见main.cpp文件头，基准测试应使用release版本
+QT = core concurrent
+
+TEMPLATE = app
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+# You can make your code fail to compile if it uses deprecated APIs.
+# In order to do so, uncomment the following line.
+#DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
+
+#校验、摘要算法静态库
+include(../Checksum/checksum.pri)
+
+SOURCES += \
+    benchmark.cpp \
+    main.cpp
+
+HEADERS += \
+    benchmark.h
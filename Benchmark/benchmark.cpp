@@ -0,0 +1,668 @@
+#include "benchmark.h"
+#include "checkalgorithm.h"
+#include "checksumbatch.h"
+#include "cpufeatures.h"
+#include "crcmodel.h"
+#include "crcreveng.h"
+#include "hashcontext.h"
+#include "multibufferhash.h"
+#include "xxh3.h"
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QRandomGenerator>
+#include <QSysInfo>
+#include <QTemporaryFile>
+#include <QThread>
+#include <QThreadPool>
+#include <QtEndian>
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <memory>
+
+#if defined(Q_PROCESSOR_X86)
+#  if defined(Q_CC_MSVC)
+#    include <intrin.h>
+#  else
+#    include <x86intrin.h>
+#  endif
+#endif
+
+namespace
+{
+    // 计时循环的结果写入这里，防止计算被优化掉
+    volatile quint64 sink;
+
+    inline quint64 readCycles()
+    {
+#if defined(Q_PROCESSOR_X86)
+        return __rdtsc();
+#else
+        return 0;
+#endif
+    }
+
+    // 低bytes个字节按大端存放
+    QByteArray toBigEndian(quint64 value, int bytes)
+    {
+        QByteArray code(bytes, 0);
+        for(auto i = 0; i < bytes; ++i)
+            code[bytes - 1 - i] = char(value >> (8 * i));
+        return code;
+    }
+
+    // 摘要的前8个字节，计时时代表整个结果
+    quint64 firstWord(const QByteArray &digest)
+    {
+        return qFromUnaligned<quint64>(digest.constData());
+    }
+
+    // BLAKE3官方测试向量使用的数据：第i个字节为i % 251
+    QByteArray patternData(qint64 size)
+    {
+        QByteArray data(int(size), 0);
+        for(auto i = 0; i < size; ++i)
+            data[i] = char(i % 251);
+        return data;
+    }
+
+    // 超过1MiB、不是整块的长数据，覆盖多路压缩、多线程以及不完整的尾部
+    constexpr qint64 LongVectorSize = (qint64(1) << 20) + 1025;
+
+    const QByteArray CheckInput("123456789");
+
+    struct HashVectors
+    {
+        const char *name;
+        HashContext::Algorithm algorithm;
+        // "123456789"、空串、"abc"、LongVectorSize字节的patternData
+        const char *check;
+        const char *empty;
+        const char *abc;
+        const char *longData;
+    };
+
+    const HashVectors HashTable[] = {
+        { "MD5", HashContext::Md5,
+          "25f9e794323b453885f5181f1b624d0b",
+          "d41d8cd98f00b204e9800998ecf8427e",
+          "900150983cd24fb0d6963f7d28e17f72",
+          "2e1ee7ac5f0d6113051dc4229daa30c3" },
+        { "SHA1", HashContext::Sha1,
+          "f7c3bc1d808e04732adf679965ccc34ca7ae3441",
+          "da39a3ee5e6b4b0d3255bfef95601890afd80709",
+          "a9993e364706816aba3e25717850c26c9cd0d89d",
+          "e895462a7f7d60750be486ef6a902a1bc1874a76" },
+        { "SHA256", HashContext::Sha256,
+          "15e2b0d3c33891ebb0f1ef609ec419420c20e320ce94c65fbc8c3312448eb225",
+          "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855",
+          "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad",
+          "a8f269b9a885e9be86bf81974918f55671447cd7adc1b55b180cd131ca7f19dd" },
+        { "XXH3_64", HashContext::Xxh3_64,
+          "72dcb18b67a17dff",
+          "2d06800538d394c2",
+          "78af5f94892f3950",
+          "1ec4d594312dd886" },
+        { "XXH3_128", HashContext::Xxh3_128,
+          "33119477ede5dcd5e9716427681d5860",
+          "99aa06d3014798d86001c324468d497f",
+          "06b05ab6733a618578af5f94892f3950",
+          "789a3360443b11ec1ec4d594312dd886" },
+        { "BLAKE3", HashContext::Blake3_256,
+          "b7d65b48420d1033cb2595293263b6f72eabee20d55e699d0df1973b3c9deed1",
+          "af1349b9f5f9a1a6a0404dea36dcc9499bcb25c9adc112b7cc9a93cae41f3262",
+          "6437b3ac38465133ffb63b75273a8db548c558465d79db03fd359c6cd5bd9d85",
+          "860f19b5fefff01454de342be87a20059449529116a20fb22a21da665aafa071" },
+    };
+
+    // 多缓冲区摘要把数据按该长度分帧，模拟大量短帧
+    constexpr qint64 MultiBufferFrameLen = 256;
+
+    // 多路并行计算各帧的摘要，按帧的顺序拼接
+    QByteArray multiBufferResult(HashContext::Algorithm algorithm, const char *data, qint64 dataLen)
+    {
+        const int count = int((dataLen + MultiBufferFrameLen - 1) / MultiBufferFrameLen);
+        QVector<const char*> frames(count);
+        QVector<qint64> lengths(count);
+        for(auto i = 0; i < count; ++i)
+        {
+            frames[i] = data + i * MultiBufferFrameLen;
+            lengths[i] = qMin(MultiBufferFrameLen, dataLen - i * MultiBufferFrameLen);
+        }
+        QByteArray digests(count * HashContext::digestLength(algorithm), Qt::Uninitialized);
+        MultiBufferHash::hash(algorithm, frames.constData(), lengths.constData(), count,
+                              reinterpret_cast<uchar*>(digests.data()));
+        return digests;
+    }
+
+    // 期望值：逐帧用HashContext计算
+    QByteArray frameDigests(HashContext::Algorithm algorithm, const QByteArray &data)
+    {
+        QByteArray digests;
+        for(qint64 pos = 0; pos < data.size(); pos += MultiBufferFrameLen)
+            digests += HashContext::compute(algorithm, data.constData() + pos, qMin(MultiBufferFrameLen, data.size() - pos));
+        return digests;
+    }
+
+    // 文件计算的测试项对比的算法
+    const char *const FileAlgorithm = "Crc32_WinRAR";
+    // 多于两个分块、不是整块的数据，覆盖computeFile的多线程分块及合并
+    constexpr qint64 FileVectorSize = (qint64(3) << 20) + 1;
+
+    // 文件计算的测试项共用的临时文件，内容为最近一次写入的数据
+    struct FileInput
+    {
+        QTemporaryFile file;
+        const char *data = nullptr;
+        qint64 size = -1;
+    };
+
+    // 把data写入临时文件后用computeFile计算，计算期间全局线程池最多使用threads个线程。
+    // 计时循环中数据不变，同一块数据只写一次；rewrite为true时总是重写（检查测试向量时使用）
+    quint64 computeFileResult(FileInput *input, CheckAlgorithm::ComputeFileFunc computeFile, int threads,
+                              const char *data, qint64 dataLen, bool rewrite)
+    {
+        if(rewrite || data != input->data || dataLen != input->size)
+        {
+            input->data = nullptr;
+            if(!input->file.isOpen() && !input->file.open())
+                return 0;
+            if(!input->file.resize(0) || !input->file.seek(0)
+                    || input->file.write(data, dataLen) != dataLen || !input->file.flush())
+                return 0;
+            input->data = data;
+            input->size = dataLen;
+        }
+
+        QFile file(input->file.fileName());
+        if(!file.open(QIODevice::ReadOnly))
+            return 0;
+        QThreadPool *pool = QThreadPool::globalInstance();
+        const int maxThreads = pool->maxThreadCount();
+        pool->setMaxThreadCount(threads);
+        quint64 result = 0;
+        if(!computeFile(file, &result, nullptr, nullptr))
+            result = 0;
+        pool->setMaxThreadCount(maxThreads);
+        return result;
+    }
+
+    // 反推CRC参数的样本：依次从数据中取这些长度的消息，各自加上帧尾校验码
+    const int RevengFrameLengths[] = { 16, 16, 23, 31 };
+
+    // 反推的目标算法及帧尾校验码的字节序
+    struct RevengTarget
+    {
+        const char *name;
+        bool bigEndian;
+    };
+
+    const RevengTarget RevengTable[] = {
+        { "Crc16_MODBUS", false },
+        { "Crc32_WinRAR", true },
+    };
+
+    // CRC参数及帧尾校验码的字节序
+    QByteArray paramsBytes(const CheckAlgorithm *algorithm, bool bigEndian)
+    {
+        return toBigEndian(algorithm->poly, 8) + toBigEndian(algorithm->init, 8) + toBigEndian(algorithm->xorOut, 8)
+                + char(algorithm->refIn) + char(algorithm->refOut) + char(bigEndian);
+    }
+
+    // 用algorithm生成样本帧后反推CRC参数：结果中有algorithm的参数时返回这组参数，否则返回空。
+    // 有的算法存在对任意帧都等价的其它参数组合（如CRC-16/MODBUS的多项式含x+1因式，
+    // 另有一组Init、XorOut与之等价），因此只要求结果中包含目标参数
+    QByteArray revengResult(const CheckAlgorithm *algorithm, bool bigEndian, const char *data, qint64 dataLen)
+    {
+        const int bytes = algorithm->bytes();
+        QVector<QByteArray> frames;
+        qint64 offset = 0;
+        for(const int len : RevengFrameLengths)
+        {
+            if(offset + len > dataLen)
+                break;
+            QByteArray code = toBigEndian(algorithm->compute(data + offset, len), bytes);
+            if(!bigEndian)
+                std::reverse(code.begin(), code.end());
+            frames.append(QByteArray(data + offset, len) + code);
+            offset += len;
+        }
+
+        CrcSearchOptions options;
+        options.width = algorithm->width;
+        for(const CrcSearchResult &result : CrcReveng::search(frames, options))
+        {
+            if(!result.initAmbiguous && result.bigEndian == bigEndian
+                    && CheckAlgorithmRegistry::getCARInstance().find(result.params) == algorithm)
+                return paramsBytes(algorithm, bigEndian);
+        }
+        return QByteArray();
+    }
+
+    // 增量更新另外检查的CRC参数模型：CRC-5/USB、CRC-12/UMTS（RefIn与RefOut不同）、CRC-64/XZ
+    const CrcParams PatchModels[] = {
+        { 5, 0x05, 0x1F, true, true, 0x1F },
+        { 12, 0x80F, 0x000, false, true, 0x000 },
+        { 64, Q_UINT64_C(0x42F0E1EBA9EA3693), ~Q_UINT64_C(0), true, true, ~Q_UINT64_C(0) },
+    };
+
+    // 依次修改数据的开头1字节、中部7字节、结尾3字节以及整段数据，每次修改后记录校验码：
+    // patched为true时由patch增量更新，否则对修改后的数据完整计算（期望值）
+    template<typename Compute, typename Patch>
+    QByteArray patchCodes(const Compute &compute, const Patch &patch, const char *data, qint64 dataLen, bool patched)
+    {
+        const QPair<qint64, qint64> edits[] = {
+            { 0, 1 }, { dataLen / 2 - 3, 7 }, { dataLen - 3, 3 }, { 0, dataLen },
+        };
+        QByteArray edited(data, int(dataLen));
+        quint64 crc = compute(edited.constData(), edited.size());
+        QByteArray codes;
+        for(auto i = 0; i < 4; ++i)
+        {
+            const qint64 offset = edits[i].first;
+            QByteArray delta(int(edits[i].second), 0);
+            for(auto j = 0; j < delta.size(); ++j)
+            {
+                delta[j] = char(0x5A + 31 * i + j);
+                edited[int(offset) + j] = char(edited.at(int(offset) + j) ^ delta.at(j));
+            }
+            crc = patched ? patch(crc, dataLen, offset, delta.constData(), delta.size())
+                          : compute(edited.constData(), edited.size());
+            codes += toBigEndian(crc, 8);
+        }
+        return codes;
+    }
+
+    // 注册表中全部CRC算法及PatchModels的增量更新结果，数据至少8个字节
+    QByteArray patchResult(const char *data, qint64 dataLen, bool patched)
+    {
+        QByteArray codes;
+        for(const CheckAlgorithm &alg : CheckAlgorithmRegistry::getCARInstance().algorithms())
+        {
+            if(alg.patch != nullptr)
+                codes += patchCodes(alg.compute, alg.patch, data, dataLen, patched);
+        }
+        for(const CrcParams &params : PatchModels)
+        {
+            const CrcModel model(params);
+            codes += patchCodes([&model](const char *data, qint64 dataLen) { return model.compute(data, dataLen); },
+                                [&model](quint64 crc, qint64 dataLen, qint64 offset, const char *delta, qint64 deltaLen) {
+                                    return model.patch(crc, dataLen, offset, delta, deltaLen);
+                                }, data, dataLen, patched);
+        }
+        return codes;
+    }
+
+    QByteArray batchResult(const char *data, qint64 dataLen)
+    {
+        QByteArray codes;
+        for(const ChecksumBatchResult &r : ChecksumBatch::computeAll(data, dataLen))
+            codes += r.toBytes(true);
+        return codes;
+    }
+}
+
+ChecksumBenchmark::ChecksumBenchmark()
+{
+    const QByteArray longInput = patternData(LongVectorSize);
+    QByteArray batchCheck;
+    QByteArray batchLong;
+
+    for(const CheckAlgorithm &alg : CheckAlgorithmRegistry::getCARInstance().algorithms())
+    {
+        const CheckAlgorithm::ComputeFunc compute = alg.compute;
+        const int bytes = alg.bytes();
+        Case c;
+        c.name = alg.name;
+        c.kind = alg.kind == CheckAlgorithm::Crc ? "crc" : "checksum";
+        c.run = compute;
+        c.result = [compute, bytes](const char *data, qint64 dataLen) {
+            return toBigEndian(compute(data, dataLen), bytes);
+        };
+        c.vectors.append(Vector{ QString(CheckInput), CheckInput, toBigEndian(alg.check, bytes) });
+        caseList.append(c);
+
+        batchCheck += toBigEndian(alg.check, bytes);
+        batchLong += c.result(longInput.constData(), longInput.size());
+    }
+
+    for(const HashVectors &h : HashTable)
+    {
+        const HashContext::Algorithm algorithm = h.algorithm;
+        Case c;
+        c.name = h.name;
+        c.kind = "hash";
+        // XXH3直接取整数结果，小数据时不把QByteArray的分配计入耗时
+        if(algorithm == HashContext::Xxh3_64)
+        {
+            c.run = &Xxh3::hash64;
+        }
+        else if(algorithm == HashContext::Xxh3_128)
+        {
+            c.run = [](const char *data, qint64 dataLen) {
+                quint64 high;
+                return Xxh3::hash128(data, dataLen, &high) ^ high;
+            };
+        }
+        else
+        {
+            c.run = [algorithm](const char *data, qint64 dataLen) {
+                return firstWord(HashContext::compute(algorithm, data, dataLen));
+            };
+        }
+        c.result = [algorithm](const char *data, qint64 dataLen) {
+            return HashContext::compute(algorithm, data, dataLen);
+        };
+        c.vectors = {
+            Vector{ QString(CheckInput), CheckInput, QByteArray::fromHex(h.check) },
+            Vector{ "\"\"", QByteArray(), QByteArray::fromHex(h.empty) },
+            Vector{ "abc", QByteArray("abc"), QByteArray::fromHex(h.abc) },
+            Vector{ QString("pattern %1B").arg(LongVectorSize), longInput, QByteArray::fromHex(h.longData) },
+        };
+        caseList.append(c);
+    }
+
+    for(const HashContext::Algorithm algorithm : { HashContext::Md5, HashContext::Sha256 })
+    {
+        Case c;
+        c.name = algorithm == HashContext::Md5 ? "MD5_MultiBuffer" : "SHA256_MultiBuffer";
+        c.kind = "hash";
+        c.run = [algorithm](const char *data, qint64 dataLen) {
+            return firstWord(multiBufferResult(algorithm, data, dataLen));
+        };
+        c.result = [algorithm](const char *data, qint64 dataLen) {
+            return multiBufferResult(algorithm, data, dataLen);
+        };
+        c.vectors = {
+            Vector{ QString(CheckInput), CheckInput, frameDigests(algorithm, CheckInput) },
+            Vector{ QString("pattern %1B").arg(LongVectorSize), longInput, frameDigests(algorithm, longInput) },
+        };
+        caseList.append(c);
+    }
+
+    // 同一算法的computeFile在不同线程数下的吞吐量，与上面同名测试项（compute）对比
+    const CheckAlgorithm *fileAlgorithm = CheckAlgorithmRegistry::getCARInstance().find(FileAlgorithm);
+    if(fileAlgorithm != nullptr)
+    {
+        QVector<int> threadCounts = { 1 };
+        for(const int threads : { 2, QThread::idealThreadCount() })
+        {
+            if(threads > threadCounts.last())
+                threadCounts.append(threads);
+        }
+        const QByteArray fileInput = patternData(FileVectorSize);
+        const CheckAlgorithm::ComputeFileFunc computeFile = fileAlgorithm->computeFile;
+        const int bytes = fileAlgorithm->bytes();
+        const std::shared_ptr<FileInput> input = std::make_shared<FileInput>();
+        for(const int threads : qAsConst(threadCounts))
+        {
+            Case c;
+            c.name = QString("%1_File_%2T").arg(FileAlgorithm).arg(threads);
+            c.kind = "file";
+            c.run = [input, computeFile, threads](const char *data, qint64 dataLen) {
+                return computeFileResult(input.get(), computeFile, threads, data, dataLen, false);
+            };
+            c.result = [input, computeFile, threads, bytes](const char *data, qint64 dataLen) {
+                return toBigEndian(computeFileResult(input.get(), computeFile, threads, data, dataLen, true), bytes);
+            };
+            c.vectors = {
+                Vector{ QString(CheckInput), CheckInput, toBigEndian(fileAlgorithm->check, bytes) },
+                Vector{ QString("pattern %1B").arg(FileVectorSize), fileInput,
+                        toBigEndian(fileAlgorithm->compute(fileInput.constData(), fileInput.size()), bytes) },
+            };
+            caseList.append(c);
+        }
+    }
+
+    // 由生成的样本帧反推CRC参数，只检查测试向量，不计时
+    const QByteArray revengInput = patternData(128);
+    for(const RevengTarget &target : RevengTable)
+    {
+        const CheckAlgorithm *algorithm = CheckAlgorithmRegistry::getCARInstance().find(target.name);
+        if(algorithm == nullptr)
+            continue;
+        const bool bigEndian = target.bigEndian;
+        Case c;
+        c.name = QString("CrcReveng_%1").arg(target.name);
+        c.kind = "reveng";
+        c.result = [algorithm, bigEndian](const char *data, qint64 dataLen) {
+            return revengResult(algorithm, bigEndian, data, dataLen);
+        };
+        c.vectors.append(Vector{ QString("%1 frames, %2").arg(int(std::size(RevengFrameLengths)))
+                                 .arg(bigEndian ? "big endian" : "little endian"),
+                                 revengInput, paramsBytes(algorithm, bigEndian) });
+        caseList.append(c);
+    }
+
+    // CRC增量更新（CheckAlgorithm::patch、CrcModel::patch）与修改后完整计算的结果对比，不计时
+    Case patch;
+    patch.name = "CrcPatch_All";
+    patch.kind = "patch";
+    patch.result = [](const char *data, qint64 dataLen) {
+        return patchResult(data, dataLen, true);
+    };
+    const QByteArray patchInput = patternData(4099);
+    patch.vectors = {
+        Vector{ QString(CheckInput), CheckInput, patchResult(CheckInput.constData(), CheckInput.size(), false) },
+        Vector{ QString("pattern %1B").arg(patchInput.size()), patchInput,
+                patchResult(patchInput.constData(), patchInput.size(), false) },
+    };
+    caseList.append(patch);
+
+    Case batch;
+    batch.name = "ChecksumBatch_All";
+    batch.kind = "batch";
+    batch.run = [](const char *data, qint64 dataLen) {
+        quint64 sum = 0;
+        for(const ChecksumBatchResult &r : ChecksumBatch::computeAll(data, dataLen))
+            sum += r.value;
+        return sum;
+    };
+    batch.result = &batchResult;
+    // 期望值为注册表中各算法的check以及逐个算法计算的结果
+    batch.vectors = {
+        Vector{ QString(CheckInput), CheckInput, batchCheck },
+        Vector{ QString("pattern %1B").arg(LongVectorSize), longInput, batchLong },
+    };
+    caseList.append(batch);
+}
+
+void ChecksumBenchmark::setFilter(const QString &filter)
+{
+    if(filter.isEmpty())
+        return;
+    QVector<Case> kept;
+    for(const Case &c : qAsConst(caseList))
+    {
+        if(c.name.contains(filter, Qt::CaseInsensitive))
+            kept.append(c);
+    }
+    caseList = kept;
+}
+
+QVector<qint64> ChecksumBenchmark::defaultSizes()
+{
+    QVector<qint64> sizes;
+    for(qint64 size = 4; size <= MaxSize; size *= 4)
+        sizes.append(size);
+    return sizes;
+}
+
+QVector<ChecksumBenchmark::CheckResult> ChecksumBenchmark::runChecks() const
+{
+    QVector<CheckResult> checks;
+    for(const Case &c : caseList)
+    {
+        for(const Vector &v : c.vectors)
+            checks.append(CheckResult{ c.name, v.label, v.expected, c.result(v.input.constData(), v.input.size()) });
+    }
+    return checks;
+}
+
+QVector<ChecksumBenchmark::Measurement> ChecksumBenchmark::run(const QVector<qint64> &sizes, qint64 minTimeMs,
+                                                               const std::function<void(const Measurement&)> &progress) const
+{
+    qint64 maxSize = 0;
+    for(const qint64 size : sizes)
+        maxSize = qMax(maxSize, size);
+
+    // 固定种子的随机数据，每次运行的输入相同
+    QByteArray data(int(maxSize + 3) & ~3, 0);
+    QRandomGenerator generator(0x5EED);
+    generator.fillRange(reinterpret_cast<quint32*>(data.data()), data.size() / 4);
+
+    QVector<Measurement> results;
+    for(const Case &c : caseList)
+    {
+        if(!c.run)
+            continue;
+        for(const qint64 size : sizes)
+        {
+            const Measurement m = measure(c, data.constData(), size, minTimeMs * 1000000);
+            results.append(m);
+            if(progress)
+                progress(m);
+        }
+    }
+    return results;
+}
+
+ChecksumBenchmark::Measurement ChecksumBenchmark::measure(const Case &c, const char *data, qint64 size,
+                                                          qint64 minTimeNs) const
+{
+    const auto runBatch = [&c, data, size](qint64 iterations) {
+        quint64 acc = 0;
+        for(qint64 i = 0; i < iterations; ++i)
+            acc += c.run(data, size);
+        sink = sink + acc;
+    };
+
+    QElapsedTimer timer;
+    qint64 iterations = 1;
+    // 标定每批的重复次数，同时预热缓存和线程池
+    forever
+    {
+        timer.start();
+        runBatch(iterations);
+        if(timer.nsecsElapsed() >= BatchTimeNs)
+            break;
+        iterations *= 2;
+    }
+
+    qint64 bestNs = std::numeric_limits<qint64>::max();
+    quint64 bestCycles = 0;
+    qint64 totalNs = 0;
+    do
+    {
+        const quint64 startCycles = readCycles();
+        timer.start();
+        runBatch(iterations);
+        const qint64 ns = qMax<qint64>(timer.nsecsElapsed(), 1);
+        const quint64 cycles = readCycles() - startCycles;
+        totalNs += ns;
+        if(ns < bestNs)
+        {
+            bestNs = ns;
+            bestCycles = cycles;
+        }
+    } while (totalNs < minTimeNs);
+
+    const double bytes = double(size) * double(iterations);
+    Measurement m;
+    m.name = c.name;
+    m.kind = c.kind;
+    m.size = size;
+    m.iterations = iterations;
+    m.nsPerByte = double(bestNs) / bytes;
+    m.gbPerSec = bytes / double(bestNs);
+    m.cyclesPerByte = hasCycleCounter() ? double(bestCycles) / bytes : -1.0;
+    return m;
+}
+
+bool ChecksumBenchmark::hasCycleCounter()
+{
+#if defined(Q_PROCESSOR_X86)
+    return true;
+#else
+    return false;
+#endif
+}
+
+QJsonObject ChecksumBenchmark::toJson(const QVector<CheckResult> &checks, const QVector<Measurement> &results)
+{
+    QJsonObject environment;
+    environment["cpuArchitecture"] = QSysInfo::currentCpuArchitecture();
+    environment["os"] = QSysInfo::prettyProductName();
+    environment["qt"] = QString(qVersion());
+    environment["threads"] = QThreadPool::globalInstance()->maxThreadCount();
+    environment["sse41"] = CpuFeatures::hasSse41();
+    environment["avx2"] = CpuFeatures::hasAvx2();
+    environment["pclmul"] = CpuFeatures::hasPclmul();
+    environment["cycleCounter"] = hasCycleCounter() ? "tsc" : "none";
+
+    QJsonArray checkArray;
+    for(const CheckResult &check : checks)
+    {
+        QJsonObject item;
+        item["algorithm"] = check.name;
+        item["vector"] = check.label;
+        item["expected"] = QString(check.expected.toHex());
+        item["actual"] = QString(check.actual.toHex());
+        item["passed"] = check.passed();
+        checkArray.append(item);
+    }
+
+    QJsonArray resultArray;
+    for(const Measurement &m : results)
+    {
+        QJsonObject item;
+        item["algorithm"] = m.name;
+        item["kind"] = m.kind;
+        item["size"] = m.size;
+        item["iterations"] = m.iterations;
+        item["nsPerByte"] = m.nsPerByte;
+        item["gbPerSec"] = m.gbPerSec;
+        if(m.cyclesPerByte >= 0)
+            item["cyclesPerByte"] = m.cyclesPerByte;
+        resultArray.append(item);
+    }
+
+    QJsonObject json;
+    json["version"] = 1;
+    json["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    json["environment"] = environment;
+    json["checks"] = checkArray;
+    json["results"] = resultArray;
+    return json;
+}
+
+bool ChecksumBenchmark::fromJson(const QJsonObject &json, QVector<Measurement> *results, QString *errorString)
+{
+    if(json["version"].toInt() != 1 || !json["results"].isArray())
+    {
+        *errorString = QString("不是基准测试结果文件");
+        return false;
+    }
+
+    results->clear();
+    for(const QJsonValue &value : json["results"].toArray())
+    {
+        const QJsonObject item = value.toObject();
+        Measurement m;
+        m.name = item["algorithm"].toString();
+        m.kind = item["kind"].toString();
+        m.size = qint64(item["size"].toDouble());
+        m.iterations = qint64(item["iterations"].toDouble());
+        m.nsPerByte = item["nsPerByte"].toDouble();
+        m.gbPerSec = item["gbPerSec"].toDouble();
+        m.cyclesPerByte = item["cyclesPerByte"].toDouble(-1.0);
+        if(m.name.isEmpty() || m.size <= 0 || m.gbPerSec <= 0)
+        {
+            *errorString = QString("结果项格式错误");
+            return false;
+        }
+        results->append(m);
+    }
+    return true;
+}
@@ -0,0 +1,116 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QString>
+#include <QVector>
+#include <functional>
+
+/*********************************************************************************
+** 文件描述：       校验、摘要算法基准测试
+** 设计：          每个测试项对应一个算法：run计算一次并返回结果的一部分（只用于计时），
+**                result返回完整结果（大端字节序，与界面显示一致），用于检查测试向量。
+**                测试向量包括"123456789"（CRC的期望值直接取注册表中的check），摘要算法另有
+**                空串、"abc"以及超过1MiB的长数据（覆盖SIMD多路压缩和多线程树模式）；
+**                一次遍历计算全部算法的ChecksumBatch以逐个算法计算的结果作为期望值。
+**                文件测试项把数据写入临时文件后调用CheckAlgorithm::computeFile，全局线程池的最大
+**                线程数分别设为1、2及理想线程数（名称中的nT；调用线程也参与计算），与同一算法的
+**                compute对比多线程分块计算的收益；计时包含打开文件和映射的开销（数据只在换数据
+**                长度时写入一次，计时时已在系统缓存中）。
+**                CRC参数反推（CrcReveng）用CRC-16/MODBUS、CRC-32生成样本帧，检查能否还原出原参数，
+**                只检查测试向量，不计时。CRC增量更新（patch）在数据的开头、中部、结尾及整段依次修改后，
+**                与完整计算的结果对比，同样不计时。
+**                计时：每个数据长度先把一批的重复次数加倍到批耗时不少于BatchTimeNs，
+**                再重复整批直到累计时间达到minTime，取最快一批的平均值，排除线程切换、
+**                频率调整等偶发干扰。各长度的输入都取自同一块随机数据的开头，长度较小时数据
+**                在缓存中，测的是算法本身；16MiB时包含内存带宽的影响。
+**                周期数取x86的时间戳计数器（TSC），TSC按标称频率计数，睿频或降频时与核心的
+**                实际周期有偏差，只适合同一台机器前后对比；其它平台不输出周期数。
+**                注意BLAKE3在1MiB以上使用全局线程池，其吞吐量与线程数有关，JSON中记录了线程数。
+**********************************************************************************/
+
+class ChecksumBenchmark
+{
+public:
+    // 测试向量
+    struct Vector
+    {
+        QString label;
+        QByteArray input;
+        QByteArray expected;
+    };
+
+    struct Case
+    {
+        QString name;
+        QString kind;       // crc、checksum、hash、batch、file、reveng、patch
+        // 为空时只检查测试向量，不计时
+        std::function<quint64(const char*, qint64)> run;
+        std::function<QByteArray(const char*, qint64)> result;
+        QVector<Vector> vectors;
+    };
+
+    struct CheckResult
+    {
+        QString name;
+        QString label;
+        QByteArray expected;
+        QByteArray actual;
+
+        bool passed() const
+        {
+            return expected == actual;
+        }
+    };
+
+    struct Measurement
+    {
+        QString name;
+        QString kind;
+        qint64 size;
+        qint64 iterations;      // 最快一批的重复次数
+        double nsPerByte;
+        double gbPerSec;        // 10^9字节每秒
+        double cyclesPerByte;   // 不支持时为负数
+    };
+
+    // 一批的最短耗时
+    static constexpr qint64 BatchTimeNs = 2000000;
+    // 最大数据长度
+    static constexpr qint64 MaxSize = qint64(16) << 20;
+
+    ChecksumBenchmark();
+
+    // 注册表中的全部CRC、累加和算法，全部摘要算法，CRC-32的文件计算，CRC参数反推和增量更新，以及一次遍历的ChecksumBatch
+    const QVector<Case>& cases() const
+    {
+        return caseList;
+    }
+    // 只保留名称中含有filter（不区分大小写）的测试项，filter为空时保留全部
+    void setFilter(const QString &filter);
+
+    // 默认的数据长度：4B~16MiB，按4倍递增
+    static QVector<qint64> defaultSizes();
+
+    // 检查全部测试向量
+    QVector<CheckResult> runChecks() const;
+    // 对每个测试项、每个数据长度计时，progress在每项测完后调用
+    QVector<Measurement> run(const QVector<qint64> &sizes, qint64 minTimeMs,
+                             const std::function<void(const Measurement&)> &progress) const;
+
+    // 是否支持周期计数
+    static bool hasCycleCounter();
+
+    // 结果转为JSON：运行环境、测试向量检查结果以及各项计时
+    static QJsonObject toJson(const QVector<CheckResult> &checks, const QVector<Measurement> &results);
+    // 读取toJson()保存的结果，失败返回false并给出错误信息
+    static bool fromJson(const QJsonObject &json, QVector<Measurement> *results, QString *errorString);
+
+private:
+    Measurement measure(const Case &c, const char *data, qint64 size, qint64 minTimeNs) const;
+
+    QVector<Case> caseList;
+};
+
+#endif // BENCHMARK_H
@@ -0,0 +1,228 @@
+#include "benchmark.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QFile>
+#include <QHash>
+#include <QJsonDocument>
+#include <QTextStream>
+#include <cstdio>
+
+/*********************************************************************************
+** 文件描述：       校验、摘要算法基准测试命令行程序
+** 设计：          先检查全部测试向量，再逐项计时并输出ns/B、GB/s、cycles/B表格。
+**                --json保存机器可读的结果（"-"表示输出到标准输出，此时表格输出到标准错误）；
+**                --baseline读取以前保存的结果，按算法和数据长度比较吞吐量，低于基线超过
+**                --tolerance百分比的记为性能下降。
+**                退出码：0正常；1测试向量检查失败；2存在性能下降；3参数或文件错误。
+**                典型用法：修改前保存基线 Benchmark --json baseline.json，
+**                修改后比较 Benchmark --baseline baseline.json。
+**********************************************************************************/
+
+namespace
+{
+    enum ExitCode
+    {
+        ExitOk = 0,
+        ExitCheckFailed = 1,
+        ExitRegression = 2,
+        ExitUsage = 3,
+    };
+
+    QString measurementKey(const QString &name, qint64 size)
+    {
+        return QString("%1/%2").arg(name).arg(size);
+    }
+
+    QString sizeText(qint64 size)
+    {
+        if(size >= (1 << 20) && size % (1 << 20) == 0)
+            return QString("%1MiB").arg(size >> 20);
+        if(size >= (1 << 10) && size % (1 << 10) == 0)
+            return QString("%1KiB").arg(size >> 10);
+        return QString("%1B").arg(size);
+    }
+
+    // 解析逗号分隔的数据长度，支持K、M后缀（1024进制）
+    bool parseSizes(const QString &text, QVector<qint64> *sizes)
+    {
+        sizes->clear();
+        for(QString item : text.split(','))
+        {
+            item = item.trimmed().toUpper();
+            if(item.isEmpty())
+                continue;
+            qint64 unit = 1;
+            if(item.endsWith('K'))
+                unit = qint64(1) << 10;
+            else if(item.endsWith('M'))
+                unit = qint64(1) << 20;
+            if(unit != 1)
+                item.chop(1);
+            bool ok = false;
+            const qint64 size = item.toLongLong(&ok) * unit;
+            if(!ok || size <= 0 || size > ChecksumBenchmark::MaxSize)
+                return false;
+            sizes->append(size);
+        }
+        return !sizes->isEmpty();
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("Benchmark");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("校验、摘要算法基准测试：检查测试向量，测量各数据长度的吞吐量");
+    parser.addHelpOption();
+    const QCommandLineOption jsonOption(QStringList() << "j" << "json",
+                                        "结果保存为JSON文件，\"-\"表示输出到标准输出", "file");
+    const QCommandLineOption baselineOption(QStringList() << "b" << "baseline",
+                                            "与以前保存的JSON结果比较", "file");
+    const QCommandLineOption toleranceOption(QStringList() << "t" << "tolerance",
+                                             "吞吐量低于基线超过该百分比时记为性能下降，默认10", "percent", "10");
+    const QCommandLineOption minTimeOption(QStringList() << "m" << "min-time",
+                                           "每个算法、每个数据长度的最短计时，默认100毫秒", "ms", "100");
+    const QCommandLineOption filterOption(QStringList() << "f" << "filter",
+                                          "只测试名称中含有该文本的算法（不区分大小写）", "text");
+    const QCommandLineOption sizesOption(QStringList() << "s" << "sizes",
+                                         "逗号分隔的数据长度，可带K、M后缀，默认4B~16MiB按4倍递增", "list");
+    const QCommandLineOption checkOnlyOption(QStringList() << "c" << "check-only",
+                                             "只检查测试向量，不计时");
+    parser.addOptions({ jsonOption, baselineOption, toleranceOption, minTimeOption,
+                        filterOption, sizesOption, checkOnlyOption });
+    parser.process(app);
+
+    const QString jsonPath = parser.value(jsonOption);
+    const bool jsonToStdout = (jsonPath == "-");
+    QTextStream out(jsonToStdout ? stderr : stdout);
+    QTextStream err(stderr);
+
+    bool ok = false;
+    const double tolerance = parser.value(toleranceOption).toDouble(&ok);
+    if(!ok || tolerance < 0 || tolerance >= 100)
+    {
+        err << "tolerance参数错误\n";
+        return ExitUsage;
+    }
+    const qint64 minTimeMs = parser.value(minTimeOption).toLongLong(&ok);
+    if(!ok || minTimeMs <= 0)
+    {
+        err << "min-time参数错误\n";
+        return ExitUsage;
+    }
+    QVector<qint64> sizes = ChecksumBenchmark::defaultSizes();
+    if(parser.isSet(sizesOption) && !parseSizes(parser.value(sizesOption), &sizes))
+    {
+        err << "sizes参数错误\n";
+        return ExitUsage;
+    }
+
+    // 先读取基线，文件有误时不必等计时结束才报错
+    QHash<QString, ChecksumBenchmark::Measurement> baseline;
+    if(parser.isSet(baselineOption))
+    {
+        QFile file(parser.value(baselineOption));
+        if(!file.open(QIODevice::ReadOnly))
+        {
+            err << "无法打开基线文件：" << file.errorString() << "\n";
+            return ExitUsage;
+        }
+        QJsonParseError parseError;
+        const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+        if(parseError.error != QJsonParseError::NoError)
+        {
+            err << "基线文件格式错误：" << parseError.errorString() << "\n";
+            return ExitUsage;
+        }
+        QVector<ChecksumBenchmark::Measurement> results;
+        QString errorString;
+        if(!ChecksumBenchmark::fromJson(document.object(), &results, &errorString))
+        {
+            err << "基线文件格式错误：" << errorString << "\n";
+            return ExitUsage;
+        }
+        for(const ChecksumBenchmark::Measurement &m : qAsConst(results))
+            baseline.insert(measurementKey(m.name, m.size), m);
+    }
+
+    ChecksumBenchmark benchmark;
+    benchmark.setFilter(parser.value(filterOption));
+    if(benchmark.cases().isEmpty())
+    {
+        err << "没有名称匹配的算法\n";
+        return ExitUsage;
+    }
+
+    // 测试向量
+    const QVector<ChecksumBenchmark::CheckResult> checks = benchmark.runChecks();
+    int failedChecks = 0;
+    for(const ChecksumBenchmark::CheckResult &check : checks)
+    {
+        if(check.passed())
+            continue;
+        ++failedChecks;
+        out << "FAIL " << check.name << " [" << check.label << "] expected " << check.expected.toHex()
+            << " actual " << check.actual.toHex() << "\n";
+    }
+    out << QString("测试向量：%1项，失败%2项\n").arg(checks.size()).arg(failedChecks);
+    out.flush();
+
+    QVector<ChecksumBenchmark::Measurement> results;
+    int regressions = 0;
+    if(!parser.isSet(checkOnlyOption))
+    {
+        out << QString("%1 %2 %3 %4 %5 %6\n")
+               .arg("algorithm", -20).arg("size", 8).arg("ns/B", 10).arg("GB/s", 9)
+               .arg("cycles/B", 9).arg(baseline.isEmpty() ? QString() : QString("vs base").rightJustified(9));
+        const auto progress = [&](const ChecksumBenchmark::Measurement &m) {
+            QString line = QString("%1 %2 %3 %4 %5")
+                    .arg(m.name, -20).arg(sizeText(m.size), 8)
+                    .arg(m.nsPerByte, 10, 'f', 4).arg(m.gbPerSec, 9, 'f', 3)
+                    .arg(m.cyclesPerByte >= 0 ? QString::number(m.cyclesPerByte, 'f', 3) : QString("-"), 9);
+            const auto base = baseline.constFind(measurementKey(m.name, m.size));
+            if(base != baseline.constEnd())
+            {
+                const double ratio = m.gbPerSec / base->gbPerSec;
+                line += QString(" %1%").arg((ratio - 1.0) * 100.0, 8, 'f', 1);
+                if(ratio < 1.0 - tolerance / 100.0)
+                {
+                    line += " REGRESSION";
+                    ++regressions;
+                }
+            }
+            out << line << "\n";
+            out.flush();
+        };
+        results = benchmark.run(sizes, minTimeMs, progress);
+        if(!baseline.isEmpty())
+            out << QString("与基线相比：%1项性能下降超过%2%\n").arg(regressions).arg(tolerance);
+    }
+
+    if(!jsonPath.isEmpty())
+    {
+        const QByteArray json = QJsonDocument(ChecksumBenchmark::toJson(checks, results)).toJson();
+        if(jsonToStdout)
+        {
+            QFile file;
+            file.open(stdout, QIODevice::WriteOnly);
+            file.write(json);
+        }
+        else
+        {
+            QFile file(jsonPath);
+            if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(json) != json.size())
+            {
+                err << "无法写入结果文件：" << file.errorString() << "\n";
+                return ExitUsage;
+            }
+        }
+    }
+
+    if(failedChecks > 0)
+        return ExitCheckFailed;
+    if(regressions > 0)
+        return ExitRegression;
+    return ExitOk;
+}
@@ -1,5 +1,11 @@
 TEMPLATE = subdirs
 
 SUBDIRS += \
+    Benchmark \
+    Checksum \
     Framework \
     Plugins
+
+# 插件和基准测试程序链接Checksum静态库，需先编译Checksum
+Plugins.depends = Checksum
+Benchmark.depends = Checksum
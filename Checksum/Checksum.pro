@@ -0,0 +1,60 @@
+# 校验、摘要算法静态库：只依赖QtCore、QtConcurrent，不包含任何界面代码，
+# 供UDPTest、UartTest等插件以及命令行工具链接使用
+QT = core concurrent
+
+TEMPLATE = lib
+CONFIG += staticlib c++17
+
+# You can make your code fail to compile if it uses deprecated APIs.
+# In order to do so, uncomment the following line.
+#DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
+
+SOURCES += \
+    blake3.cpp \
+    checkalgorithm.cpp \
+    checksumbatch.cpp \
+    checksumdetect.cpp \
+    checksumsimd.cpp \
+    columncodec.cpp \
+    cpufeatures.cpp \
+    crcclmul.cpp \
+    crcmodel.cpp \
+    crcparamloader.cpp \
+    crcreveng.cpp \
+    filehashjob.cpp \
+    hashcontext.cpp \
+    hexcodec.cpp \
+    hexstreamdecoder.cpp \
+    multibufferhash.cpp \
+    parallelchecksum.cpp \
+    xlsxreader.cpp \
+    xxh3.cpp
+
+HEADERS += \
+    blake3.h \
+    checkalgorithm.h \
+    checksumbatch.h \
+    checksumcontext.h \
+    checksumdetect.h \
+    checksumengine.h \
+    checksumsimd.h \
+    columncodec.h \
+    cpufeatures.h \
+    crcclmul.h \
+    crccombine.h \
+    crcengine.h \
+    crcmodel.h \
+    crcparamloader.h \
+    crcreveng.h \
+    fieldcodec.h \
+    filehashjob.h \
+    hashcontext.h \
+    hexcodec.h \
+    hexstreamdecoder.h \
+    multibufferhash.h \
+    parallelchecksum.h \
+    xlsxreader.h \
+    xxh3.h
+
+DISTFILES += \
+    checksum.pri
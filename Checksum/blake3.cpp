@@ -0,0 +1,597 @@
+#include "blake3.h"
+#include "cpufeatures.h"
+#include "parallelchecksum.h"
+#include <QVector>
+#include <QtEndian>
+#include <cstring>
+
+#ifdef CPU_HAVE_X86_SIMD
+#  include <immintrin.h>
+#endif
+
+namespace
+{
+    const quint32 IV[8] = {
+        0x6A09E667U, 0xBB67AE85U, 0x3C6EF372U, 0xA54FF53AU, 0x510E527FU, 0x9B05688CU, 0x1F83D9ABU, 0x5BE0CD19U,
+    };
+
+    // 每轮使用的消息字顺序（第r+1行由第r行按消息置换得到）
+    const quint8 MsgSchedule[7][16] = {
+        { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+        { 2, 6, 3, 10, 7, 0, 4, 13, 1, 11, 12, 5, 9, 14, 15, 8 },
+        { 3, 4, 10, 12, 13, 2, 7, 14, 6, 5, 9, 0, 11, 15, 8, 1 },
+        { 10, 7, 12, 9, 14, 3, 13, 15, 4, 0, 11, 2, 5, 8, 1, 6 },
+        { 12, 13, 9, 11, 15, 10, 14, 8, 7, 2, 5, 3, 0, 1, 6, 4 },
+        { 9, 14, 11, 5, 8, 12, 15, 1, 13, 3, 0, 10, 2, 6, 4, 7 },
+        { 11, 15, 5, 0, 1, 9, 8, 6, 14, 10, 2, 12, 3, 4, 7, 13 },
+    };
+
+    enum Flags : quint8
+    {
+        ChunkStart = 1 << 0,
+        ChunkEnd = 1 << 1,
+        Parent = 1 << 2,
+        Root = 1 << 3,
+    };
+
+    inline quint32 rotr32(quint32 x, int r)
+    {
+        return (x >> r) | (x << (32 - r));
+    }
+
+    inline void g(quint32 *v, int a, int b, int c, int d, quint32 x, quint32 y)
+    {
+        v[a] = v[a] + v[b] + x;
+        v[d] = rotr32(v[d] ^ v[a], 16);
+        v[c] = v[c] + v[d];
+        v[b] = rotr32(v[b] ^ v[c], 12);
+        v[a] = v[a] + v[b] + y;
+        v[d] = rotr32(v[d] ^ v[a], 8);
+        v[c] = v[c] + v[d];
+        v[b] = rotr32(v[b] ^ v[c], 7);
+    }
+
+    // 压缩一个分组，结果（输出的前8个字）写入out，out可以与cv相同
+    void compress(const quint32 *cv, const uchar *block, int blockLen, quint64 counter, quint8 flags, quint32 *out)
+    {
+        quint32 m[16];
+        for(auto i = 0; i < 16; ++i)
+            m[i] = qFromLittleEndian<quint32>(block + 4 * i);
+        quint32 v[16] = {
+            cv[0], cv[1], cv[2], cv[3], cv[4], cv[5], cv[6], cv[7],
+            IV[0], IV[1], IV[2], IV[3], quint32(counter), quint32(counter >> 32), quint32(blockLen), flags,
+        };
+        for(const auto &s : MsgSchedule)
+        {
+            g(v, 0, 4, 8, 12, m[s[0]], m[s[1]]);
+            g(v, 1, 5, 9, 13, m[s[2]], m[s[3]]);
+            g(v, 2, 6, 10, 14, m[s[4]], m[s[5]]);
+            g(v, 3, 7, 11, 15, m[s[6]], m[s[7]]);
+            g(v, 0, 5, 10, 15, m[s[8]], m[s[9]]);
+            g(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+            g(v, 2, 7, 8, 13, m[s[12]], m[s[13]]);
+            g(v, 3, 4, 9, 14, m[s[14]], m[s[15]]);
+        }
+        for(auto i = 0; i < 8; ++i)
+            out[i] = v[i] ^ v[i + 8];
+    }
+
+    void storeCv(const quint32 *cv, uchar *out)
+    {
+        for(auto i = 0; i < 8; ++i)
+            qToLittleEndian(cv[i], out + 4 * i);
+    }
+
+    void loadCv(const uchar *in, quint32 *cv)
+    {
+        for(auto i = 0; i < 8; ++i)
+            cv[i] = qFromLittleEndian<quint32>(in + 4 * i);
+    }
+
+    // 两个子节点链值拼成的父节点分组
+    void parentCv(const quint32 *left, const quint32 *right, quint32 *out)
+    {
+        uchar block[Blake3::BlockLen];
+        storeCv(left, block);
+        storeCv(right, block + Blake3::OutLen);
+        compress(IV, block, Blake3::BlockLen, 0, Parent, out);
+    }
+
+    // 依次压缩一个输入的blocks个分组，首、末分组分别附加flagsStart、flagsEnd，链值写入out（32字节）
+    void hashOne(const uchar *input, int blocks, quint64 counter, quint8 flags, quint8 flagsStart, quint8 flagsEnd,
+                 uchar *out)
+    {
+        quint32 cv[8];
+        memcpy(cv, IV, sizeof(cv));
+        quint8 blockFlags = flags | flagsStart;
+        for(auto b = 0; b < blocks; ++b, input += Blake3::BlockLen)
+        {
+            if(b + 1 == blocks)
+                blockFlags |= flagsEnd;
+            compress(cv, input, Blake3::BlockLen, counter, blockFlags, cv);
+            blockFlags = flags;
+        }
+        storeCv(cv, out);
+    }
+
+#ifdef CPU_HAVE_X86_SIMD
+    /************************************ SSE4.1：4路 ************************************/
+
+    CPU_TARGET("sse4.1")
+    inline __m128i rot16Sse41(__m128i x)
+    {
+        return _mm_shuffle_epi8(x, _mm_set_epi8(13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2));
+    }
+
+    CPU_TARGET("sse4.1")
+    inline __m128i rot8Sse41(__m128i x)
+    {
+        return _mm_shuffle_epi8(x, _mm_set_epi8(12, 15, 14, 13, 8, 11, 10, 9, 4, 7, 6, 5, 0, 3, 2, 1));
+    }
+
+    CPU_TARGET("sse4.1")
+    Q_ALWAYS_INLINE void gSse41(__m128i &a, __m128i &b, __m128i &c, __m128i &d, __m128i x, __m128i y)
+    {
+        a = _mm_add_epi32(_mm_add_epi32(a, b), x);
+        d = rot16Sse41(_mm_xor_si128(d, a));
+        c = _mm_add_epi32(c, d);
+        b = _mm_xor_si128(b, c);
+        b = _mm_or_si128(_mm_srli_epi32(b, 12), _mm_slli_epi32(b, 20));
+        a = _mm_add_epi32(_mm_add_epi32(a, b), y);
+        d = rot8Sse41(_mm_xor_si128(d, a));
+        c = _mm_add_epi32(c, d);
+        b = _mm_xor_si128(b, c);
+        b = _mm_or_si128(_mm_srli_epi32(b, 7), _mm_slli_epi32(b, 25));
+    }
+
+    // 一轮：先对4列、再对4条对角线执行G函数；强制内联后消息下标都是常量
+    CPU_TARGET("sse4.1")
+    Q_ALWAYS_INLINE void roundSse41(__m128i *v, const __m128i *m, const quint8 *s)
+    {
+        gSse41(v[0], v[4], v[8], v[12], m[s[0]], m[s[1]]);
+        gSse41(v[1], v[5], v[9], v[13], m[s[2]], m[s[3]]);
+        gSse41(v[2], v[6], v[10], v[14], m[s[4]], m[s[5]]);
+        gSse41(v[3], v[7], v[11], v[15], m[s[6]], m[s[7]]);
+        gSse41(v[0], v[5], v[10], v[15], m[s[8]], m[s[9]]);
+        gSse41(v[1], v[6], v[11], v[12], m[s[10]], m[s[11]]);
+        gSse41(v[2], v[7], v[8], v[13], m[s[12]], m[s[13]]);
+        gSse41(v[3], v[4], v[9], v[14], m[s[14]], m[s[15]]);
+    }
+
+    // 4×4的32位矩阵转置
+    CPU_TARGET("sse4.1")
+    inline void transpose4Sse41(__m128i &r0, __m128i &r1, __m128i &r2, __m128i &r3)
+    {
+        const __m128i ab01 = _mm_unpacklo_epi32(r0, r1);
+        const __m128i ab23 = _mm_unpackhi_epi32(r0, r1);
+        const __m128i cd01 = _mm_unpacklo_epi32(r2, r3);
+        const __m128i cd23 = _mm_unpackhi_epi32(r2, r3);
+        r0 = _mm_unpacklo_epi64(ab01, cd01);
+        r1 = _mm_unpackhi_epi64(ab01, cd01);
+        r2 = _mm_unpacklo_epi64(ab23, cd23);
+        r3 = _mm_unpackhi_epi64(ab23, cd23);
+    }
+
+    // 4个输入同时压缩，向量的第k个32位通道对应inputs[k]
+    CPU_TARGET("sse4.1")
+    void hash4Sse41(const uchar *const *inputs, int blocks, quint64 counter, bool increment,
+                    quint8 flags, quint8 flagsStart, quint8 flagsEnd, uchar *out)
+    {
+        quint32 lo[4];
+        quint32 hi[4];
+        for(auto k = 0; k < 4; ++k)
+        {
+            const quint64 c = counter + (increment ? quint64(k) : 0);
+            lo[k] = quint32(c);
+            hi[k] = quint32(c >> 32);
+        }
+        const __m128i counterLo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lo));
+        const __m128i counterHi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hi));
+        __m128i h[8];
+        for(auto i = 0; i < 8; ++i)
+            h[i] = _mm_set1_epi32(int(IV[i]));
+
+        quint8 blockFlags = flags | flagsStart;
+        for(auto b = 0; b < blocks; ++b)
+        {
+            if(b + 1 == blocks)
+                blockFlags |= flagsEnd;
+            const qint64 offset = qint64(b) * Blake3::BlockLen;
+            __m128i m[16];
+            for(auto i = 0; i < 16; i += 4)
+            {
+                for(auto k = 0; k < 4; ++k)
+                    m[i + k] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(inputs[k] + offset + 4 * i));
+                transpose4Sse41(m[i], m[i + 1], m[i + 2], m[i + 3]);
+            }
+            __m128i v[16] = {
+                h[0], h[1], h[2], h[3], h[4], h[5], h[6], h[7],
+                _mm_set1_epi32(int(IV[0])), _mm_set1_epi32(int(IV[1])), _mm_set1_epi32(int(IV[2])), _mm_set1_epi32(int(IV[3])),
+                counterLo, counterHi, _mm_set1_epi32(Blake3::BlockLen), _mm_set1_epi32(blockFlags),
+            };
+            roundSse41(v, m, MsgSchedule[0]);
+            roundSse41(v, m, MsgSchedule[1]);
+            roundSse41(v, m, MsgSchedule[2]);
+            roundSse41(v, m, MsgSchedule[3]);
+            roundSse41(v, m, MsgSchedule[4]);
+            roundSse41(v, m, MsgSchedule[5]);
+            roundSse41(v, m, MsgSchedule[6]);
+            for(auto i = 0; i < 8; ++i)
+                h[i] = _mm_xor_si128(v[i], v[i + 8]);
+            blockFlags = flags;
+        }
+
+        // 转置回每个输入各自的链值
+        transpose4Sse41(h[0], h[1], h[2], h[3]);
+        transpose4Sse41(h[4], h[5], h[6], h[7]);
+        for(auto k = 0; k < 4; ++k)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + Blake3::OutLen * k), h[k]);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + Blake3::OutLen * k + 16), h[4 + k]);
+        }
+    }
+
+    /************************************ AVX2：8路 ************************************/
+
+    CPU_TARGET("avx2")
+    inline __m256i rot16Avx2(__m256i x)
+    {
+        return _mm256_shuffle_epi8(x, _mm256_broadcastsi128_si256(
+                                       _mm_set_epi8(13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2)));
+    }
+
+    CPU_TARGET("avx2")
+    inline __m256i rot8Avx2(__m256i x)
+    {
+        return _mm256_shuffle_epi8(x, _mm256_broadcastsi128_si256(
+                                       _mm_set_epi8(12, 15, 14, 13, 8, 11, 10, 9, 4, 7, 6, 5, 0, 3, 2, 1)));
+    }
+
+    CPU_TARGET("avx2")
+    Q_ALWAYS_INLINE void gAvx2(__m256i &a, __m256i &b, __m256i &c, __m256i &d, __m256i x, __m256i y)
+    {
+        a = _mm256_add_epi32(_mm256_add_epi32(a, b), x);
+        d = rot16Avx2(_mm256_xor_si256(d, a));
+        c = _mm256_add_epi32(c, d);
+        b = _mm256_xor_si256(b, c);
+        b = _mm256_or_si256(_mm256_srli_epi32(b, 12), _mm256_slli_epi32(b, 20));
+        a = _mm256_add_epi32(_mm256_add_epi32(a, b), y);
+        d = rot8Avx2(_mm256_xor_si256(d, a));
+        c = _mm256_add_epi32(c, d);
+        b = _mm256_xor_si256(b, c);
+        b = _mm256_or_si256(_mm256_srli_epi32(b, 7), _mm256_slli_epi32(b, 25));
+    }
+
+    // 8路版本的一轮，同roundSse41
+    CPU_TARGET("avx2")
+    Q_ALWAYS_INLINE void roundAvx2(__m256i *v, const __m256i *m, const quint8 *s)
+    {
+        gAvx2(v[0], v[4], v[8], v[12], m[s[0]], m[s[1]]);
+        gAvx2(v[1], v[5], v[9], v[13], m[s[2]], m[s[3]]);
+        gAvx2(v[2], v[6], v[10], v[14], m[s[4]], m[s[5]]);
+        gAvx2(v[3], v[7], v[11], v[15], m[s[6]], m[s[7]]);
+        gAvx2(v[0], v[5], v[10], v[15], m[s[8]], m[s[9]]);
+        gAvx2(v[1], v[6], v[11], v[12], m[s[10]], m[s[11]]);
+        gAvx2(v[2], v[7], v[8], v[13], m[s[12]], m[s[13]]);
+        gAvx2(v[3], v[4], v[9], v[14], m[s[14]], m[s[15]]);
+    }
+
+    // 8×8的32位矩阵转置
+    CPU_TARGET("avx2")
+    inline void transpose8Avx2(__m256i *r)
+    {
+        const __m256i ab0145 = _mm256_unpacklo_epi32(r[0], r[1]);
+        const __m256i ab2367 = _mm256_unpackhi_epi32(r[0], r[1]);
+        const __m256i cd0145 = _mm256_unpacklo_epi32(r[2], r[3]);
+        const __m256i cd2367 = _mm256_unpackhi_epi32(r[2], r[3]);
+        const __m256i ef0145 = _mm256_unpacklo_epi32(r[4], r[5]);
+        const __m256i ef2367 = _mm256_unpackhi_epi32(r[4], r[5]);
+        const __m256i gh0145 = _mm256_unpacklo_epi32(r[6], r[7]);
+        const __m256i gh2367 = _mm256_unpackhi_epi32(r[6], r[7]);
+        const __m256i abcd04 = _mm256_unpacklo_epi64(ab0145, cd0145);
+        const __m256i abcd15 = _mm256_unpackhi_epi64(ab0145, cd0145);
+        const __m256i abcd26 = _mm256_unpacklo_epi64(ab2367, cd2367);
+        const __m256i abcd37 = _mm256_unpackhi_epi64(ab2367, cd2367);
+        const __m256i efgh04 = _mm256_unpacklo_epi64(ef0145, gh0145);
+        const __m256i efgh15 = _mm256_unpackhi_epi64(ef0145, gh0145);
+        const __m256i efgh26 = _mm256_unpacklo_epi64(ef2367, gh2367);
+        const __m256i efgh37 = _mm256_unpackhi_epi64(ef2367, gh2367);
+        r[0] = _mm256_permute2x128_si256(abcd04, efgh04, 0x20);
+        r[1] = _mm256_permute2x128_si256(abcd15, efgh15, 0x20);
+        r[2] = _mm256_permute2x128_si256(abcd26, efgh26, 0x20);
+        r[3] = _mm256_permute2x128_si256(abcd37, efgh37, 0x20);
+        r[4] = _mm256_permute2x128_si256(abcd04, efgh04, 0x31);
+        r[5] = _mm256_permute2x128_si256(abcd15, efgh15, 0x31);
+        r[6] = _mm256_permute2x128_si256(abcd26, efgh26, 0x31);
+        r[7] = _mm256_permute2x128_si256(abcd37, efgh37, 0x31);
+    }
+
+    // 8个输入同时压缩，向量的第k个32位通道对应inputs[k]
+    CPU_TARGET("avx2")
+    void hash8Avx2(const uchar *const *inputs, int blocks, quint64 counter, bool increment,
+                   quint8 flags, quint8 flagsStart, quint8 flagsEnd, uchar *out)
+    {
+        quint32 lo[8];
+        quint32 hi[8];
+        for(auto k = 0; k < 8; ++k)
+        {
+            const quint64 c = counter + (increment ? quint64(k) : 0);
+            lo[k] = quint32(c);
+            hi[k] = quint32(c >> 32);
+        }
+        const __m256i counterLo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lo));
+        const __m256i counterHi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(hi));
+        __m256i h[8];
+        for(auto i = 0; i < 8; ++i)
+            h[i] = _mm256_set1_epi32(int(IV[i]));
+
+        quint8 blockFlags = flags | flagsStart;
+        for(auto b = 0; b < blocks; ++b)
+        {
+            if(b + 1 == blocks)
+                blockFlags |= flagsEnd;
+            const qint64 offset = qint64(b) * Blake3::BlockLen;
+            __m256i m[16];
+            for(auto k = 0; k < 8; ++k)
+            {
+                m[k] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(inputs[k] + offset));
+                m[8 + k] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(inputs[k] + offset + 32));
+            }
+            transpose8Avx2(m);
+            transpose8Avx2(m + 8);
+            __m256i v[16] = {
+                h[0], h[1], h[2], h[3], h[4], h[5], h[6], h[7],
+                _mm256_set1_epi32(int(IV[0])), _mm256_set1_epi32(int(IV[1])),
+                _mm256_set1_epi32(int(IV[2])), _mm256_set1_epi32(int(IV[3])),
+                counterLo, counterHi, _mm256_set1_epi32(Blake3::BlockLen), _mm256_set1_epi32(blockFlags),
+            };
+            roundAvx2(v, m, MsgSchedule[0]);
+            roundAvx2(v, m, MsgSchedule[1]);
+            roundAvx2(v, m, MsgSchedule[2]);
+            roundAvx2(v, m, MsgSchedule[3]);
+            roundAvx2(v, m, MsgSchedule[4]);
+            roundAvx2(v, m, MsgSchedule[5]);
+            roundAvx2(v, m, MsgSchedule[6]);
+            for(auto i = 0; i < 8; ++i)
+                h[i] = _mm256_xor_si256(v[i], v[i + 8]);
+            blockFlags = flags;
+        }
+
+        transpose8Avx2(h);
+        for(auto k = 0; k < 8; ++k)
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + Blake3::OutLen * k), h[k]);
+        _mm256_zeroupper();
+    }
+#endif // CPU_HAVE_X86_SIMD
+
+    // 压缩count个互相独立的输入（各blocks个分组），链值依次写入out；
+    // increment为true时第k个输入的计数器为counter + k，否则都为counter。
+    // 每组输入在写出结果前已全部读入，out可以与前面各组已处理过的输入重叠
+    void hashMany(const uchar *const *inputs, int count, int blocks, quint64 counter, bool increment,
+                  quint8 flags, quint8 flagsStart, quint8 flagsEnd, uchar *out)
+    {
+#ifdef CPU_HAVE_X86_SIMD
+        if(count >= 8 && CpuFeatures::hasAvx2())
+        {
+            for(; count >= 8; count -= 8, inputs += 8, out += 8 * Blake3::OutLen)
+            {
+                hash8Avx2(inputs, blocks, counter, increment, flags, flagsStart, flagsEnd, out);
+                if(increment)
+                    counter += 8;
+            }
+        }
+        if(count >= 4 && CpuFeatures::hasSse41())
+        {
+            for(; count >= 4; count -= 4, inputs += 4, out += 4 * Blake3::OutLen)
+            {
+                hash4Sse41(inputs, blocks, counter, increment, flags, flagsStart, flagsEnd, out);
+                if(increment)
+                    counter += 4;
+            }
+        }
+#endif
+        for(; count > 0; --count, ++inputs, out += Blake3::OutLen)
+        {
+            hashOne(*inputs, blocks, counter, flags, flagsStart, flagsEnd, out);
+            if(increment)
+                ++counter;
+        }
+    }
+
+    // chunks（2的幂，不超过PieceChunks）个完整块组成的子树的链值
+    void subtreeCv(const uchar *data, qint64 chunks, quint64 counter, quint32 *cv)
+    {
+        alignas(32) uchar cvs[Blake3::PieceChunks * Blake3::OutLen];
+        const uchar *inputs[Blake3::PieceChunks];
+        int n = int(chunks);
+        for(auto i = 0; i < n; ++i)
+            inputs[i] = data + qint64(i) * Blake3::ChunkLen;
+        hashMany(inputs, n, Blake3::ChunkLen / Blake3::BlockLen, counter, true, 0, ChunkStart, ChunkEnd, cvs);
+        // 逐层压缩父节点，每层的结果覆盖在链值数组的前半部分
+        for(; n > 1; n /= 2)
+        {
+            for(auto i = 0; i < n / 2; ++i)
+                inputs[i] = cvs + i * Blake3::BlockLen;
+            hashMany(inputs, n / 2, 1, 0, false, Parent, 0, 0, cvs);
+        }
+        loadCv(cvs, cv);
+    }
+
+    // 不超过n且能整除counter（counter为0时不限）的最大的2的幂
+    qint64 alignedSubtree(quint64 counter, qint64 n)
+    {
+        qint64 size = 1;
+        while (size * 2 <= n)
+            size *= 2;
+        while (counter % quint64(size) != 0)
+            size /= 2;
+        return size;
+    }
+
+    int log2Of(qint64 x)
+    {
+        int level = 0;
+        while (x > 1)
+        {
+            x >>= 1;
+            ++level;
+        }
+        return level;
+    }
+}
+
+Blake3::Blake3()
+{
+    init();
+}
+
+void Blake3::init()
+{
+    cvStackLen = 0;
+    memcpy(chunkCv, IV, sizeof(chunkCv));
+    chunkCounter = 0;
+    blockLen = 0;
+    blocksCompressed = 0;
+}
+
+void Blake3::compressBlock()
+{
+    compress(chunkCv, block, BlockLen, chunkCounter, blocksCompressed == 0 ? ChunkStart : 0, chunkCv);
+    ++blocksCompressed;
+    blockLen = 0;
+}
+
+void Blake3::pushCv(const quint32 *cv, int level, quint64 totalChunks)
+{
+    // 与二进制加法的进位相同：totalChunks的低位每有一个0，就与栈顶的同级子树合并一次
+    quint32 merged[8];
+    memcpy(merged, cv, sizeof(merged));
+    for(quint64 t = totalChunks >> level; (t & 1) == 0; t >>= 1)
+        parentCv(cvStack[--cvStackLen], merged, merged);
+    memcpy(cvStack[cvStackLen++], merged, sizeof(merged));
+}
+
+void Blake3::addChunks(const uchar *data, qint64 chunks)
+{
+    // 按计数器对齐的完整子树划分，每棵子树再按PieceChunks切分成并行任务
+    struct Subtree
+    {
+        qint64 firstChunk;
+        qint64 chunks;
+        int firstPiece;
+        int pieces;
+    };
+    QVector<Subtree> subtrees;
+    int pieces = 0;
+    for(qint64 first = 0; first < chunks;)
+    {
+        const qint64 size = alignedSubtree(chunkCounter + quint64(first), chunks - first);
+        const int n = int(qMax<qint64>(1, size / PieceChunks));
+        subtrees.append(Subtree{ first, size, pieces, n });
+        pieces += n;
+        first += size;
+    }
+
+    QVector<quint32> pieceCvs(pieces * 8);
+    const auto computePiece = [&](int piece) {
+        // 子树内的各任务块数相同
+        int s = 0;
+        while (piece >= subtrees[s].firstPiece + subtrees[s].pieces)
+            ++s;
+        const Subtree &tree = subtrees[s];
+        const qint64 pieceChunks = tree.chunks / tree.pieces;
+        const qint64 first = tree.firstChunk + qint64(piece - tree.firstPiece) * pieceChunks;
+        subtreeCv(data + first * ChunkLen, pieceChunks, chunkCounter + quint64(first), pieceCvs.data() + piece * 8);
+    };
+    if(chunks * ChunkLen >= ParallelMinSize && pieces > 1)
+        ParallelChecksum::forEachChunk(pieces, computePiece);
+    else
+    {
+        for(auto i = 0; i < pieces; ++i)
+            computePiece(i);
+    }
+
+    for(const auto &tree : subtrees)
+    {
+        quint32 *cvs = pieceCvs.data() + tree.firstPiece * 8;
+        for(auto n = tree.pieces; n > 1; n /= 2)
+        {
+            for(auto i = 0; i < n / 2; ++i)
+                parentCv(cvs + 16 * i, cvs + 16 * i + 8, cvs + 8 * i);
+        }
+        chunkCounter += quint64(tree.chunks);
+        pushCv(cvs, log2Of(tree.chunks), chunkCounter);
+    }
+}
+
+void Blake3::update(const char *data, qint64 dataLen)
+{
+    const uchar *input = reinterpret_cast<const uchar*>(data);
+    while (dataLen > 0)
+    {
+        // 当前块已满且后面还有数据，当前块不是根节点，结束它
+        if(blocksCompressed * BlockLen + blockLen == ChunkLen)
+        {
+            quint32 cv[8];
+            compress(chunkCv, block, blockLen, chunkCounter, (blocksCompressed == 0 ? ChunkStart : 0) | ChunkEnd, cv);
+            ++chunkCounter;
+            pushCv(cv, 0, chunkCounter);
+            memcpy(chunkCv, IV, sizeof(chunkCv));
+            blockLen = 0;
+            blocksCompressed = 0;
+        }
+        // 块边界上的整块数据直接按子树计算，最后至少留1字节给块状态
+        if(blocksCompressed == 0 && blockLen == 0 && dataLen > ChunkLen)
+        {
+            const qint64 chunks = (dataLen - 1) / ChunkLen;
+            addChunks(input, chunks);
+            input += chunks * ChunkLen;
+            dataLen -= chunks * ChunkLen;
+            continue;
+        }
+        // 分组已满且后面还有数据时才压缩，块的最后一个分组要留到结束时加ChunkEnd标志
+        if(blockLen == BlockLen)
+            compressBlock();
+        const int take = int(qMin<qint64>(qMin(BlockLen - blockLen, ChunkLen - blocksCompressed * BlockLen - blockLen), dataLen));
+        memcpy(block + blockLen, input, size_t(take));
+        blockLen += take;
+        input += take;
+        dataLen -= take;
+    }
+}
+
+QByteArray Blake3::finalize() const
+{
+    // 从当前块开始，沿链值栈自右向左逐层作为右子节点，直到根节点
+    quint32 cv[8];
+    memcpy(cv, chunkCv, sizeof(cv));
+    uchar lastBlock[BlockLen] = {};
+    memcpy(lastBlock, block, size_t(blockLen));
+    int len = blockLen;
+    quint64 counter = chunkCounter;
+    quint8 flags = (blocksCompressed == 0 ? ChunkStart : 0) | ChunkEnd;
+    for(auto i = cvStackLen - 1; i >= 0; --i)
+    {
+        quint32 right[8];
+        compress(cv, lastBlock, len, counter, flags, right);
+        storeCv(cvStack[i], lastBlock);
+        storeCv(right, lastBlock + OutLen);
+        memcpy(cv, IV, sizeof(cv));
+        len = BlockLen;
+        counter = 0;
+        flags = Parent;
+    }
+    // 根节点的计数器是输出分组序号，32字节摘要只需第0组
+    quint32 root[8];
+    compress(cv, lastBlock, len, 0, flags | Root, root);
+    QByteArray digest(OutLen, 0);
+    storeCv(root, reinterpret_cast<uchar*>(digest.data()));
+    return digest;
+}
+
+QByteArray Blake3::hash(const char *data, qint64 dataLen)
+{
+    Blake3 hasher;
+    hasher.update(data, dataLen);
+    return hasher.finalize();
+}
@@ -0,0 +1,62 @@
+#ifndef BLAKE3_H
+#define BLAKE3_H
+
+#include <QByteArray>
+#include <QtGlobal>
+
+/*********************************************************************************
+** 文件描述：       BLAKE3加密摘要（默认哈希模式，256位输出）
+** 设计：          输入按1KiB分为块（chunk），每块16个64字节分组依次压缩得到块的链值，
+**                链值再两两压缩成二叉树，根节点加ROOT标志得到摘要，结果与官方实现相同。
+**                各块、同层各父节点之间互不依赖：x86-64上用SSE4.1一次压缩4路、
+**                AVX2一次压缩8路（运行时检测），向量的每个32位通道对应一个块；
+**                大段输入再按PieceChunks个块的完整子树分给全局线程池并行计算（树模式），
+**                子树的链值按顺序压入链值栈合并，与逐块计算完全等价。
+**                流式计算时最后一块总是留在块状态中，直到finalize()时才确定哪个节点是根。
+**                每个对象只能在一个线程中使用。
+**********************************************************************************/
+
+class Blake3
+{
+public:
+    static constexpr int OutLen = 32;
+    static constexpr int BlockLen = 64;
+    static constexpr int ChunkLen = 1024;
+    // 并行计算时每个任务的块数（256KiB），以及启用并行的最小数据长度
+    static constexpr int PieceChunks = 256;
+    static constexpr qint64 ParallelMinSize = qint64(1) << 20;
+
+    Blake3();
+
+    // 重新开始计算
+    void init();
+    // 输入一段数据
+    void update(const char *data, qint64 dataLen);
+    // 得到已输入数据的32字节摘要
+    QByteArray finalize() const;
+
+    // 一次性计算data的摘要
+    static QByteArray hash(const char *data, qint64 dataLen);
+
+private:
+    // chunks个完整块（从chunkCounter开始）按对齐的完整子树计算链值并压栈
+    void addChunks(const uchar *data, qint64 chunks);
+    // 压入覆盖2^level个块、结束于第totalChunks块的子树链值，与栈顶的同级子树合并
+    void pushCv(const quint32 *cv, int level, quint64 totalChunks);
+    // 压缩块状态中已满的分组
+    void compressBlock();
+
+    // 链值栈，最多54层（2^54块）
+    static constexpr int MaxDepth = 54;
+    quint32 cvStack[MaxDepth][8];
+    int cvStackLen;
+
+    // 当前块的状态
+    quint32 chunkCv[8];
+    quint64 chunkCounter;
+    alignas(16) uchar block[BlockLen];
+    int blockLen;
+    int blocksCompressed;
+};
+
+#endif // BLAKE3_H
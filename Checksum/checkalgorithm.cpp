@@ -0,0 +1,126 @@
+#include "checkalgorithm.h"
+#include "crcengine.h"
+#include "checksumengine.h"
+#include "checksumcontext.h"
+#include "parallelchecksum.h"
+#include "crcmodel.h"
+
+namespace
+{
+    template<typename Engine>
+    quint64 computeWith(const char *data, qint64 dataLen)
+    {
+        return ChecksumCompute<Engine>(data, dataLen);
+    }
+
+    template<typename Engine>
+    quint64 computeSegmentsWith(const ChecksumSegment *segments, int count)
+    {
+        return ChecksumComputeSegments<Engine>(segments, count);
+    }
+
+    template<typename Engine>
+    bool computeFileWith(QFile &file, quint64 *result, QString *errorString, const ParallelChecksum::Progress &progress)
+    {
+        typename Engine::value_type value = 0;
+        if(!ParallelChecksumFile<Engine>(file, &value, errorString, progress))
+            return false;
+        *result = value;
+        return true;
+    }
+
+    template<typename Engine>
+    quint64 patchWith(quint64 crc, qint64 dataLen, qint64 offset, const char *delta, qint64 deltaLen)
+    {
+        return Engine::patch(typename Engine::value_type(crc), dataLen, offset, delta, deltaLen);
+    }
+
+    // CRC算法的参数直接取自CrcEngine的编译期参数，不重复书写
+    template<typename Engine>
+    CheckAlgorithm crcAlgorithm(const char *name, quint64 check)
+    {
+        typedef typename Engine::spec_type Spec;
+        return CheckAlgorithm{ name, CheckAlgorithm::Crc, Spec::width,
+                               Spec::poly, Spec::init, Spec::refIn, Spec::refOut, Spec::xorOut,
+                               check, &computeWith<Engine>, &computeSegmentsWith<Engine>, &computeFileWith<Engine>,
+                               &patchWith<Engine> };
+    }
+
+    template<typename Engine>
+    CheckAlgorithm checksumAlgorithm(const char *name, quint64 check)
+    {
+        return CheckAlgorithm{ name, CheckAlgorithm::Checksum, Engine::width,
+                               0, 0, false, false, 0, check, &computeWith<Engine>, &computeSegmentsWith<Engine>,
+                               &computeFileWith<Engine>, nullptr };
+    }
+}
+
+CheckAlgorithmRegistry::CheckAlgorithmRegistry()
+{
+    table = {
+        crcAlgorithm<Crc8>("Crc8", 0xF4),
+        crcAlgorithm<Crc8Itu>("Crc8_ITU", 0xA1),
+        crcAlgorithm<Crc8Rohc>("Crc8_ROHC", 0xD0),
+        crcAlgorithm<Crc8Maxim>("Crc8_MAXIM", 0xA1),
+
+        crcAlgorithm<Crc16CcittTrue>("Crc16_CCITT_True", 0x2189),
+        crcAlgorithm<Crc16CcittFalse>("Crc16_CCITT_False", 0x29B1),
+        crcAlgorithm<Crc16Xmodem>("Crc16_XMODEM", 0x31C3),
+        crcAlgorithm<Crc16X25>("Crc16_X25", 0x906E),
+        crcAlgorithm<Crc16Modbus>("Crc16_MODBUS", 0x4B37),
+        crcAlgorithm<Crc16Ibm>("Crc16_IBM", 0xBB3D),
+        crcAlgorithm<Crc16Maxim>("Crc16_MAXIM", 0x44C2),
+        crcAlgorithm<Crc16Usb>("Crc16_USB", 0xB4C8),
+        crcAlgorithm<Crc16Dnp>("Crc16_DNP", 0xEA82),
+
+        crcAlgorithm<Crc32WinRar>("Crc32_WinRAR", 0xCBF43926),
+        crcAlgorithm<Crc32Mpeg>("Crc32_MPEG", 0x0376E6E7),
+
+        checksumAlgorithm<Checksum8>("Checksum_8", 0xDE),
+        checksumAlgorithm<Checksum8Reverse>("Checksum_8_REVERSE", 0x21),
+        checksumAlgorithm<Checksum16>("Checksum_16", 0xD509),
+        checksumAlgorithm<Checksum16Reverse>("Checksum_16_REVERSE", 0x2AF6),
+        checksumAlgorithm<SumCheck8>("SumCheck_8", 0xDD),
+        checksumAlgorithm<Xor8>("Xor_8", 0x31),
+    };
+
+    for(auto i = 0; i < table.size(); ++i)
+        nameIndex.insert(QString(table[i].name).toUpper(), i);
+}
+
+const QVector<CheckAlgorithm>& CheckAlgorithmRegistry::algorithms() const
+{
+    return table;
+}
+
+const CheckAlgorithm* CheckAlgorithmRegistry::find(const QString &name) const
+{
+    auto it = nameIndex.constFind(name.toUpper());
+    if(it == nameIndex.constEnd())
+        return nullptr;
+    return &table[it.value()];
+}
+
+const CheckAlgorithm* CheckAlgorithmRegistry::find(const CrcParams &params) const
+{
+    for(const auto &algorithm : table)
+    {
+        if(algorithm.kind == CheckAlgorithm::Crc && algorithm.width == params.width
+                && algorithm.poly == params.poly && algorithm.init == params.init
+                && algorithm.refIn == params.refIn && algorithm.refOut == params.refOut
+                && algorithm.xorOut == params.xorOut)
+            return &algorithm;
+    }
+    return nullptr;
+}
+
+QVector<const CheckAlgorithm*> CheckAlgorithmRegistry::list(CheckAlgorithm::Kind kind, int width) const
+{
+    QVector<const CheckAlgorithm*> ret;
+    for(const auto &algorithm : table)
+    {
+        if(algorithm.kind == kind && (width == 0 || algorithm.width == width))
+            ret.append(&algorithm);
+    }
+    return ret;
+}
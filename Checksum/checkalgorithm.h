@@ -0,0 +1,94 @@
+#ifndef CHECKALGORITHM_H
+#define CHECKALGORITHM_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include "parallelchecksum.h"
+
+class QFile;
+struct CrcParams;
+struct ChecksumSegment;
+
+/*********************************************************************************
+** 文件描述：       校验算法注册表
+** 设计：          每个校验算法在注册表中只登记一次，登记项带有算法名称、校验码宽度、
+**                CRC参数以及直接调用的计算函数。界面按名称或宽度取得登记项后保存指针，
+**                发送、接收等频繁调用的路径直接调用compute，不再经过字符串拼接和
+**                QMetaObject::invokeMethod的元方法查找、参数装箱。
+**                注册表在首次调用getCARInstance()时构造（局部静态变量的初始化是线程安全的），
+**                构造后只读；各算法的计算函数没有共享的可变状态，可在多个I/O线程中并发调用。
+**                computeFile对大文件分块多线程计算后合并（见parallelchecksum.h），结果与compute相同。
+**********************************************************************************/
+
+struct CheckAlgorithm
+{
+    enum Kind
+    {
+        Crc = 0,        // CRC校验
+        Checksum,       // 累加和、异或类校验
+    };
+
+    // 一次性计算data的校验码，结果存放在低width位
+    typedef quint64 (*ComputeFunc)(const char *data, qint64 dataLen);
+    // 按顺序计算多个不连续数据段的校验码，与拼接后计算的结果相同（见checksumcontext.h）
+    typedef quint64 (*ComputeSegmentsFunc)(const ChecksumSegment *segments, int count);
+    // 多线程计算已打开文件的校验码，每段结束时调用progress（可为空），见ParallelChecksumFile；
+    // 失败或progress要求停止时返回false
+    typedef bool (*ComputeFileFunc)(QFile &file, quint64 *result, QString *errorString,
+                                    const ParallelChecksum::Progress &progress);
+    // 增量更新：dataLen字节的数据从offset开始的deltaLen个字节与delta异或后，由原校验码得到新校验码
+    typedef quint64 (*PatchFunc)(quint64 crc, qint64 dataLen, qint64 offset, const char *delta, qint64 deltaLen);
+
+    const char *name;   // 算法名称，即界面下拉框显示的名称
+    Kind kind;
+    int width;          // 校验码位数：8、16、32
+    // CRC参数模型，累加和类算法无意义，均为0
+    quint64 poly;
+    quint64 init;
+    bool refIn;
+    bool refOut;
+    quint64 xorOut;
+    quint64 check;      // "123456789"的校验值
+    ComputeFunc compute;
+    ComputeSegmentsFunc computeSegments;
+    ComputeFileFunc computeFile;
+    PatchFunc patch;    // 见CrcEngine::patch，累加和类算法为nullptr
+
+    // 校验码字节数
+    int bytes() const
+    {
+        return width / 8;
+    }
+};
+
+class CheckAlgorithmRegistry
+{
+public:
+    /***** Singleton pattern class definition *******/
+    static const CheckAlgorithmRegistry& getCARInstance()
+    {
+        static const CheckAlgorithmRegistry instance;
+        return instance;
+    }
+
+    // 所有登记的算法，顺序即界面显示顺序
+    const QVector<CheckAlgorithm>& algorithms() const;
+    // 按名称查找算法，不区分大小写，找不到返回nullptr
+    const CheckAlgorithm* find(const QString &name) const;
+    // 按CRC参数查找已登记的CRC算法，找不到返回nullptr（由调用方改用CrcModel计算）
+    const CheckAlgorithm* find(const CrcParams &params) const;
+    // 指定类型和校验码宽度的算法列表，width为0时返回该类型的全部算法
+    QVector<const CheckAlgorithm*> list(CheckAlgorithm::Kind kind, int width = 0) const;
+
+private:
+    CheckAlgorithmRegistry();
+    CheckAlgorithmRegistry(const CheckAlgorithmRegistry&) = delete;
+    CheckAlgorithmRegistry& operator=(const CheckAlgorithmRegistry&) = delete;
+
+    QVector<CheckAlgorithm> table;
+    // 大写名称到table下标的索引
+    QHash<QString, int> nameIndex;
+};
+
+#endif // CHECKALGORITHM_H
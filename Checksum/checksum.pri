@@ -0,0 +1,18 @@
+# 链接Checksum静态库。使用方法：在工程文件中 include(<相对路径>/Checksum/checksum.pri)，
+# 并在上级subdirs工程中声明对Checksum的依赖（depends），保证静态库先编译
+# 静态库使用了QtConcurrent，链接方也需要引入该模块
+QT += concurrent
+
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+CHECKSUM_OUT_PWD = $$shadowed($$PWD)
+
+win32:CONFIG(release, debug|release): CHECKSUM_LIB_DIR = $$CHECKSUM_OUT_PWD/release
+else:win32:CONFIG(debug, debug|release): CHECKSUM_LIB_DIR = $$CHECKSUM_OUT_PWD/debug
+else: CHECKSUM_LIB_DIR = $$CHECKSUM_OUT_PWD
+
+LIBS += -L$$CHECKSUM_LIB_DIR -lChecksum
+
+win32-g++|unix: PRE_TARGETDEPS += $$CHECKSUM_LIB_DIR/libChecksum.a
+else:win32: PRE_TARGETDEPS += $$CHECKSUM_LIB_DIR/Checksum.lib
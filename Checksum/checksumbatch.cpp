@@ -0,0 +1,200 @@
+#include "checksumbatch.h"
+#include "checkalgorithm.h"
+#include "checksumengine.h"
+#include "crccombine.h"
+#include "crcengine.h"
+
+namespace
+{
+    // CRC寄存器通道：宽度、多项式、RefIn相同的算法共用一个从0开始的寄存器
+    struct CrcLane
+    {
+        int width;
+        quint64 poly;
+        bool refIn;
+        // 更新函数，为空时是交错计算的CRC8通道或自定义通道
+        quint64 (*update)(quint64 reg, const char *data, qint64 dataLen);
+        // 自定义通道的模型（Init、XorOut为0）
+        QSharedPointer<const CrcModel> model;
+        // CrcEngine的存放形式：RefIn为true时为反转形式，否则为低width位
+        quint64 reg;
+    };
+
+    template<typename Engine>
+    quint64 laneUpdate(quint64 reg, const char *data, qint64 dataLen)
+    {
+        return Engine::update(typename Engine::value_type(reg), data, dataLen);
+    }
+
+    template<typename Engine>
+    CrcLane engineLane(bool fused = false)
+    {
+        typedef typename Engine::spec_type Spec;
+        return CrcLane{ Spec::width, Spec::poly, Spec::refIn, fused ? nullptr : &laneUpdate<Engine>,
+                        QSharedPointer<const CrcModel>(), 0 };
+    }
+
+    // 交错计算的CRC8通道个数，位于通道表的最前面
+    constexpr int FusedCrc8Lanes = 3;
+
+    // 3个CRC8通道在同一个循环中查表：x^8+x^2+x+1（不反转、反转）和x^8+x^5+x^4+1（反转）；
+    // 宽度为8时两种形式都是reg = table[reg ^ byte]
+    void updateCrc8Lanes(CrcLane *lanes, const uchar *p, qint64 dataLen)
+    {
+        const auto &t0 = Crc8::table;
+        const auto &t1 = Crc8Rohc::table;
+        const auto &t2 = Crc8Maxim::table;
+        quint8 a = quint8(lanes[0].reg);
+        quint8 b = quint8(lanes[1].reg);
+        quint8 c = quint8(lanes[2].reg);
+        while (dataLen--)
+        {
+            const uchar d = *p++;
+            a = t0[a ^ d];
+            b = t1[b ^ d];
+            c = t2[c ^ d];
+        }
+        lanes[0].reg = a;
+        lanes[1].reg = b;
+        lanes[2].reg = c;
+    }
+
+    int findLane(const QVector<CrcLane> &lanes, const CrcParams &params)
+    {
+        for(auto i = 0; i < lanes.size(); ++i)
+        {
+            const CrcLane &lane = lanes[i];
+            if(lane.width == params.width && lane.poly == (params.poly & params.mask()) && lane.refIn == params.refIn)
+                return i;
+        }
+        return -1;
+    }
+
+    // 由通道寄存器导出params的校验码：补上Init·x^(8n)，再做输出处理
+    quint64 laneValue(const CrcLane &lane, const CrcParams &params, qint64 dataLen)
+    {
+        const int w = params.width;
+        const quint64 mask = params.mask();
+        const quint64 init = params.refIn ? CrcCombine::reflect(params.init & mask, w) : params.init & mask;
+        quint64 reg = lane.reg ^ CrcCombine::shift(init, dataLen, lane.poly, w, params.refIn);
+        if(params.refIn != params.refOut)
+            reg = CrcCombine::reflect(reg, w);
+        return (reg ^ params.xorOut) & mask;
+    }
+
+    // 累加和类算法的共用状态
+    struct SumLanes
+    {
+        Checksum8::state_type sum8;
+        Checksum16::state_type sum16;
+        Xor8::state_type xor8;
+    };
+
+    // 由共用状态导出累加和类算法的校验码，表中没有的算法返回false，由调用方单独计算
+    bool sumValue(const char *name, const SumLanes &s, quint64 *value)
+    {
+        if(qstrcmp(name, "Checksum_8") == 0)
+            *value = Checksum8::finalize(s.sum8);
+        else if(qstrcmp(name, "Checksum_8_REVERSE") == 0)
+            *value = Checksum8Reverse::finalize(s.sum8);
+        else if(qstrcmp(name, "Checksum_16") == 0)
+            *value = Checksum16::finalize(s.sum16);
+        else if(qstrcmp(name, "Checksum_16_REVERSE") == 0)
+            *value = Checksum16Reverse::finalize(s.sum16);
+        else if(qstrcmp(name, "SumCheck_8") == 0)
+            *value = SumCheck8::finalize(SumCheck8::state_type(s.sum8));     // 8位累加和的低8位
+        else if(qstrcmp(name, "Xor_8") == 0)
+            *value = Xor8::finalize(s.xor8);
+        else
+            return false;
+        return true;
+    }
+}
+
+QVector<ChecksumBatchResult> ChecksumBatch::computeAll(const char *data, qint64 dataLen,
+                                                       const QVector<QPair<QString, CrcParams>> &custom)
+{
+    QVector<CrcLane> lanes = {
+        engineLane<Crc8>(true),
+        engineLane<Crc8Rohc>(true),
+        engineLane<Crc8Maxim>(true),
+        engineLane<Crc16CcittTrue>(),
+        engineLane<Crc16Xmodem>(),
+        engineLane<Crc16Ibm>(),
+        engineLane<Crc16Dnp>(),
+        engineLane<Crc32WinRar>(),
+        engineLane<Crc32Mpeg>(),
+    };
+    // 与已有通道参数都不同的自定义算法各建一个通道
+    for(const auto &item : custom)
+    {
+        const CrcParams &params = item.second;
+        if(!params.isValid() || findLane(lanes, params) >= 0)
+            continue;
+        CrcParams base = params;
+        base.poly &= base.mask();
+        base.init = 0;
+        base.refOut = base.refIn;
+        base.xorOut = 0;
+        lanes.append(CrcLane{ base.width, base.poly, base.refIn, nullptr, CrcModelCache::get(base), 0 });
+    }
+    SumLanes sums = { Checksum8::initial(), Checksum16::initial(), Xor8::initial() };
+
+    for(qint64 offset = 0; offset < dataLen; offset += BlockSize)
+    {
+        const char *block = data + offset;
+        const qint64 len = qMin(BlockSize, dataLen - offset);
+        updateCrc8Lanes(lanes.data(), reinterpret_cast<const uchar*>(block), len);
+        for(auto i = FusedCrc8Lanes; i < lanes.size(); ++i)
+        {
+            CrcLane &lane = lanes[i];
+            lane.reg = lane.update ? lane.update(lane.reg, block, len) : lane.model->update(lane.reg, block, len);
+        }
+        sums.sum8 = Checksum8::update(sums.sum8, block, len);
+        sums.sum16 = Checksum16::update(sums.sum16, block, len);
+        sums.xor8 = Xor8::update(sums.xor8, block, len);
+    }
+    // CrcModel不反转时寄存器左对齐，转换为低width位
+    for(auto &lane : lanes)
+    {
+        if(lane.model && !lane.refIn)
+            lane.reg >>= 64 - lane.width;
+    }
+
+    QVector<ChecksumBatchResult> results;
+    for(const auto &algorithm : CheckAlgorithmRegistry::getCARInstance().algorithms())
+    {
+        quint64 value = 0;
+        bool derived = false;
+        if(algorithm.kind == CheckAlgorithm::Crc)
+        {
+            CrcParams params;
+            params.width = algorithm.width;
+            params.poly = algorithm.poly;
+            params.init = algorithm.init;
+            params.refIn = algorithm.refIn;
+            params.refOut = algorithm.refOut;
+            params.xorOut = algorithm.xorOut;
+            const int lane = findLane(lanes, params);
+            if(lane >= 0)
+            {
+                value = laneValue(lanes[lane], params, dataLen);
+                derived = true;
+            }
+        }
+        else
+            derived = sumValue(algorithm.name, sums, &value);
+        // 新登记的算法没有对应的通道时单独计算
+        if(!derived)
+            value = algorithm.compute(data, dataLen);
+        results.append(ChecksumBatchResult{ QString(algorithm.name), algorithm.width, value });
+    }
+    for(const auto &item : custom)
+    {
+        if(!item.second.isValid())
+            continue;
+        const CrcLane &lane = lanes[findLane(lanes, item.second)];
+        results.append(ChecksumBatchResult{ item.first, item.second.width, laneValue(lane, item.second, dataLen) });
+    }
+    return results;
+}
@@ -0,0 +1,58 @@
+#ifndef CHECKSUMBATCH_H
+#define CHECKSUMBATCH_H
+
+#include <QByteArray>
+#include <QPair>
+#include <QString>
+#include <QVector>
+#include "crcmodel.h"
+
+/*********************************************************************************
+** 文件描述：       一次遍历计算全部校验算法
+** 设计：          查找设备使用的校验算法时需要对同一段数据计算注册表中的全部算法。
+**                CRC寄存器对初值是仿射的：reg(Init, M) = reg(0, M) ^ Init·x^(8n) mod P，
+**                因此多项式和RefIn相同的算法（如MODBUS、IBM、MAXIM、USB）共用一个从0开始的
+**                寄存器通道，结束后按各自的Init、RefOut、XorOut导出结果，15个CRC算法只需
+**                计算8个寄存器；累加和类算法同样共用累加状态（取反的变体只在输出时不同）。
+**                数据按BlockSize分块，每块依次交给所有通道，块留在L1缓存中，整段数据只从
+**                内存读取一次；3个CRC8通道在同一个循环中交错查表，互不依赖的查表可以并行执行，
+**                16/32位通道沿用CrcEngine的无进位乘法/Slicing-by-N实现。
+**                CRC参数配置表中的自定义算法可一并传入，与某个通道参数相同的直接导出，
+**                否则由CrcModel单独建一个通道。
+**********************************************************************************/
+
+struct ChecksumBatchResult
+{
+    QString name;       // 算法名称
+    int width;          // 校验码位数
+    quint64 value;      // 校验码，存放在低width位
+
+    // 校验码字节数
+    int bytes() const
+    {
+        return (width + 7) / 8;
+    }
+
+    // 按大端（高字节在前）或小端存放的校验码
+    QByteArray toBytes(bool bigEndian) const
+    {
+        const int n = bytes();
+        QByteArray code(n, 0);
+        for(auto i = 0; i < n; ++i)
+            code[bigEndian ? n - 1 - i : i] = char(value >> (8 * i));
+        return code;
+    }
+};
+
+namespace ChecksumBatch
+{
+    // 分块大小：各通道依次处理同一块数据时，块仍在L1缓存中
+    constexpr qint64 BlockSize = 16 * 1024;
+
+    // 一次遍历data，计算注册表中全部算法以及custom中的自定义CRC算法，结果按注册表顺序排列，
+    // 自定义算法在后
+    QVector<ChecksumBatchResult> computeAll(const char *data, qint64 dataLen,
+                                            const QVector<QPair<QString, CrcParams>> &custom = QVector<QPair<QString, CrcParams>>());
+}
+
+#endif // CHECKSUMBATCH_H
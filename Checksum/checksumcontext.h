@@ -0,0 +1,99 @@
+#ifndef CHECKSUMCONTEXT_H
+#define CHECKSUMCONTEXT_H
+
+#include <QtGlobal>
+#include <initializer_list>
+
+/*********************************************************************************
+** 文件描述：       流式校验计算上下文
+** 设计：          init()初始化，update()按顺序输入任意个数据段，finalize()得到校验码，
+**                结果与把所有数据段拼接后一次性计算完全相同。数据长度为64位，
+**                大文件、数据流可以分块读取计算，不需要把数据拼接到一个缓冲区中。
+**                Engine为CrcEngine的任一实例（如Crc16Modbus），或checksumengine.h中的
+**                累加和类算法（如Checksum16）。
+**                帧头、数据、帧尾等分别存放的数据段可用ChecksumComputeSegments一次计算，
+**                各段依次输入同一个状态，不需要先拼接成一个QByteArray。
+** 用法：           ChecksumContext<Crc32WinRar> ctx;
+**                while(...) ctx.update(buf, len);
+**                quint32 crc = ctx.finalize();
+**********************************************************************************/
+template<typename Engine>
+class ChecksumContext
+{
+public:
+    typedef typename Engine::value_type value_type;
+    typedef typename Engine::state_type state_type;
+
+    ChecksumContext()
+        : state(Engine::initial())
+    {
+    }
+
+    // 重新开始计算
+    void init()
+    {
+        state = Engine::initial();
+        length = 0;
+    }
+
+    // 输入一段数据
+    void update(const char *data, qint64 dataLen)
+    {
+        if(dataLen <= 0)
+            return;
+        state = Engine::update(state, data, dataLen);
+        length += dataLen;
+    }
+
+    // 得到已输入数据的校验码，不改变上下文状态，可继续update
+    value_type finalize() const
+    {
+        return Engine::finalize(state);
+    }
+
+    // 已输入的数据总长度
+    qint64 size() const
+    {
+        return length;
+    }
+
+private:
+    state_type state;
+    qint64 length = 0;
+};
+
+// 一次性计算data的校验码
+template<typename Engine>
+typename Engine::value_type ChecksumCompute(const char *data, qint64 dataLen)
+{
+    return Engine::finalize(Engine::update(Engine::initial(), data, dataLen));
+}
+
+// 不连续存放的一段数据，只引用不复制，数据需在计算期间有效
+struct ChecksumSegment
+{
+    const char *data;
+    qint64 size;
+};
+
+// 按顺序计算count个数据段的校验码，结果与把各段拼接后一次性计算完全相同
+template<typename Engine>
+typename Engine::value_type ChecksumComputeSegments(const ChecksumSegment *segments, int count)
+{
+    typename Engine::state_type state = Engine::initial();
+    for(auto i = 0; i < count; ++i)
+    {
+        if(segments[i].size > 0)
+            state = Engine::update(state, segments[i].data, segments[i].size);
+    }
+    return Engine::finalize(state);
+}
+
+// 用法：ChecksumComputeSegments<Crc16Modbus>({ { head, headLen }, { body.constData(), body.size() } })
+template<typename Engine>
+typename Engine::value_type ChecksumComputeSegments(std::initializer_list<ChecksumSegment> segments)
+{
+    return ChecksumComputeSegments<Engine>(segments.begin(), int(segments.size()));
+}
+
+#endif // CHECKSUMCONTEXT_H
@@ -0,0 +1,124 @@
+#include "checksumdetect.h"
+#include "parallelchecksum.h"
+#include <QAtomicInteger>
+
+namespace
+{
+    // 第i个算法的两个候选位：大端为第2i位，小端为第2i+1位
+    constexpr quint64 BigEndianBit = 1;
+    constexpr quint64 LittleEndianBit = 2;
+
+    // 全部算法的初始候选掩码
+    quint64 initialCandidates()
+    {
+        const QVector<CheckAlgorithm> &table = CheckAlgorithmRegistry::getCARInstance().algorithms();
+        // 每个算法占两位，掩码最多容纳32个算法
+        Q_ASSERT(table.size() <= 32);
+        quint64 mask = 0;
+        for(auto i = 0; i < table.size(); ++i)
+            mask |= (table[i].bytes() == 1 ? BigEndianBit : BigEndianBit | LittleEndianBit) << (2 * i);
+        return mask;
+    }
+}
+
+ChecksumDetector::ChecksumDetector()
+{
+    reset();
+}
+
+void ChecksumDetector::reset()
+{
+    candidates = initialCandidates();
+    frames = 0;
+}
+
+quint64 ChecksumDetector::check(quint64 mask, const char *frame, qint64 frameLen)
+{
+    const QVector<CheckAlgorithm> &table = CheckAlgorithmRegistry::getCARInstance().algorithms();
+    quint64 kept = 0;
+    for(auto i = 0; i < table.size() && (mask >> (2 * i)) != 0; ++i)
+    {
+        const quint64 bits = (mask >> (2 * i)) & (BigEndianBit | LittleEndianBit);
+        if(bits == 0)
+            continue;
+        const CheckAlgorithm &algorithm = table[i];
+        const int bytes = algorithm.bytes();
+        if(frameLen <= bytes)
+            continue;
+
+        const qint64 dataLen = frameLen - bytes;
+        const uchar *code = reinterpret_cast<const uchar*>(frame + dataLen);
+        quint64 big = 0;
+        quint64 little = 0;
+        for(auto j = 0; j < bytes; ++j)
+        {
+            big = (big << 8) | code[j];
+            little |= quint64(code[j]) << (8 * j);
+        }
+        const quint64 value = algorithm.compute(frame, dataLen);
+        quint64 matched = 0;
+        if(value == big)
+            matched |= BigEndianBit;
+        if(value == little)
+            matched |= LittleEndianBit;
+        kept |= (bits & matched) << (2 * i);
+    }
+    return kept;
+}
+
+void ChecksumDetector::addFrame(const char *frame, qint64 frameLen)
+{
+    if(candidates != 0)
+        candidates = check(candidates, frame, frameLen);
+    ++frames;
+}
+
+void ChecksumDetector::addFrames(const QVector<QByteArray> &frameList)
+{
+    const int count = frameList.size();
+    if(count < ParallelMinFrames)
+    {
+        for(const QByteArray &frame : frameList)
+            addFrame(frame);
+        return;
+    }
+
+    QAtomicInteger<quint64> alive(candidates);
+    const int tasks = (count + FramesPerTask - 1) / FramesPerTask;
+    ParallelChecksum::forEachChunk(tasks, [&](int task) {
+        const int end = qMin(count, (task + 1) * FramesPerTask);
+        quint64 mask = alive.loadRelaxed();
+        for(auto i = task * FramesPerTask; i < end && mask != 0; ++i)
+        {
+            const quint64 kept = check(mask, frameList[i].constData(), frameList[i].size());
+            // 排除的候选立即告知其它任务，同时取得其它任务排除的结果
+            mask = (kept != mask ? alive.fetchAndAndRelaxed(kept) : alive.loadRelaxed()) & kept;
+        }
+    });
+    candidates = alive.loadRelaxed();
+    frames += count;
+}
+
+QVector<ChecksumMatch> ChecksumDetector::matches() const
+{
+    QVector<ChecksumMatch> result;
+    if(frames == 0)
+        return result;
+    const QVector<CheckAlgorithm> &table = CheckAlgorithmRegistry::getCARInstance().algorithms();
+    for(auto i = 0; i < table.size(); ++i)
+    {
+        const quint64 bits = candidates >> (2 * i);
+        if(bits & BigEndianBit)
+            result.append(ChecksumMatch{ &table[i], true });
+        if(bits & LittleEndianBit)
+            result.append(ChecksumMatch{ &table[i], false });
+    }
+    return result;
+}
+
+QVector<ChecksumMatch> ChecksumDetector::detect(const QVector<QByteArray> &frames)
+{
+    ChecksumDetector detector;
+    detector.addFrames(frames);
+    return detector.matches();
+}
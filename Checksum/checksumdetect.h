@@ -0,0 +1,71 @@
+#ifndef CHECKSUMDETECT_H
+#define CHECKSUMDETECT_H
+
+#include <QByteArray>
+#include <QVector>
+#include "checkalgorithm.h"
+
+/*********************************************************************************
+** 文件描述：       识别帧尾校验码使用的校验算法
+** 设计：          每个样本帧为"数据+校验码"，校验码在帧尾，占1、2或4字节。注册表中每个算法
+**                （CRC8/16/32及累加和类算法）按大端、小端各是一个候选，候选集合用64位掩码表示，
+**                每个算法占两位；1字节校验码没有字节序之分，只占大端一位。
+**                每帧只计算仍在候选中的算法，一次计算同时比较两种字节序；随机数据与某个8位
+**                算法偶然一致的概率为1/256，通常检查几帧后只剩真正的算法，之后每帧只计算一个
+**                算法，可以跟随实时收到的帧逐帧调用addFrame()。
+**                帧数较多时addFrames()把帧分组交给全局线程池，各组共享一个原子掩码，
+**                某组排除的候选其它组立即不再计算，结果与逐帧检查相同。
+**                与CrcReveng不同，这里只在已登记的算法中查找，不反推未知参数。
+**********************************************************************************/
+
+struct ChecksumMatch
+{
+    const CheckAlgorithm *algorithm;
+    bool bigEndian;     // 校验码按大端存放；1字节校验码固定为true
+};
+
+class ChecksumDetector
+{
+public:
+    // 帧数达到该值时并行检查，以及并行时每组的帧数
+    static constexpr int ParallelMinFrames = 256;
+    static constexpr int FramesPerTask = 64;
+
+    ChecksumDetector();
+
+    // 重新开始识别，全部算法恢复为候选
+    void reset();
+    // 检查一帧，排除与该帧不一致的候选；帧长度不超过校验码长度时该算法也被排除
+    void addFrame(const char *frame, qint64 frameLen);
+    void addFrame(const QByteArray &frame)
+    {
+        addFrame(frame.constData(), frame.size());
+    }
+    // 检查多帧
+    void addFrames(const QVector<QByteArray> &frameList);
+
+    // 已检查的帧数
+    qint64 frameCount() const
+    {
+        return frames;
+    }
+    // 是否还有候选，没有时不必再检查后续的帧
+    bool hasCandidates() const
+    {
+        return candidates != 0;
+    }
+    // 与已检查的全部帧一致的算法及字节序，按注册表顺序排列；还没有检查任何帧时为空
+    QVector<ChecksumMatch> matches() const;
+
+    // 一次性识别与全部帧一致的算法
+    static QVector<ChecksumMatch> detect(const QVector<QByteArray> &frames);
+
+private:
+    // 在候选掩码mask中排除与该帧不一致的候选，返回剩下的候选
+    static quint64 check(quint64 mask, const char *frame, qint64 frameLen);
+
+    quint64 candidates;
+    qint64 frames;
+};
+
+#endif // CHECKSUMDETECT_H
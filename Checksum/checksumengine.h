@@ -0,0 +1,239 @@
+#ifndef CHECKSUMENGINE_H
+#define CHECKSUMENGINE_H
+
+#include <QtGlobal>
+#include <QtEndian>
+#include "checksumsimd.h"
+
+/*********************************************************************************
+** 文件描述：       累加和、异或类校验算法
+** 设计：          与CrcEngine的接口一致：initial()给出初始状态，update()可对任意个数据段
+**                反复调用，finalize()由状态得到校验码，因此同样可以用ChecksumContext流式计算；
+**                empty()、combine()用于分块并行计算后合并结果。
+**                长数据使用SIMD内核（见checksumsimd.h）累加或异或，短帧仍逐字节计算。
+**                Checksum算法：在资源相对紧张的一些平台上，运行CRC（循环冗余算法）比较吃力，
+**                或者需要快速校验的场合使用。
+**********************************************************************************/
+
+// 使用SIMD内核的最小数据长度（字节）
+constexpr qint64 ChecksumSimdMinLen = 32;
+
+// 8位Checksum：使用16位变量保存数据的累加和，再将累加和的高8位和低8位相加
+struct Checksum8
+{
+    typedef quint8 value_type;
+    typedef quint16 state_type;
+
+    static constexpr int width = 8;
+
+    static constexpr state_type initial()
+    {
+        return 0;
+    }
+
+    static constexpr state_type empty()
+    {
+        return 0;
+    }
+
+    static state_type update(state_type sum, const char *data, qint64 dataLen)
+    {
+        const uchar *p = reinterpret_cast<const uchar*>(data);
+#if defined(CPU_HAVE_X86_SIMD)
+        if(dataLen >= ChecksumSimdMinLen)
+            return state_type(sum + ChecksumSimd::byteSum(p, dataLen));
+#endif
+        while (dataLen--)
+            sum += *p++;
+        return sum;
+    }
+
+    // 累加和按模2^16相加即可合并
+    static constexpr state_type combine(state_type sum, state_type tail, qint64)
+    {
+        return state_type(sum + tail);
+    }
+
+    static value_type finalize(state_type sum)
+    {
+        // 将16位校验和折算为8位（低8位+高8位）
+        while(sum >> 8)
+            sum = (sum & 0xFF) + (sum >> 8);
+        return value_type(sum);
+    }
+};
+
+// 8位Checksum取反
+struct Checksum8Reverse : Checksum8
+{
+    static value_type finalize(state_type sum)
+    {
+        return value_type(~Checksum8::finalize(sum));
+    }
+};
+
+// 16位Checksum的状态：跨数据段时需要暂存奇数长度数据段的最后一个字节
+struct Checksum16State
+{
+    quint64 sum;
+    qint16 pending;     // 待与下一个字节组成16位字的字节，-1表示无
+};
+
+// 16位Checksum：按小端16位字累加，奇数长度时最后一个字节作为低8位累加，再把进位回卷到低16位
+struct Checksum16
+{
+    typedef quint16 value_type;
+    typedef Checksum16State state_type;
+
+    static constexpr int width = 16;
+
+    static constexpr state_type initial()
+    {
+        return state_type{0, -1};
+    }
+
+    static constexpr state_type empty()
+    {
+        return initial();
+    }
+
+    static state_type update(state_type state, const char *data, qint64 dataLen)
+    {
+        const uchar *p = reinterpret_cast<const uchar*>(data);
+        if(dataLen > 0 && state.pending >= 0)
+        {
+            state.sum += quint16(state.pending | (*p++ << 8));
+            state.pending = -1;
+            --dataLen;
+        }
+#if defined(CPU_HAVE_X86_SIMD)
+        if(dataLen >= ChecksumSimdMinLen)
+        {
+            const qint64 words = dataLen / 2;
+            state.sum += ChecksumSimd::wordSum(p, words);
+            p += words * 2;
+            dataLen -= words * 2;
+        }
+#endif
+        while (dataLen >= 2)
+        {
+            state.sum += qFromLittleEndian<quint16>(p);
+            p += 2;
+            dataLen -= 2;
+        }
+        if(dataLen == 1)
+            state.pending = *p;
+        return state;
+    }
+
+    // 合并要求前面的数据为偶数长度（没有暂存字节），否则后一块的16位字边界会错开
+    static state_type combine(state_type state, state_type tail, qint64)
+    {
+        Q_ASSERT(state.pending < 0);
+        return state_type{state.sum + tail.sum, tail.pending};
+    }
+
+    static value_type finalize(state_type state)
+    {
+        quint64 sum = state.sum;
+        if(state.pending >= 0)
+            sum += quint16(state.pending);
+        // 将高位进位折算到低16位
+        while(sum >> 16)
+            sum = (sum & 0xFFFF) + (sum >> 16);
+        return value_type(sum);
+    }
+};
+
+// 16位Checksum取反
+struct Checksum16Reverse : Checksum16
+{
+    static value_type finalize(state_type state)
+    {
+        return value_type(~Checksum16::finalize(state));
+    }
+};
+
+// 和校验：所有字节累加，只保留低8位
+struct SumCheck8
+{
+    typedef quint8 value_type;
+    typedef quint8 state_type;
+
+    static constexpr int width = 8;
+
+    static constexpr state_type initial()
+    {
+        return 0;
+    }
+
+    static constexpr state_type empty()
+    {
+        return 0;
+    }
+
+    static state_type update(state_type sum, const char *data, qint64 dataLen)
+    {
+        const uchar *p = reinterpret_cast<const uchar*>(data);
+#if defined(CPU_HAVE_X86_SIMD)
+        if(dataLen >= ChecksumSimdMinLen)
+            return state_type(sum + ChecksumSimd::byteSum(p, dataLen));
+#endif
+        while (dataLen--)
+            sum += *p++;
+        return sum;
+    }
+
+    static constexpr state_type combine(state_type sum, state_type tail, qint64)
+    {
+        return state_type(sum + tail);
+    }
+
+    static constexpr value_type finalize(state_type sum)
+    {
+        return sum;
+    }
+};
+
+// 异或校验：所有字节依次异或
+struct Xor8
+{
+    typedef quint8 value_type;
+    typedef quint8 state_type;
+
+    static constexpr int width = 8;
+
+    static constexpr state_type initial()
+    {
+        return 0;
+    }
+
+    static constexpr state_type empty()
+    {
+        return 0;
+    }
+
+    static state_type update(state_type result, const char *data, qint64 dataLen)
+    {
+        const uchar *p = reinterpret_cast<const uchar*>(data);
+#if defined(CPU_HAVE_X86_SIMD)
+        if(dataLen >= ChecksumSimdMinLen)
+            return state_type(result ^ ChecksumSimd::byteXor(p, dataLen));
+#endif
+        while (dataLen--)
+            result ^= *p++;
+        return result;
+    }
+
+    static constexpr state_type combine(state_type result, state_type tail, qint64)
+    {
+        return state_type(result ^ tail);
+    }
+
+    static constexpr value_type finalize(state_type result)
+    {
+        return result;
+    }
+};
+
+#endif // CHECKSUMENGINE_H
@@ -0,0 +1,165 @@
+#include "checksumsimd.h"
+
+#if defined(CPU_HAVE_X86_SIMD)
+
+#include <emmintrin.h>
+#include <immintrin.h>
+
+namespace
+{
+    // 把两个64位通道相加
+    inline quint64 horizontalSum(__m128i acc)
+    {
+        return quint64(_mm_cvtsi128_si64(acc)) + quint64(_mm_cvtsi128_si64(_mm_unpackhi_epi64(acc, acc)));
+    }
+
+    // 把16个字节异或到一起
+    inline quint8 horizontalXor(__m128i acc)
+    {
+        acc = _mm_xor_si128(acc, _mm_srli_si128(acc, 8));
+        acc = _mm_xor_si128(acc, _mm_srli_si128(acc, 4));
+        acc = _mm_xor_si128(acc, _mm_srli_si128(acc, 2));
+        acc = _mm_xor_si128(acc, _mm_srli_si128(acc, 1));
+        return quint8(_mm_cvtsi128_si32(acc));
+    }
+
+    // 短于该长度时AVX2的收尾开销大于收益，使用SSE2版本
+    constexpr qint64 Avx2MinLen = 256;
+
+    // 把256位的4个64位通道相加为128位的2个通道
+    CPU_TARGET("avx2")
+    inline __m128i narrow(__m256i acc)
+    {
+        return _mm_add_epi64(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    }
+
+    quint64 byteSumSse2(const uchar *p, qint64 dataLen)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        __m128i acc0 = zero;
+        __m128i acc1 = zero;
+        for(; dataLen >= 32; dataLen -= 32, p += 32)
+        {
+            acc0 = _mm_add_epi64(acc0, _mm_sad_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), zero));
+            acc1 = _mm_add_epi64(acc1, _mm_sad_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16)), zero));
+        }
+        if(dataLen >= 16)
+        {
+            acc0 = _mm_add_epi64(acc0, _mm_sad_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), zero));
+            p += 16;
+            dataLen -= 16;
+        }
+        quint64 sum = horizontalSum(_mm_add_epi64(acc0, acc1));
+        while (dataLen--)
+            sum += *p++;
+        return sum;
+    }
+
+    CPU_TARGET("avx2")
+    quint64 byteSumAvx2(const uchar *p, qint64 dataLen)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        __m256i acc0 = zero;
+        __m256i acc1 = zero;
+        for(; dataLen >= 64; dataLen -= 64, p += 64)
+        {
+            acc0 = _mm256_add_epi64(acc0, _mm256_sad_epu8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)), zero));
+            acc1 = _mm256_add_epi64(acc1, _mm256_sad_epu8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32)), zero));
+        }
+        const quint64 sum = horizontalSum(narrow(_mm256_add_epi64(acc0, acc1)));
+        // 清除YMM高128位后再执行SSE指令，否则每次调用都要付出AVX/SSE状态切换的开销
+        _mm256_zeroupper();
+        return sum + byteSumSse2(p, dataLen);
+    }
+
+    // 小端16位字的和 = 低字节之和 + 高字节之和·256
+    quint64 wordSumSse2(const uchar *p, qint64 words)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i lowMask = _mm_set1_epi16(0x00FF);
+        __m128i lo = zero;
+        __m128i hi = zero;
+        for(; words >= 8; words -= 8, p += 16)
+        {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            lo = _mm_add_epi64(lo, _mm_sad_epu8(_mm_and_si128(v, lowMask), zero));
+            hi = _mm_add_epi64(hi, _mm_sad_epu8(_mm_srli_epi16(v, 8), zero));
+        }
+        quint64 sum = horizontalSum(lo) + (horizontalSum(hi) << 8);
+        for(; words > 0; --words, p += 2)
+            sum += quint16(p[0] | (p[1] << 8));
+        return sum;
+    }
+
+    CPU_TARGET("avx2")
+    quint64 wordSumAvx2(const uchar *p, qint64 words)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i lowMask = _mm256_set1_epi16(0x00FF);
+        __m256i lo = zero;
+        __m256i hi = zero;
+        for(; words >= 16; words -= 16, p += 32)
+        {
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            lo = _mm256_add_epi64(lo, _mm256_sad_epu8(_mm256_and_si256(v, lowMask), zero));
+            hi = _mm256_add_epi64(hi, _mm256_sad_epu8(_mm256_srli_epi16(v, 8), zero));
+        }
+        const quint64 sum = horizontalSum(narrow(lo)) + (horizontalSum(narrow(hi)) << 8);
+        _mm256_zeroupper();
+        return sum + wordSumSse2(p, words);
+    }
+
+    quint8 byteXorSse2(const uchar *p, qint64 dataLen)
+    {
+        __m128i acc0 = _mm_setzero_si128();
+        __m128i acc1 = _mm_setzero_si128();
+        for(; dataLen >= 32; dataLen -= 32, p += 32)
+        {
+            acc0 = _mm_xor_si128(acc0, _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+            acc1 = _mm_xor_si128(acc1, _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16)));
+        }
+        if(dataLen >= 16)
+        {
+            acc0 = _mm_xor_si128(acc0, _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+            p += 16;
+            dataLen -= 16;
+        }
+        quint8 result = horizontalXor(_mm_xor_si128(acc0, acc1));
+        while (dataLen--)
+            result ^= *p++;
+        return result;
+    }
+
+    CPU_TARGET("avx2")
+    quint8 byteXorAvx2(const uchar *p, qint64 dataLen)
+    {
+        __m256i acc0 = _mm256_setzero_si256();
+        __m256i acc1 = _mm256_setzero_si256();
+        for(; dataLen >= 64; dataLen -= 64, p += 64)
+        {
+            acc0 = _mm256_xor_si256(acc0, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+            acc1 = _mm256_xor_si256(acc1, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32)));
+        }
+        const __m256i acc = _mm256_xor_si256(acc0, acc1);
+        const quint8 result = horizontalXor(_mm_xor_si128(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1)));
+        _mm256_zeroupper();
+        return quint8(result ^ byteXorSse2(p, dataLen));
+    }
+}
+
+quint64 ChecksumSimd::byteSum(const uchar *data, qint64 dataLen)
+{
+    return dataLen >= Avx2MinLen && CpuFeatures::hasAvx2() ? byteSumAvx2(data, dataLen) : byteSumSse2(data, dataLen);
+}
+
+quint64 ChecksumSimd::wordSum(const uchar *data, qint64 words)
+{
+    return words * 2 >= Avx2MinLen && CpuFeatures::hasAvx2() ? wordSumAvx2(data, words) : wordSumSse2(data, words);
+}
+
+quint8 ChecksumSimd::byteXor(const uchar *data, qint64 dataLen)
+{
+    return dataLen >= Avx2MinLen && CpuFeatures::hasAvx2() ? byteXorAvx2(data, dataLen) : byteXorSse2(data, dataLen);
+}
+
+#endif // CPU_HAVE_X86_SIMD
@@ -0,0 +1,27 @@
+#ifndef CHECKSUMSIMD_H
+#define CHECKSUMSIMD_H
+
+#include "cpufeatures.h"
+
+/*********************************************************************************
+** 文件描述：       累加和、异或类校验的SIMD内核
+** 设计：          字节累加用PSADBW（与0求绝对差之和）把每8个字节一次性累加到64位通道中，
+**                16位字累加把偶数、奇数字节分开求和，高字节的和最后乘以256，
+**                各通道均为64位，循环中不会溢出，进位统一推迟到finalize()时折算。
+**                异或校验按16/32字节整体异或，最后把向量内的各字节异或到一起。
+**                x86-64上SSE2总是可用；CPU支持AVX2时改用256位版本，运行时检测。
+**                各内核都处理完整的长度（包括不足一个向量的尾部），数据不要求对齐，
+**                结果与逐字节算法完全相同。
+**********************************************************************************/
+
+namespace ChecksumSimd
+{
+    // 所有字节之和
+    quint64 byteSum(const uchar *data, qint64 dataLen);
+    // words个小端16位字之和
+    quint64 wordSum(const uchar *data, qint64 words);
+    // 所有字节的异或
+    quint8 byteXor(const uchar *data, qint64 dataLen);
+}
+
+#endif // CHECKSUMSIMD_H
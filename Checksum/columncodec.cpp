@@ -0,0 +1,498 @@
+#include "columncodec.h"
+#include "cpufeatures.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#ifdef CPU_HAVE_X86_SIMD
+#  include <immintrin.h>
+#endif
+
+namespace
+{
+    // 每个值格式化后的最大长度（含换行符），如“-1.2345678901234567e-308”
+    constexpr int MaxTextLength = 32;
+    // 解包时每次重排、格式化的值的个数
+    constexpr int UnpackBatch = 1024;
+
+    // 10^0~10^22都能用double精确表示
+    const double Pow10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+    };
+
+    inline bool isDigit(char ch)
+    {
+        return ch >= '0' && ch <= '9';
+    }
+
+    inline bool isBlank(char ch)
+    {
+        return ch == ' ' || ch == '\t' || ch == '\r';
+    }
+
+    // 解析十进制整数，可带正负号；溢出或含其它字符时返回false
+    bool parseInteger(const char *p, const char *end, bool *negative, quint64 *magnitude)
+    {
+        *negative = false;
+        if(p < end && (*p == '+' || *p == '-'))
+            *negative = *p++ == '-';
+        if(p == end)
+            return false;
+        while (end - p > 1 && *p == '0')
+            ++p;
+        // 不超过19位的十进制数不会溢出，只需检查第20位
+        if(end - p > 20)
+            return false;
+        quint64 value = 0;
+        for(const char *last = end - (end - p == 20 ? 1 : 0); p < last; ++p)
+        {
+            if(!isDigit(*p))
+                return false;
+            value = value * 10 + uint(*p - '0');
+        }
+        if(p < end)
+        {
+            const uint digit = uint(*p - '0');
+            if(!isDigit(*p) || value > (std::numeric_limits<quint64>::max() - digit) / 10)
+                return false;
+            value = value * 10 + digit;
+        }
+        *magnitude = value;
+        return true;
+    }
+
+    // 常见写法直接计算：有效数字不超过2^53、10的指数不超过22时，一次乘除即得到正确舍入的结果
+    bool parseDoubleFast(const char *p, const char *end, double *result)
+    {
+        bool negative = false;
+        if(p < end && (*p == '+' || *p == '-'))
+            negative = *p++ == '-';
+        quint64 mantissa = 0;
+        int exponent = 0;
+        int digits = 0;
+        for(; p < end && isDigit(*p); ++p, ++digits)
+        {
+            if(mantissa > (quint64(1) << 53))
+                return false;
+            mantissa = mantissa * 10 + quint64(*p - '0');
+        }
+        if(p < end && *p == '.')
+        {
+            for(++p; p < end && isDigit(*p); ++p, ++digits, --exponent)
+            {
+                if(mantissa > (quint64(1) << 53))
+                    return false;
+                mantissa = mantissa * 10 + quint64(*p - '0');
+            }
+        }
+        if(digits == 0)
+            return false;
+        if(p < end && (*p == 'e' || *p == 'E'))
+        {
+            ++p;
+            bool negativeExp = false;
+            if(p < end && (*p == '+' || *p == '-'))
+                negativeExp = *p++ == '-';
+            if(p == end)
+                return false;
+            int exp = 0;
+            for(; p < end && isDigit(*p); ++p)
+            {
+                if(exp > 1000)
+                    return false;
+                exp = exp * 10 + (*p - '0');
+            }
+            exponent += negativeExp ? -exp : exp;
+        }
+        if(p != end || mantissa > (quint64(1) << 53) || exponent < -22 || exponent > 22)
+            return false;
+        double value = double(mantissa);
+        value = exponent < 0 ? value / Pow10[-exponent] : value * Pow10[exponent];
+        *result = negative ? -value : value;
+        return true;
+    }
+
+    bool parseDouble(const char *p, const char *end, double *result)
+    {
+        if(parseDoubleFast(p, end, result))
+            return true;
+        bool ok = false;
+        *result = QByteArray::fromRawData(p, int(end - p)).toDouble(&ok);
+        return ok;
+    }
+
+    // 解析一个字段，按小端写入out
+    template<typename T>
+    bool parseField(const char *p, const char *end, uchar *out)
+    {
+        T value;
+        if constexpr (std::is_floating_point<T>::value)
+        {
+            double d;
+            if(!parseDouble(p, end, &d))
+                return false;
+            if(sizeof(T) == 4 && qAbs(d) > double(std::numeric_limits<float>::max())
+                    && qAbs(d) != std::numeric_limits<double>::infinity())
+                return false;
+            value = T(d);
+        }
+        else
+        {
+            bool negative;
+            quint64 magnitude;
+            if(!parseInteger(p, end, &negative, &magnitude))
+                return false;
+            if(negative)
+            {
+                // 无符号类型只接受-0
+                const quint64 limit = std::is_signed<T>::value ? quint64(std::numeric_limits<T>::max()) + 1 : 0;
+                if(magnitude > limit)
+                    return false;
+                value = T(0 - magnitude);
+            }
+            else
+            {
+                if(magnitude > quint64(std::numeric_limits<T>::max()))
+                    return false;
+                value = T(magnitude);
+            }
+        }
+        FieldCodec::encode<T, FieldCodec::DCBA>(value, out);
+        return true;
+    }
+
+    // 去掉字段两端的空白和双引号
+    void trimField(const char **begin, const char **end)
+    {
+        const char *p = *begin;
+        const char *q = *end;
+        while (p < q && isBlank(*p))
+            ++p;
+        while (q > p && isBlank(q[-1]))
+            --q;
+        if(q - p >= 2 && *p == '"' && q[-1] == '"')
+        {
+            ++p;
+            --q;
+        }
+        *begin = p;
+        *end = q;
+    }
+
+    bool isBlankLine(const char *p, const char *end)
+    {
+        while (p < end && isBlank(*p))
+            ++p;
+        return p == end;
+    }
+
+    template<typename T>
+    qint64 packColumn(const char *text, qint64 textLen, int column, char delimiter, uchar *out, qint64 *errorLine)
+    {
+        const char *p = text;
+        const char *const end = text + textLen;
+        qint64 count = 0;
+        qint64 line = 0;
+        bool first = true;
+        while (p < end)
+        {
+            ++line;
+            // 一次扫描找到行尾和第column个字段，不逐段调用memchr
+            const char *lineBegin = p;
+            const char *fieldBegin = column == 0 ? p : nullptr;
+            const char *fieldEnd = nullptr;
+            auto field = 0;
+            for(; p < end && *p != '\n'; ++p)
+            {
+                if(*p != delimiter)
+                    continue;
+                ++field;
+                if(field == column)
+                    fieldBegin = p + 1;
+                else if(field == column + 1)
+                    fieldEnd = p;
+            }
+            const char *lineEnd = p;
+            if(p < end)
+                ++p;
+            if(fieldEnd == nullptr)
+                fieldEnd = lineEnd;
+
+            bool ok = false;
+            if(fieldBegin != nullptr)
+            {
+                trimField(&fieldBegin, &fieldEnd);
+                ok = parseField<T>(fieldBegin, fieldEnd, out + count * qint64(sizeof(T)));
+            }
+            if(ok)
+                ++count;
+            else if(isBlankLine(lineBegin, lineEnd))
+                continue;   // 空行跳过
+            else if(!first)
+            {
+                if(errorLine)
+                    *errorLine = line;
+                return -1;
+            }
+            // 第一个非空行解析失败时作为表头
+            first = false;
+        }
+        return count;
+    }
+
+    // 格式化无符号整数，返回字符数
+    int writeUnsigned(quint64 value, char *out)
+    {
+        char buffer[20];
+        char *p = buffer + sizeof(buffer);
+        do
+        {
+            *--p = char('0' + value % 10);
+            value /= 10;
+        } while (value != 0);
+        const int len = int(buffer + sizeof(buffer) - p);
+        memcpy(out, p, size_t(len));
+        return len;
+    }
+
+    // 取能还原为原值的最少有效位数
+    template<typename T>
+    int writeFloat(T value, char *out)
+    {
+        QByteArray text;
+        for(auto digits = std::numeric_limits<T>::digits10; digits <= std::numeric_limits<T>::max_digits10; ++digits)
+        {
+            text = QByteArray::number(double(value), 'g', digits);
+            double back;
+            if(parseDouble(text.constData(), text.constData() + text.size(), &back) && T(back) == value)
+                break;
+        }
+        const int len = qMin(text.size(), MaxTextLength - 1);
+        memcpy(out, text.constData(), size_t(len));
+        return len;
+    }
+
+    // 格式化一个小端存储的值，返回字符数
+    template<typename T>
+    int writeField(const uchar *in, char *out)
+    {
+        const T value = FieldCodec::decode<T, FieldCodec::DCBA>(in);
+        if constexpr (std::is_floating_point<T>::value)
+            return writeFloat(value, out);
+        else if constexpr (std::is_signed<T>::value)
+        {
+            if(value < 0)
+            {
+                *out = '-';
+                return 1 + writeUnsigned(0 - quint64(value), out + 1);
+            }
+            return writeUnsigned(quint64(value), out);
+        }
+        else
+            return writeUnsigned(quint64(value), out);
+    }
+
+    template<typename T>
+    qint64 unpackColumn(const uchar *data, qint64 count, FieldCodec::ByteOrder order, QByteArray *out)
+    {
+        uchar batch[UnpackBatch * sizeof(T)];
+        qint64 pos = out->size();
+        for(qint64 first = 0; first < count; first += UnpackBatch)
+        {
+            const int n = int(qMin<qint64>(UnpackBatch, count - first));
+            ColumnCodec::reorder(data + first * qint64(sizeof(T)), batch, n, int(sizeof(T)), order);
+            out->resize(int(pos + qint64(n) * MaxTextLength));
+            char *p = out->data() + pos;
+            for(auto i = 0; i < n; ++i)
+            {
+                p += writeField<T>(batch + i * sizeof(T), p);
+                *p++ = '\n';
+            }
+            pos = p - out->constData();
+        }
+        out->resize(int(pos));
+        return count;
+    }
+
+    // 逐个值重排
+    template<typename U>
+    void reorderScalar(const uchar *in, uchar *out, qint64 count, FieldCodec::ByteOrder order)
+    {
+        for(qint64 i = 0; i < count; ++i)
+            FieldCodec::encode<U>(FieldCodec::decode<U, FieldCodec::DCBA>(in + i * qint64(sizeof(U))), order,
+                                  out + i * qint64(sizeof(U)));
+    }
+
+    void reorderScalar(const uchar *in, uchar *out, qint64 count, int size, FieldCodec::ByteOrder order)
+    {
+        switch (size)
+        {
+        case 2:
+            reorderScalar<quint16>(in, out, count, order);
+            break;
+        case 4:
+            reorderScalar<quint32>(in, out, count, order);
+            break;
+        case 8:
+            reorderScalar<quint64>(in, out, count, order);
+            break;
+        default:
+            break;
+        }
+    }
+
+#ifdef CPU_HAVE_X86_SIMD
+    // 16字节的重排掩码：对字节下标0、1、2……按order重排，得到每个输出字节取自哪个输入字节
+    void shuffleMask(int size, FieldCodec::ByteOrder order, qint8 *mask)
+    {
+        uchar index[16];
+        for(auto i = 0; i < 16; ++i)
+            index[i] = uchar(i);
+        reorderScalar(index, reinterpret_cast<uchar*>(mask), 16 / size, size, order);
+    }
+
+    CPU_TARGET("sse4.1")
+    qint64 reorderSse41(const uchar *in, uchar *out, qint64 bytes, const qint8 *mask)
+    {
+        const __m128i shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask));
+        qint64 i = 0;
+        for(; i + 16 <= bytes; i += 16)
+        {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_shuffle_epi8(v, shuffle));
+        }
+        return i;
+    }
+
+    CPU_TARGET("avx2")
+    qint64 reorderAvx2(const uchar *in, uchar *out, qint64 bytes, const qint8 *mask)
+    {
+        // VPSHUFB在两个128位通道内分别重排，两个通道使用同一掩码
+        const __m256i shuffle = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(mask)));
+        qint64 i = 0;
+        for(; i + 64 <= bytes; i += 64)
+        {
+            const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+            const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i + 32));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_shuffle_epi8(a, shuffle));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i + 32), _mm256_shuffle_epi8(b, shuffle));
+        }
+        for(; i + 32 <= bytes; i += 32)
+        {
+            const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_shuffle_epi8(a, shuffle));
+        }
+        _mm256_zeroupper();
+        return i;
+    }
+#endif
+}
+
+void ColumnCodec::reorder(const uchar *in, uchar *out, qint64 count, int size, FieldCodec::ByteOrder order)
+{
+    const qint64 bytes = count * size;
+    // 1字节的值、小端不需要重排
+    if(size == 1 || order == FieldCodec::DCBA)
+    {
+        if(in != out)
+            memmove(out, in, size_t(bytes));
+        return;
+    }
+    qint64 done = 0;
+#ifdef CPU_HAVE_X86_SIMD
+    if(CpuFeatures::hasSse41())
+    {
+        alignas(16) qint8 mask[16];
+        shuffleMask(size, order, mask);
+        done = CpuFeatures::hasAvx2() ? reorderAvx2(in, out, bytes, mask) : reorderSse41(in, out, bytes, mask);
+    }
+#endif
+    reorderScalar(in + done, out + done, (bytes - done) / size, size, order);
+}
+
+qint64 ColumnCodec::pack(const char *text, qint64 textLen, FieldCodec::FieldType type, FieldCodec::ByteOrder order,
+                         int column, QByteArray *out, qint64 *errorLine, char delimiter)
+{
+    if(errorLine)
+        *errorLine = 0;
+    // 每行最多一个值，按行数一次分配
+    const qint64 lines = std::count(text, text + textLen, '\n') + 1;
+    const int size = FieldCodec::fieldSize(type);
+    const int start = out->size();
+    out->resize(int(start + lines * size));
+    uchar *data = reinterpret_cast<uchar*>(out->data()) + start;
+
+    qint64 count = -1;
+    switch (type)
+    {
+    case FieldCodec::Int8:
+        count = packColumn<qint8>(text, textLen, column, delimiter, data, errorLine);
+        break;
+    case FieldCodec::UInt8:
+        count = packColumn<quint8>(text, textLen, column, delimiter, data, errorLine);
+        break;
+    case FieldCodec::Int16:
+        count = packColumn<qint16>(text, textLen, column, delimiter, data, errorLine);
+        break;
+    case FieldCodec::UInt16:
+        count = packColumn<quint16>(text, textLen, column, delimiter, data, errorLine);
+        break;
+    case FieldCodec::Int32:
+        count = packColumn<qint32>(text, textLen, column, delimiter, data, errorLine);
+        break;
+    case FieldCodec::UInt32:
+        count = packColumn<quint32>(text, textLen, column, delimiter, data, errorLine);
+        break;
+    case FieldCodec::Int64:
+        count = packColumn<qint64>(text, textLen, column, delimiter, data, errorLine);
+        break;
+    case FieldCodec::UInt64:
+        count = packColumn<quint64>(text, textLen, column, delimiter, data, errorLine);
+        break;
+    case FieldCodec::Float:
+        count = packColumn<float>(text, textLen, column, delimiter, data, errorLine);
+        break;
+    case FieldCodec::Double:
+        count = packColumn<double>(text, textLen, column, delimiter, data, errorLine);
+        break;
+    }
+    if(count < 0)
+    {
+        out->resize(start);
+        return -1;
+    }
+    reorder(data, data, count, size, order);
+    out->resize(int(start + count * size));
+    return count;
+}
+
+qint64 ColumnCodec::unpack(const uchar *data, qint64 dataLen, FieldCodec::FieldType type, FieldCodec::ByteOrder order,
+                           QByteArray *out)
+{
+    const qint64 count = dataLen / FieldCodec::fieldSize(type);
+    switch (type)
+    {
+    case FieldCodec::Int8:
+        return unpackColumn<qint8>(data, count, order, out);
+    case FieldCodec::UInt8:
+        return unpackColumn<quint8>(data, count, order, out);
+    case FieldCodec::Int16:
+        return unpackColumn<qint16>(data, count, order, out);
+    case FieldCodec::UInt16:
+        return unpackColumn<quint16>(data, count, order, out);
+    case FieldCodec::Int32:
+        return unpackColumn<qint32>(data, count, order, out);
+    case FieldCodec::UInt32:
+        return unpackColumn<quint32>(data, count, order, out);
+    case FieldCodec::Int64:
+        return unpackColumn<qint64>(data, count, order, out);
+    case FieldCodec::UInt64:
+        return unpackColumn<quint64>(data, count, order, out);
+    case FieldCodec::Float:
+        return unpackColumn<float>(data, count, order, out);
+    case FieldCodec::Double:
+        return unpackColumn<double>(data, count, order, out);
+    }
+    return 0;
+}
@@ -0,0 +1,38 @@
+#ifndef COLUMNCODEC_H
+#define COLUMNCODEC_H
+
+#include <QByteArray>
+#include "fieldcodec.h"
+
+/*********************************************************************************
+** 文件描述：       CSV数值列与载荷字节之间的批量转换
+** 设计：          打包：逐行取出CSV文本中指定列的字段，解析为FieldCodec::FieldType类型的数值，
+**                先按小端写入输出缓冲区，全部解析完后整段按字节序重排一次。
+**                解包：整段按字节序重排为小端后逐个格式化，每个值一行。
+**                字节序重排（reorder）在x86-64上用PSHUFB一次重排16/32个字节（AVX2、SSE4.1，
+**                运行时检测），重排掩码由FieldCodec对字节下标0、1、2……编码得到，与逐个编码的结果一致；
+**                1字节类型和小端不需要重排。各种重排都是自身的逆变换，打包、解包共用。
+**                整数只接受十进制，可带正负号，超出类型范围时出错；浮点数常见的写法（有效数字不超过
+**                19位、10的指数不超过22）直接计算，结果正确舍入，其它写法交给QByteArray::toDouble，
+**                float与QString::toFloat相同，先解析为double再转换。格式化浮点数时输出能还原为
+**                原值的最少有效位数。
+**                空行跳过；第一个非空行解析失败时作为表头跳过，之后的行解析失败时返回出错的行号。
+**                字段两端的空白和双引号忽略。
+**********************************************************************************/
+
+namespace ColumnCodec
+{
+    // count个size字节的值按order重排字节：小端的值得到order的排列，反之亦然。in与out可以相同
+    void reorder(const uchar *in, uchar *out, qint64 count, int size, FieldCodec::ByteOrder order);
+
+    // 解析CSV文本第column列（从0开始）的数值，按type和order打包后追加到out。
+    // 返回值的个数；出错时返回-1，errorLine非空时返回出错的行号（从1开始），out不变
+    qint64 pack(const char *text, qint64 textLen, FieldCodec::FieldType type, FieldCodec::ByteOrder order,
+                int column, QByteArray *out, qint64 *errorLine = nullptr, char delimiter = ',');
+
+    // 把dataLen个字节按type和order解包，每个值一行追加到out，返回值的个数；末尾不足一个值的字节忽略
+    qint64 unpack(const uchar *data, qint64 dataLen, FieldCodec::FieldType type, FieldCodec::ByteOrder order,
+                  QByteArray *out);
+}
+
+#endif // COLUMNCODEC_H
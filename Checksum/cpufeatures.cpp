@@ -0,0 +1,105 @@
+#include "cpufeatures.h"
+
+#if defined(CPU_HAVE_X86_SIMD)
+#  if defined(Q_CC_MSVC)
+#    include <intrin.h>
+#  else
+#    include <cpuid.h>
+#  endif
+#endif
+
+namespace
+{
+    enum FeatureBit
+    {
+        Ssse3   = 0x01,
+        Sse41   = 0x02,
+        Pclmul  = 0x04,
+        Avx2    = 0x08,
+    };
+
+#if defined(CPU_HAVE_X86_SIMD)
+    void cpuid(int leaf, int subLeaf, quint32 regs[4])
+    {
+#  if defined(Q_CC_MSVC)
+        int info[4];
+        __cpuidex(info, leaf, subLeaf);
+        for(auto i = 0; i < 4; ++i)
+            regs[i] = quint32(info[i]);
+#  else
+        unsigned int a = 0, b = 0, c = 0, d = 0;
+        __cpuid_count(leaf, subLeaf, a, b, c, d);
+        regs[0] = a;
+        regs[1] = b;
+        regs[2] = c;
+        regs[3] = d;
+#  endif
+    }
+
+    // 读取XCR0，判断操作系统是否保存XMM/YMM寄存器状态
+    quint64 xgetbv0()
+    {
+#  if defined(Q_CC_MSVC)
+        return _xgetbv(0);
+#  else
+        quint32 eax = 0, edx = 0;
+        __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+        return (quint64(edx) << 32) | eax;
+#  endif
+    }
+#endif
+
+    int detect()
+    {
+        int features = 0;
+#if defined(CPU_HAVE_X86_SIMD)
+        quint32 regs[4] = {0, 0, 0, 0};
+        cpuid(0, 0, regs);
+        const quint32 maxLeaf = regs[0];
+        if(maxLeaf < 1)
+            return features;
+
+        cpuid(1, 0, regs);
+        const quint32 ecx1 = regs[2];
+        if(ecx1 & (1u << 9))
+            features |= Ssse3;
+        if(ecx1 & (1u << 19))
+            features |= Sse41;
+        if((ecx1 & (1u << 1)) && (features & Ssse3))
+            features |= Pclmul;
+
+        // AVX2：CPUID.7.0:EBX[5]，且OSXSAVE、AVX可用并且XCR0中XMM/YMM状态位均已置位
+        const bool osxsave = ecx1 & (1u << 27);
+        const bool avx = ecx1 & (1u << 28);
+        if(maxLeaf >= 7 && osxsave && avx && (xgetbv0() & 0x06) == 0x06)
+        {
+            cpuid(7, 0, regs);
+            if(regs[1] & (1u << 5))
+                features |= Avx2;
+        }
+#endif
+        return features;
+    }
+
+    int features()
+    {
+        // 局部静态变量的初始化是线程安全的，检测只执行一次
+        static const int detected = detect();
+        return detected;
+    }
+}
+
+bool CpuFeatures::hasPclmul()
+{
+    return features() & Pclmul;
+}
+
+bool CpuFeatures::hasSse41()
+{
+    return features() & Sse41;
+}
+
+bool CpuFeatures::hasAvx2()
+{
+    return features() & Avx2;
+}
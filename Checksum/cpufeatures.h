@@ -0,0 +1,34 @@
+#ifndef CPUFEATURES_H
+#define CPUFEATURES_H
+
+#include <QtGlobal>
+
+/*********************************************************************************
+** 文件描述：       运行时CPU指令集检测
+** 设计：          通过CPUID（以及AVX所需的XGETBV）检测当前CPU支持的扩展指令集，
+**                检测结果在首次调用时缓存。SIMD内核用CPU_TARGET标记单个函数的
+**                目标指令集，不需要修改整个工程的编译选项，由调用方按检测结果分派。
+**********************************************************************************/
+
+#if defined(Q_PROCESSOR_X86_64)
+#  define CPU_HAVE_X86_SIMD 1
+#endif
+
+// GCC/Clang需要为使用扩展指令集的函数单独指定目标，MSVC可直接使用对应的intrinsics
+#if defined(CPU_HAVE_X86_SIMD) && (defined(Q_CC_GNU) || defined(Q_CC_CLANG))
+#  define CPU_TARGET(features) __attribute__((target(features)))
+#else
+#  define CPU_TARGET(features)
+#endif
+
+namespace CpuFeatures
+{
+    // PCLMULQDQ无进位乘法，同时要求SSSE3（字节重排）
+    bool hasPclmul();
+    // SSE4.1
+    bool hasSse41();
+    // AVX2，同时要求操作系统已启用YMM寄存器状态保存
+    bool hasAvx2();
+}
+
+#endif // CPUFEATURES_H
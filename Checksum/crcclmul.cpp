@@ -0,0 +1,71 @@
+#include "crcclmul.h"
+
+#if defined(CPU_HAVE_X86_SIMD)
+
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#include <wmmintrin.h>
+
+namespace
+{
+    // X·x^distance mod P：累加器的低64位和高64位分别乘以对应的折叠常数
+    CPU_TARGET("pclmul,ssse3")
+    inline __m128i foldStep(__m128i x, __m128i k)
+    {
+        return _mm_xor_si128(_mm_clmulepi64_si128(x, k, 0x00), _mm_clmulepi64_si128(x, k, 0x11));
+    }
+
+    // 读取16字节数据块。非反转算法中第一个字节的最高位是最高次项，需要把16个字节倒序
+    CPU_TARGET("pclmul,ssse3")
+    inline __m128i loadBlock(const uchar *p, bool reflected, __m128i byteSwap)
+    {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        return reflected ? v : _mm_shuffle_epi8(v, byteSwap);
+    }
+}
+
+CPU_TARGET("pclmul,ssse3")
+void CrcClmul::fold(const uchar *data, qint64 blocks, bool reflected,
+                    quint64 seedLo, quint64 seedHi, const Constants &k, uchar folded[16])
+{
+    Q_ASSERT(blocks >= 4);
+
+    const __m128i byteSwap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const __m128i k4 = _mm_set_epi64x(qint64(k.fold4.hi), qint64(k.fold4.lo));
+    const __m128i k1 = _mm_set_epi64x(qint64(k.fold1.hi), qint64(k.fold1.lo));
+
+    // 当前CRC寄存器与第一个数据块异或，此后相当于从0开始计算
+    __m128i x0 = _mm_xor_si128(loadBlock(data, reflected, byteSwap), _mm_set_epi64x(qint64(seedHi), qint64(seedLo)));
+    __m128i x1 = loadBlock(data + 16, reflected, byteSwap);
+    __m128i x2 = loadBlock(data + 32, reflected, byteSwap);
+    __m128i x3 = loadBlock(data + 48, reflected, byteSwap);
+    data += 64;
+    blocks -= 4;
+
+    // 4个累加器并行折叠，每次处理64字节
+    while (blocks >= 4)
+    {
+        x0 = _mm_xor_si128(foldStep(x0, k4), loadBlock(data, reflected, byteSwap));
+        x1 = _mm_xor_si128(foldStep(x1, k4), loadBlock(data + 16, reflected, byteSwap));
+        x2 = _mm_xor_si128(foldStep(x2, k4), loadBlock(data + 32, reflected, byteSwap));
+        x3 = _mm_xor_si128(foldStep(x3, k4), loadBlock(data + 48, reflected, byteSwap));
+        data += 64;
+        blocks -= 4;
+    }
+
+    // 合并4个累加器，再逐块折叠剩余的数据块
+    __m128i x = _mm_xor_si128(foldStep(x0, k1), x1);
+    x = _mm_xor_si128(foldStep(x, k1), x2);
+    x = _mm_xor_si128(foldStep(x, k1), x3);
+    while (blocks--)
+    {
+        x = _mm_xor_si128(foldStep(x, k1), loadBlock(data, reflected, byteSwap));
+        data += 16;
+    }
+
+    if(!reflected)
+        x = _mm_shuffle_epi8(x, byteSwap);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(folded), x);
+}
+
+#endif // CPU_HAVE_X86_SIMD
@@ -0,0 +1,85 @@
+#ifndef CRCCLMUL_H
+#define CRCCLMUL_H
+
+#include "cpufeatures.h"
+
+/*********************************************************************************
+** 文件描述：       基于PCLMULQDQ无进位乘法的CRC折叠内核
+** 设计：          把已处理的数据看作128位多项式X，追加16字节数据块B时，
+**                X·x^128 + B ≡ X_hi·(x^192 mod P) + X_lo·(x^128 mod P) + B (mod P)，
+**                两次无进位乘法即可把X“折叠”到下一个数据块上；并行维护4个累加器，
+**                每次折叠64字节。折叠结束后的128位余式与原数据模P同余，
+**                由调用方用查表法对这16字节求CRC，得到与逐字节算法完全相同的寄存器值。
+**                折叠常数由CrcEngine在编译期按多项式生成，本内核与具体CRC算法无关。
+**********************************************************************************/
+
+namespace CrcClmul
+{
+    // 折叠常数：lo与128位累加器的低64位相乘，hi与高64位相乘
+    struct FoldConstants
+    {
+        quint64 lo;
+        quint64 hi;
+    };
+
+    struct Constants
+    {
+        FoldConstants fold4;    // 折叠距离512位（4个累加器并行）
+        FoldConstants fold1;    // 折叠距离128位
+    };
+
+    // 寄存器多项式x^e mod P，P = x^width + poly（width <= 32）
+    constexpr quint64 xPowMod(int e, quint64 poly, int width)
+    {
+        quint64 r = 1;
+        const quint64 top = quint64(1) << width;
+        for(auto i = 0; i < e; ++i)
+        {
+            r <<= 1;
+            if(r & top)
+                r ^= top | poly;
+        }
+        return r;
+    }
+
+    constexpr quint64 reflect64(quint64 v)
+    {
+        quint64 r = 0;
+        for(auto i = 0; i < 64; ++i)
+        {
+            if(v & (quint64(1) << i))
+                r |= quint64(1) << (63 - i);
+        }
+        return r;
+    }
+
+    // 折叠距离为distance位时的常数。反转算法中数据低位对应多项式高次项，
+    // 常数取x^(e-1) mod P的64位反转，乘积恰好落在128位累加器的对应位置上
+    constexpr FoldConstants foldConstants(int distance, quint64 poly, int width, bool reflected)
+    {
+        return reflected
+                ? FoldConstants{ reflect64(xPowMod(distance + 63, poly, width)),
+                                 reflect64(xPowMod(distance - 1, poly, width)) }
+                : FoldConstants{ xPowMod(distance, poly, width),
+                                 xPowMod(distance + 64, poly, width) };
+    }
+
+    constexpr Constants constants(quint64 poly, int width, bool reflected)
+    {
+        return Constants{ foldConstants(512, poly, width, reflected),
+                          foldConstants(128, poly, width, reflected) };
+    }
+
+    /*********************************************************************************
+    ** 函数描述：       折叠blocks个16字节数据块（blocks >= 4）
+    ** 函数输入参数：    data：数据，blocks：16字节块个数，reflected：是否为反转算法，
+    **                 seedLo/seedHi：与第一个数据块异或的128位初值（即当前CRC寄存器），
+    **                 k：折叠常数
+    ** 函数输出参数：    folded：折叠后的16字节余式，按原数据的字节顺序存放
+    ** 约束：           调用前需确认CpuFeatures::hasPclmul()为true
+    **********************************************************************************/
+    void fold(const uchar *data, qint64 blocks, bool reflected,
+              quint64 seedLo, quint64 seedHi, const Constants &k, uchar folded[16]);
+}
+
+#endif // CRCCLMUL_H
@@ -0,0 +1,73 @@
+#ifndef CRCCOMBINE_H
+#define CRCCOMBINE_H
+
+#include <QtGlobal>
+
+/*********************************************************************************
+** 文件描述：       CRC合并（GF(2)多项式运算）
+** 设计：          CRC寄存器的更新对(寄存器, 数据)是GF(2)上的线性运算：
+**                reg(R, A+B) = reg(R, A)·x^(8·|B|) mod P  ^  reg(0, B)，
+**                因此数据可以分块分别计算（除第一块外从0开始），再按块长度把前面的结果
+**                乘以x^(8n) mod P后与后一块异或，得到与顺序计算完全相同的寄存器值。
+**                x^(8n)用平方-乘算法求得，合并一次只需O(log n)次width位乘法，与块长度无关。
+**                以下运算均针对非反转形式（最高位为最高次项）的寄存器，反转算法由调用方转换。
+**********************************************************************************/
+
+namespace CrcCombine
+{
+    // 低width位颠倒
+    constexpr quint64 reflect(quint64 value, int width)
+    {
+        quint64 ret = 0;
+        for(auto i = 0; i < width; ++i)
+        {
+            if(value & (quint64(1) << i))
+                ret |= quint64(1) << (width - 1 - i);
+        }
+        return ret;
+    }
+
+    // a·b mod P，P = x^width + poly，width为1~64
+    constexpr quint64 mulMod(quint64 a, quint64 b, quint64 poly, int width)
+    {
+        const quint64 top = quint64(1) << (width - 1);
+        const quint64 mask = width == 64 ? ~quint64(0) : (quint64(1) << width) - 1;
+        quint64 r = 0;
+        for(auto i = width - 1; i >= 0; --i)
+        {
+            const bool carry = r & top;
+            r = (r << 1) & mask;
+            if(carry)
+                r ^= poly;
+            if((b >> i) & 1)
+                r ^= a;
+        }
+        return r;
+    }
+
+    // x^e mod P
+    constexpr quint64 xPowMod(quint64 e, quint64 poly, int width)
+    {
+        quint64 r = 1;
+        // width为1时x ≡ poly (mod P)
+        quint64 base = width > 1 ? 2 : (poly & 1);
+        while (e)
+        {
+            if(e & 1)
+                r = mulMod(r, base, poly, width);
+            base = mulMod(base, base, poly, width);
+            e >>= 1;
+        }
+        return r;
+    }
+
+    // 寄存器reg后接dataLen个0字节后的寄存器值；reflected为true时reg为反转形式
+    constexpr quint64 shift(quint64 reg, qint64 dataLen, quint64 poly, int width, bool reflected)
+    {
+        const quint64 k = xPowMod(quint64(dataLen) * 8, poly, width);
+        return reflected ? reflect(mulMod(reflect(reg, width), k, poly, width), width)
+                         : mulMod(reg, k, poly, width);
+    }
+}
+
+#endif // CRCCOMBINE_H
@@ -0,0 +1,344 @@
+#ifndef CRCENGINE_H
+#define CRCENGINE_H
+
+#include <QtGlobal>
+#include <QtEndian>
+#include <array>
+#include "crcclmul.h"
+#include "crccombine.h"
+
+/*********************************************************************************
+** 文件描述：       查表法CRC计算引擎
+** 设计：          按Rocksoft模型（Width、Poly、Init、RefIn、RefOut、XorOut）描述CRC算法，
+**                编译期生成256项查找表，每个字节只需一次查表、一次移位和一次异或。
+**                RefIn为true时，寄存器按反转后的形式保存，多项式也在编译期反转，
+**                运算时左移变为右移，因此不需要对输入数据逐字节做位反转。
+**                32位CRC的长数据使用Slicing-by-8/16算法，一次处理8/16个字节，
+**                打断逐字节查表的依赖链；短帧仍逐字节查表，不占用大表的缓存。
+**                16/32位CRC在支持PCLMULQDQ的x86-64 CPU上，长数据改用无进位乘法折叠
+**                （见crcclmul.h），运行时检测CPU，不支持时使用上述查表算法。
+**                分块计算的结果可用combine()合并（见crccombine.h），供多线程并行计算；
+**                数据中部分字节修改后，patch()由原校验码和修改量直接得到新校验码，不重新扫描数据。
+** 作者：           zjk
+** 日期：          2026年10月17日
+**********************************************************************************/
+
+// 把value的低width位颠倒过来，如width=8时0x12变成0x48
+template<typename T>
+constexpr T CrcReflect(T value, int width)
+{
+    T ret = 0;
+    for(auto i = 0; i < width; ++i)
+    {
+        if(value & (T(1) << i))
+            ret |= T(1) << (width - 1 - i);
+    }
+    return ret;
+}
+
+// CRC算法参数，各参数含义与CRC参数模型一致
+template<typename T, int W, T Poly, T Init, bool RefIn, bool RefOut, T XorOut>
+struct CrcSpec
+{
+    typedef T value_type;
+
+    static constexpr int width = W;
+    static constexpr T poly = Poly;
+    static constexpr T init = Init;
+    static constexpr bool refIn = RefIn;
+    static constexpr bool refOut = RefOut;
+    static constexpr T xorOut = XorOut;
+    // 低width位全为1的掩码
+    static constexpr T mask = T(~T(0) >> (sizeof(T) * 8 - W));
+
+    static_assert(W >= 8 && W <= int(sizeof(T) * 8), "CRC width must be between 8 and the register width");
+};
+
+// 编译期生成查找表
+template<typename Spec>
+constexpr std::array<typename Spec::value_type, 256> CrcMakeTable()
+{
+    typedef typename Spec::value_type value_type;
+    std::array<value_type, 256> t = {};
+    const value_type topBit = value_type(1) << (Spec::width - 1);
+    const value_type refPoly = CrcReflect<value_type>(Spec::poly, Spec::width);
+    for(auto i = 0; i < 256; ++i)
+    {
+        value_type crc = 0;
+        if(Spec::refIn)
+        {
+            crc = value_type(i);
+            for(auto j = 0; j < 8; ++j)
+                crc = (crc & 0x01) ? value_type((crc >> 1) ^ refPoly) : value_type(crc >> 1);
+        }
+        else
+        {
+            crc = value_type(value_type(i) << (Spec::width - 8));
+            for(auto j = 0; j < 8; ++j)
+                crc = (crc & topBit) ? value_type((crc << 1) ^ Spec::poly) : value_type(crc << 1);
+        }
+        t[i] = crc & Spec::mask;
+    }
+    return t;
+}
+
+// 编译期生成Slicing-by-N查找表：第k张表为字节i后跟k个0字节时的CRC寄存器值
+template<typename Spec, int N>
+constexpr std::array<std::array<typename Spec::value_type, 256>, N> CrcMakeSliceTable()
+{
+    typedef typename Spec::value_type value_type;
+    std::array<std::array<value_type, 256>, N> t = {};
+    t[0] = CrcMakeTable<Spec>();
+    for(auto k = 1; k < N; ++k)
+    {
+        for(auto i = 0; i < 256; ++i)
+        {
+            const value_type prev = t[k - 1][i];
+            if(Spec::refIn)
+                t[k][i] = value_type(prev >> 8) ^ t[0][prev & 0xFF];
+            else
+                t[k][i] = value_type(prev << 8) ^ t[0][prev >> (Spec::width - 8)];
+        }
+    }
+    return t;
+}
+
+template<typename Spec>
+struct CrcSliceTable
+{
+    static_assert(Spec::width == 32, "Slicing-by-N tables are only generated for 32-bit CRCs");
+
+    // 16张表共16KB，Slicing-by-8只使用前8张
+    static constexpr std::array<std::array<typename Spec::value_type, 256>, 16> table = CrcMakeSliceTable<Spec, 16>();
+};
+
+template<typename Spec>
+class CrcEngine
+{
+public:
+    typedef Spec spec_type;
+    typedef typename Spec::value_type value_type;
+    // CRC的计算状态就是寄存器本身
+    typedef value_type state_type;
+    typedef std::array<value_type, 256> Table;
+
+    static constexpr int width = Spec::width;
+    // 32位CRC选择查表算法的长度门限：短于SliceBy8MinLen逐字节查表，
+    // 不短于SliceBy16MinLen使用Slicing-by-16，其余使用Slicing-by-8
+    static constexpr qint64 SliceBy8MinLen = 16;
+    static constexpr qint64 SliceBy16MinLen = 256;
+    // 16/32位CRC使用无进位乘法折叠的最小长度
+    static constexpr qint64 ClmulMinLen = 128;
+
+    // 一次性计算data的CRC校验码
+    static value_type compute(const char *data, qint64 dataLen)
+    {
+        return finalize(update(initial(), data, dataLen));
+    }
+
+    // 寄存器初始值，RefIn为true时保存反转后的初始值
+    static constexpr value_type initial()
+    {
+        return Spec::refIn ? CrcReflect<value_type>(Spec::init, Spec::width) : Spec::init;
+    }
+
+    // 不含初始值的空状态：数据分块并行计算时，除第一块外各块从空状态开始计算
+    static constexpr value_type empty()
+    {
+        return 0;
+    }
+
+    // 合并分块结果：crc为前面数据的寄存器，tail为后一块数据（长度tailLen）从empty()开始的寄存器
+    static value_type combine(value_type crc, value_type tail, qint64 tailLen)
+    {
+        return value_type(CrcCombine::shift(crc, tailLen, Spec::poly, Spec::width, Spec::refIn)) ^ tail;
+    }
+
+    // 增量更新：长度为dataLen的数据从offset开始的deltaLen个字节与delta逐字节异或（delta为新旧字节的异或）后，
+    // 由原来的校验码crc得到新的校验码。寄存器对(初值, 数据)是线性的，等长的数据异或后
+    // reg(Init, M ^ Δ) = reg(Init, M) ^ reg(0, Δ)，Δ后面的0字节用combine()补上，
+    // 耗时只与deltaLen和log(dataLen)有关，与数据总长度无关
+    static value_type patch(value_type crc, qint64 dataLen, qint64 offset, const char *delta, qint64 deltaLen)
+    {
+        Q_ASSERT(offset >= 0 && deltaLen >= 0 && offset + deltaLen <= dataLen);
+        const value_type diff = combine(update(empty(), delta, deltaLen), empty(), dataLen - offset - deltaLen);
+        // finalize()中的XorOut在两个校验码之差中抵消
+        return value_type(crc ^ finalize(diff) ^ Spec::xorOut);
+    }
+
+    // 更新寄存器，32位CRC按数据长度选择查表算法
+    static value_type update(value_type crc, const char *data, qint64 dataLen)
+    {
+        const uchar *p = reinterpret_cast<const uchar*>(data);
+#if defined(CPU_HAVE_X86_SIMD)
+        if constexpr (Spec::width == 16 || Spec::width == 32)
+        {
+            if(dataLen >= ClmulMinLen && CpuFeatures::hasPclmul())
+            {
+                const qint64 blocks = dataLen / 16;
+                uchar folded[16];
+                CrcClmul::fold(p, blocks, Spec::refIn,
+                               Spec::refIn ? quint64(crc) : 0,
+                               Spec::refIn ? 0 : quint64(crc) << (64 - Spec::width),
+                               clmulConstants, folded);
+                // 折叠余式与已处理的数据同余，从0开始对其查表即得到当前寄存器值
+                crc = updateBytewise(0, folded, 16);
+                p += blocks * 16;
+                dataLen -= blocks * 16;
+            }
+        }
+#endif
+        if constexpr (Spec::width == 32)
+        {
+            if(dataLen >= SliceBy16MinLen)
+            {
+                const qint64 blocks = dataLen / 16;
+                crc = updateSliceBy16(crc, p, blocks);
+                p += blocks * 16;
+                dataLen -= blocks * 16;
+            }
+            else if(dataLen >= SliceBy8MinLen)
+            {
+                const qint64 blocks = dataLen / 8;
+                crc = updateSliceBy8(crc, p, blocks);
+                p += blocks * 8;
+                dataLen -= blocks * 8;
+            }
+        }
+        return updateBytewise(crc, p, dataLen);
+    }
+
+    // 逐字节查表更新寄存器
+    static value_type updateBytewise(value_type crc, const uchar *p, qint64 dataLen)
+    {
+        if(Spec::refIn)
+        {
+            while (dataLen--)
+                crc = table[(crc ^ *p++) & 0xFF] ^ shiftRight8(crc);
+        }
+        else
+        {
+            while (dataLen--)
+                crc = (table[((crc >> (Spec::width - 8)) ^ *p++) & 0xFF] ^ shiftLeft8(crc)) & Spec::mask;
+        }
+        return crc;
+    }
+
+    // Slicing-by-8：每次处理8个字节，blocks为8字节块的个数
+    static value_type updateSliceBy8(value_type crc, const uchar *p, qint64 blocks)
+    {
+        const auto &t = CrcSliceTable<Spec>::table;
+        while (blocks--)
+        {
+            if(Spec::refIn)
+            {
+                const quint32 one = qFromLittleEndian<quint32>(p) ^ crc;
+                const quint32 two = qFromLittleEndian<quint32>(p + 4);
+                crc = t[7][one & 0xFF] ^ t[6][(one >> 8) & 0xFF] ^ t[5][(one >> 16) & 0xFF] ^ t[4][one >> 24]
+                    ^ t[3][two & 0xFF] ^ t[2][(two >> 8) & 0xFF] ^ t[1][(two >> 16) & 0xFF] ^ t[0][two >> 24];
+            }
+            else
+            {
+                const quint32 one = qFromBigEndian<quint32>(p) ^ crc;
+                const quint32 two = qFromBigEndian<quint32>(p + 4);
+                crc = t[7][one >> 24] ^ t[6][(one >> 16) & 0xFF] ^ t[5][(one >> 8) & 0xFF] ^ t[4][one & 0xFF]
+                    ^ t[3][two >> 24] ^ t[2][(two >> 16) & 0xFF] ^ t[1][(two >> 8) & 0xFF] ^ t[0][two & 0xFF];
+            }
+            p += 8;
+        }
+        return crc;
+    }
+
+    // Slicing-by-16：每次处理16个字节，blocks为16字节块的个数
+    static value_type updateSliceBy16(value_type crc, const uchar *p, qint64 blocks)
+    {
+        const auto &t = CrcSliceTable<Spec>::table;
+        while (blocks--)
+        {
+            if(Spec::refIn)
+            {
+                const quint32 one = qFromLittleEndian<quint32>(p) ^ crc;
+                const quint32 two = qFromLittleEndian<quint32>(p + 4);
+                const quint32 three = qFromLittleEndian<quint32>(p + 8);
+                const quint32 four = qFromLittleEndian<quint32>(p + 12);
+                crc = t[15][one & 0xFF] ^ t[14][(one >> 8) & 0xFF] ^ t[13][(one >> 16) & 0xFF] ^ t[12][one >> 24]
+                    ^ t[11][two & 0xFF] ^ t[10][(two >> 8) & 0xFF] ^ t[9][(two >> 16) & 0xFF] ^ t[8][two >> 24]
+                    ^ t[7][three & 0xFF] ^ t[6][(three >> 8) & 0xFF] ^ t[5][(three >> 16) & 0xFF] ^ t[4][three >> 24]
+                    ^ t[3][four & 0xFF] ^ t[2][(four >> 8) & 0xFF] ^ t[1][(four >> 16) & 0xFF] ^ t[0][four >> 24];
+            }
+            else
+            {
+                const quint32 one = qFromBigEndian<quint32>(p) ^ crc;
+                const quint32 two = qFromBigEndian<quint32>(p + 4);
+                const quint32 three = qFromBigEndian<quint32>(p + 8);
+                const quint32 four = qFromBigEndian<quint32>(p + 12);
+                crc = t[15][one >> 24] ^ t[14][(one >> 16) & 0xFF] ^ t[13][(one >> 8) & 0xFF] ^ t[12][one & 0xFF]
+                    ^ t[11][two >> 24] ^ t[10][(two >> 16) & 0xFF] ^ t[9][(two >> 8) & 0xFF] ^ t[8][two & 0xFF]
+                    ^ t[7][three >> 24] ^ t[6][(three >> 16) & 0xFF] ^ t[5][(three >> 8) & 0xFF] ^ t[4][three & 0xFF]
+                    ^ t[3][four >> 24] ^ t[2][(four >> 16) & 0xFF] ^ t[1][(four >> 8) & 0xFF] ^ t[0][four & 0xFF];
+            }
+            p += 16;
+        }
+        return crc;
+    }
+
+    // 输出处理：RefIn与RefOut不一致时反转寄存器，再与XorOut异或
+    static constexpr value_type finalize(value_type crc)
+    {
+        return ((Spec::refIn != Spec::refOut) ? CrcReflect<value_type>(crc, Spec::width) : crc) ^ Spec::xorOut;
+    }
+
+    // 编译期生成的256项查找表
+    static constexpr Table table = CrcMakeTable<Spec>();
+    // 编译期生成的无进位乘法折叠常数
+    static constexpr CrcClmul::Constants clmulConstants = CrcClmul::constants(Spec::poly, Spec::width, Spec::refIn);
+
+private:
+    // 宽度为8时移位8位结果为0，避免对quint8做超宽移位
+    static constexpr value_type shiftRight8(value_type crc)
+    {
+        return Spec::width > 8 ? value_type(crc >> 8) : value_type(0);
+    }
+    static constexpr value_type shiftLeft8(value_type crc)
+    {
+        return Spec::width > 8 ? value_type(crc << 8) : value_type(0);
+    }
+};
+
+/*********************************************************************************
+** 常用CRC算法，参数与CRC参数模型一致，check为"123456789"的校验值
+**********************************************************************************/
+// CRC-8                x8+x2+x+1                  check: 0xF4
+typedef CrcEngine<CrcSpec<quint8, 8, 0x07, 0x00, false, false, 0x00>> Crc8;
+// CRC-8/ITU            x8+x2+x+1                  check: 0xA1
+typedef CrcEngine<CrcSpec<quint8, 8, 0x07, 0x00, false, false, 0x55>> Crc8Itu;
+// CRC-8/ROHC           x8+x2+x+1                  check: 0xD0
+typedef CrcEngine<CrcSpec<quint8, 8, 0x07, 0xFF, true, true, 0x00>> Crc8Rohc;
+// CRC-8/MAXIM          x8+x5+x4+1                 check: 0xA1
+typedef CrcEngine<CrcSpec<quint8, 8, 0x31, 0x00, true, true, 0x00>> Crc8Maxim;
+
+// CRC-16/CCITT         x16+x12+x5+1               check: 0x2189
+typedef CrcEngine<CrcSpec<quint16, 16, 0x1021, 0x0000, true, true, 0x0000>> Crc16CcittTrue;
+// CRC-16/CCITT-FALSE   x16+x12+x5+1               check: 0x29B1
+typedef CrcEngine<CrcSpec<quint16, 16, 0x1021, 0xFFFF, false, false, 0x0000>> Crc16CcittFalse;
+// CRC-16/XMODEM        x16+x12+x5+1               check: 0x31C3
+typedef CrcEngine<CrcSpec<quint16, 16, 0x1021, 0x0000, false, false, 0x0000>> Crc16Xmodem;
+// CRC-16/X25           x16+x12+x5+1               check: 0x906E
+typedef CrcEngine<CrcSpec<quint16, 16, 0x1021, 0xFFFF, true, true, 0xFFFF>> Crc16X25;
+// CRC-16/MODBUS        x16+x15+x2+1               check: 0x4B37
+typedef CrcEngine<CrcSpec<quint16, 16, 0x8005, 0xFFFF, true, true, 0x0000>> Crc16Modbus;
+// CRC-16/IBM           x16+x15+x2+1               check: 0xBB3D
+typedef CrcEngine<CrcSpec<quint16, 16, 0x8005, 0x0000, true, true, 0x0000>> Crc16Ibm;
+// CRC-16/MAXIM         x16+x15+x2+1               check: 0x44C2
+typedef CrcEngine<CrcSpec<quint16, 16, 0x8005, 0x0000, true, true, 0xFFFF>> Crc16Maxim;
+// CRC-16/USB           x16+x15+x2+1               check: 0xB4C8
+typedef CrcEngine<CrcSpec<quint16, 16, 0x8005, 0xFFFF, true, true, 0xFFFF>> Crc16Usb;
+// CRC-16/DNP           x16+x13+x12+x11+x10+x8+x6+x5+x2+1   check: 0xEA82
+typedef CrcEngine<CrcSpec<quint16, 16, 0x3D65, 0x0000, true, true, 0xFFFF>> Crc16Dnp;
+
+// CRC-32               x32+x26+x23+x22+x16+x12+x11+x10+x8+x7+x5+x4+x2+x+1   check: 0xCBF43926
+typedef CrcEngine<CrcSpec<quint32, 32, 0x04C11DB7, 0xFFFFFFFF, true, true, 0xFFFFFFFF>> Crc32WinRar;
+// CRC-32/MPEG-2        x32+x26+x23+x22+x16+x12+x11+x10+x8+x7+x5+x4+x2+x+1   check: 0x0376E6E7
+typedef CrcEngine<CrcSpec<quint32, 32, 0x04C11DB7, 0xFFFFFFFF, false, false, 0x00000000>> Crc32Mpeg;
+
+#endif // CRCENGINE_H
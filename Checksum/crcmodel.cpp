@@ -0,0 +1,117 @@
+#include "crcmodel.h"
+#include "crccombine.h"
+
+CrcModel::CrcModel(const CrcParams &params)
+    : p(params)
+{
+    Q_ASSERT(p.isValid());
+    p.poly &= p.mask();
+    p.init &= p.mask();
+    p.xorOut &= p.mask();
+
+    if(p.refIn)
+    {
+        const quint64 refPoly = CrcCombine::reflect(p.poly, p.width);
+        for(auto i = 0; i < 256; ++i)
+        {
+            quint64 crc = quint64(i);
+            for(auto j = 0; j < 8; ++j)
+                crc = (crc & 1) ? (crc >> 1) ^ refPoly : crc >> 1;
+            table[i] = crc;
+        }
+    }
+    else
+    {
+        // 多项式左对齐到第63位，与寄存器的存放方式一致
+        const quint64 topPoly = p.poly << (64 - p.width);
+        for(auto i = 0; i < 256; ++i)
+        {
+            quint64 crc = quint64(i) << 56;
+            for(auto j = 0; j < 8; ++j)
+                crc = (crc >> 63) ? (crc << 1) ^ topPoly : crc << 1;
+            table[i] = crc;
+        }
+    }
+}
+
+CrcModel::state_type CrcModel::initial() const
+{
+    return p.refIn ? CrcCombine::reflect(p.init, p.width) : p.init << (64 - p.width);
+}
+
+CrcModel::state_type CrcModel::update(state_type crc, const char *data, qint64 dataLen) const
+{
+    const uchar *d = reinterpret_cast<const uchar*>(data);
+    if(p.refIn)
+    {
+        while (dataLen--)
+            crc = table[(crc ^ *d++) & 0xFF] ^ (crc >> 8);
+    }
+    else
+    {
+        while (dataLen--)
+            crc = table[(crc >> 56) ^ *d++] ^ (crc << 8);
+    }
+    return crc;
+}
+
+CrcModel::state_type CrcModel::combine(state_type crc, state_type tail, qint64 tailLen) const
+{
+    if(p.refIn)
+        return CrcCombine::shift(crc, tailLen, p.poly, p.width, true) ^ tail;
+    const int align = 64 - p.width;
+    return (CrcCombine::shift(crc >> align, tailLen, p.poly, p.width, false) << align) ^ tail;
+}
+
+CrcModel::value_type CrcModel::finalize(state_type crc) const
+{
+    if(!p.refIn)
+        crc >>= 64 - p.width;
+    if(p.refIn != p.refOut)
+        crc = CrcCombine::reflect(crc, p.width);
+    return (crc ^ p.xorOut) & p.mask();
+}
+
+CrcModel::value_type CrcModel::computeSegments(const ChecksumSegment *segments, int count) const
+{
+    state_type crc = initial();
+    for(auto i = 0; i < count; ++i)
+    {
+        if(segments[i].size > 0)
+            crc = update(crc, segments[i].data, segments[i].size);
+    }
+    return finalize(crc);
+}
+
+CrcModel::value_type CrcModel::patch(value_type crc, qint64 dataLen, qint64 offset, const char *delta, qint64 deltaLen) const
+{
+    Q_ASSERT(offset >= 0 && deltaLen >= 0 && offset + deltaLen <= dataLen);
+    const state_type diff = combine(update(empty(), delta, deltaLen), empty(), dataLen - offset - deltaLen);
+    return crc ^ finalize(diff) ^ p.xorOut;
+}
+
+QSharedPointer<const CrcModel> CrcModelCache::get(const CrcParams &params)
+{
+    if(!params.isValid())
+        return QSharedPointer<const CrcModel>();
+
+    static CrcModelCache cache;
+    QMutexLocker locker(&cache.mutex);
+    auto it = cache.models.constFind(params);
+    if(it != cache.models.constEnd())
+    {
+        // 移到最近使用的位置
+        const int index = cache.order.indexOf(params);
+        if(index > 0)
+            cache.order.move(index, 0);
+        return it.value();
+    }
+
+    QSharedPointer<const CrcModel> model(new CrcModel(params));
+    cache.models.insert(params, model);
+    cache.order.prepend(params);
+    // 淘汰最久未使用的模型，仍被调用方持有的模型在最后一个引用释放时销毁
+    while (cache.order.size() > Capacity)
+        cache.models.remove(cache.order.takeLast());
+    return model;
+}
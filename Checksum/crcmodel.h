@@ -0,0 +1,114 @@
+#ifndef CRCMODEL_H
+#define CRCMODEL_H
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QSharedPointer>
+#include "checksumcontext.h"
+
+/*********************************************************************************
+** 文件描述：       运行时参数化的CRC算法
+** 设计：          CrcEngine的参数在编译期确定，只能计算已登记的算法；CrcModel按运行时给出的
+**                Rocksoft模型参数（Width 1~64、Poly、Init、RefIn、RefOut、XorOut）生成256项
+**                查找表，同样每个字节一次查表，用于CRC参数配置表中的自定义算法。
+**                寄存器统一用64位保存：RefIn为true时为低width位的反转形式（右移），
+**                否则左对齐到最高位（左移），这样任意宽度（包括小于8位）都能按字节查表。
+**                生成查找表有一定开销，CrcModelCache按参数缓存最近使用的模型（LRU），
+**                切换算法时不重复生成；模型构造后只读，可在多个线程中共享。
+**********************************************************************************/
+
+struct CrcParams
+{
+    int width = 0;
+    quint64 poly = 0;
+    quint64 init = 0;
+    bool refIn = false;
+    bool refOut = false;
+    quint64 xorOut = 0;
+
+    bool isValid() const
+    {
+        return width >= 1 && width <= 64;
+    }
+
+    // 低width位全为1的掩码
+    quint64 mask() const
+    {
+        return width >= 64 ? ~quint64(0) : (quint64(1) << width) - 1;
+    }
+};
+
+inline bool operator==(const CrcParams &a, const CrcParams &b)
+{
+    return a.width == b.width && a.poly == b.poly && a.init == b.init
+            && a.refIn == b.refIn && a.refOut == b.refOut && a.xorOut == b.xorOut;
+}
+
+inline bool operator!=(const CrcParams &a, const CrcParams &b)
+{
+    return !(a == b);
+}
+
+inline uint qHash(const CrcParams &params, uint seed = 0)
+{
+    return qHash(params.poly, seed) ^ qHash(params.init ^ (params.xorOut << 1), seed)
+            ^ uint(params.width | (params.refIn << 8) | (params.refOut << 9));
+}
+
+class CrcModel
+{
+public:
+    typedef quint64 value_type;
+    typedef quint64 state_type;
+
+    explicit CrcModel(const CrcParams &params);
+
+    const CrcParams& params() const
+    {
+        return p;
+    }
+
+    // 一次性计算data的CRC校验码
+    value_type compute(const char *data, qint64 dataLen) const
+    {
+        return finalize(update(initial(), data, dataLen));
+    }
+
+    // 按顺序计算多个不连续数据段的校验码，与拼接后计算的结果相同
+    value_type computeSegments(const ChecksumSegment *segments, int count) const;
+
+    // 以下与CrcEngine的流式接口含义相同
+    state_type initial() const;
+    state_type empty() const
+    {
+        return 0;
+    }
+    state_type update(state_type crc, const char *data, qint64 dataLen) const;
+    state_type combine(state_type crc, state_type tail, qint64 tailLen) const;
+    value_type finalize(state_type crc) const;
+    // 增量更新，含义与CrcEngine::patch相同
+    value_type patch(value_type crc, qint64 dataLen, qint64 offset, const char *delta, qint64 deltaLen) const;
+
+private:
+    CrcParams p;
+    quint64 table[256];
+};
+
+class CrcModelCache
+{
+public:
+    // 缓存的模型个数上限
+    static constexpr int Capacity = 32;
+
+    // 取得params对应的模型，缓存中没有时生成；params无效时返回空指针
+    static QSharedPointer<const CrcModel> get(const CrcParams &params);
+
+private:
+    QMutex mutex;
+    QHash<CrcParams, QSharedPointer<const CrcModel>> models;
+    // 最近使用的在前
+    QList<CrcParams> order;
+};
+
+#endif // CRCMODEL_H
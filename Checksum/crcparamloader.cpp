@@ -0,0 +1,357 @@
+#include "crcparamloader.h"
+#include "xlsxreader.h"
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+namespace
+{
+    // 缓存文件头："CRCP"，格式版本变化时修改CacheVersion使旧缓存失效
+    constexpr quint32 CacheMagic = 0x43524350;
+    constexpr quint16 CacheVersion = 1;
+
+    const char *const SheetNames[] = { "CRC8", "CRC16", "CRC32" };
+
+    CrcParamSheet *sheetAt(CrcParamTables *tables, int index)
+    {
+        CrcParamSheet *sheets[] = { &tables->crc8, &tables->crc16, &tables->crc32 };
+        return sheets[index];
+    }
+
+    const CrcParamSheet &sheetAt(const CrcParamTables &tables, int index)
+    {
+        const CrcParamSheet *sheets[] = { &tables.crc8, &tables.crc16, &tables.crc32 };
+        return *sheets[index];
+    }
+
+    // 行补齐为相同列数，与Excel已用区域一致
+    void makeRectangular(CrcParamSheet &sheet)
+    {
+        int columns = 0;
+        for(const auto &row : qAsConst(sheet))
+            columns = qMax(columns, row.size());
+        for(auto &row : sheet)
+            row.resize(columns);
+    }
+
+    enum ParamColumn
+    {
+        NameColumn = 0,
+        WidthColumn,
+        PolyColumn,
+        InitColumn,
+        RefInColumn,
+        RefOutColumn,
+        XorOutColumn,
+        ParamColumnCount
+    };
+
+    // 按表头文字定位参数列，英文关键字优先，"多项式公式"列不是多项式的值
+    void findColumns(const QVector<QString> &header, int columns[ParamColumnCount])
+    {
+        for(auto i = 0; i < ParamColumnCount; ++i)
+            columns[i] = -1;
+        for(auto j = 0; j < header.size(); ++j)
+        {
+            const QString h = header.at(j).toUpper().remove(' ');
+            int column = -1;
+            if(h.contains(QLatin1String("REFIN")) || h.contains(QStringLiteral("输入反转")))
+                column = RefInColumn;
+            else if(h.contains(QLatin1String("REFOUT")) || h.contains(QStringLiteral("输出反转")))
+                column = RefOutColumn;
+            else if(h.contains(QLatin1String("XOROUT")) || h.contains(QStringLiteral("异或")))
+                column = XorOutColumn;
+            else if(h.contains(QLatin1String("INIT")) || h.contains(QStringLiteral("初始值")))
+                column = InitColumn;
+            else if(h.contains(QLatin1String("POLY")) || (h.contains(QStringLiteral("多项式")) && !h.contains(QStringLiteral("公式"))))
+                column = PolyColumn;
+            else if(h.contains(QLatin1String("WIDTH")) || h.contains(QStringLiteral("宽度")))
+                column = WidthColumn;
+            else if(h.contains(QLatin1String("NAME")) || h.contains(QStringLiteral("名称")) || h.contains(QStringLiteral("参数模型")))
+                column = NameColumn;
+            if(column >= 0 && columns[column] < 0)
+                columns[column] = j;
+        }
+        // 没有名称列时第一列为名称
+        if(columns[NameColumn] < 0)
+            columns[NameColumn] = 0;
+    }
+
+    // 十六进制参数值，可带0x前缀或h后缀
+    bool parseHex(QString text, quint64 *value)
+    {
+        text = text.trimmed();
+        if(text.startsWith(QLatin1String("0x"), Qt::CaseInsensitive))
+            text = text.mid(2);
+        else if(text.endsWith('h', Qt::CaseInsensitive))
+            text.chop(1);
+        bool ok = false;
+        *value = text.toULongLong(&ok, 16);
+        return ok;
+    }
+
+    bool parseBool(const QString &text, bool *value)
+    {
+        const QString t = text.trimmed().toUpper();
+        if(t == QLatin1String("TRUE") || t == QLatin1String("1") || t == QLatin1String("YES") || t == QStringLiteral("是"))
+            *value = true;
+        else if(t == QLatin1String("FALSE") || t == QLatin1String("0") || t == QLatin1String("NO") || t == QStringLiteral("否"))
+            *value = false;
+        else
+            return false;
+        return true;
+    }
+
+    bool readXlsx(const QString &fileName, CrcParamTables *tables, QString *errorString)
+    {
+        XlsxReader reader;
+        if(!reader.open(fileName))
+        {
+            if(errorString)
+                *errorString = reader.errorString();
+            return false;
+        }
+        const QStringList names = reader.sheetNames();
+        for(auto i = 0; i < 3; ++i)
+        {
+            const QString name = QLatin1String(SheetNames[i]);
+            if(!names.contains(name))
+            {
+                qInfo().noquote() << name << "Sheet页不存在!";
+                continue;
+            }
+            if(!reader.readSheet(name, sheetAt(tables, i)))
+            {
+                if(errorString)
+                    *errorString = reader.errorString();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 解析一行CSV，支持双引号包围的字段和""转义；字段内含换行时继续读取下一行
+    QVector<QString> parseCsvRecord(const QStringList &lines, int *lineNo)
+    {
+        QVector<QString> fields;
+        QString field;
+        bool quoted = false;
+        QString line = lines.at((*lineNo)++);
+        for(auto i = 0; ; ++i)
+        {
+            if(i == line.size())
+            {
+                if(quoted && *lineNo < lines.size())
+                {
+                    field += '\n';
+                    line = lines.at((*lineNo)++);
+                    i = -1;
+                    continue;
+                }
+                break;
+            }
+            const QChar c = line.at(i);
+            if(quoted)
+            {
+                if(c == '"' && i + 1 < line.size() && line.at(i + 1) == '"')
+                {
+                    field += '"';
+                    ++i;
+                }
+                else if(c == '"')
+                    quoted = false;
+                else
+                    field += c;
+            }
+            else if(c == '"')
+                quoted = true;
+            else if(c == ',')
+            {
+                fields.append(field);
+                field.clear();
+            }
+            else
+                field += c;
+        }
+        fields.append(field);
+        return fields;
+    }
+
+    bool readCsv(const QString &fileName, CrcParamTables *tables, QString *errorString)
+    {
+        QFile file(fileName);
+        if(!file.open(QIODevice::ReadOnly))
+        {
+            if(errorString)
+                *errorString = file.errorString();
+            return false;
+        }
+        QString text = QString::fromUtf8(file.readAll());
+        if(text.startsWith(QChar(0xFEFF)))
+            text.remove(0, 1);
+        text.replace(QLatin1String("\r\n"), QLatin1String("\n"));
+        const QStringList lines = text.split('\n');
+
+        CrcParamSheet *sheet = nullptr;
+        int lineNo = 0;
+        while (lineNo < lines.size())
+        {
+            const QString trimmed = lines.at(lineNo).trimmed();
+            if(trimmed.startsWith('[') && trimmed.endsWith(']'))
+            {
+                sheet = nullptr;
+                const QString name = trimmed.mid(1, trimmed.size() - 2).trimmed();
+                for(auto i = 0; i < 3; ++i)
+                {
+                    if(name.compare(QLatin1String(SheetNames[i]), Qt::CaseInsensitive) == 0)
+                        sheet = sheetAt(tables, i);
+                }
+                ++lineNo;
+                continue;
+            }
+            if(trimmed.isEmpty() || sheet == nullptr)
+            {
+                ++lineNo;
+                continue;
+            }
+            sheet->append(parseCsvRecord(lines, &lineNo));
+        }
+        for(auto i = 0; i < 3; ++i)
+            makeRectangular(*sheetAt(tables, i));
+        return true;
+    }
+
+    bool readCache(const QString &cacheName, const QFileInfo &source, CrcParamTables *tables)
+    {
+        QFile file(cacheName);
+        if(!file.open(QIODevice::ReadOnly))
+            return false;
+        QDataStream in(&file);
+        in.setVersion(QDataStream::Qt_5_12);
+
+        quint32 magic = 0;
+        quint16 version = 0;
+        qint64 size = 0, modified = 0;
+        in >> magic >> version >> size >> modified;
+        if(magic != CacheMagic || version != CacheVersion
+                || size != source.size() || modified != source.lastModified().toMSecsSinceEpoch())
+            return false;
+
+        CrcParamTables loaded;
+        for(auto i = 0; i < 3; ++i)
+        {
+            quint32 rows = 0, columns = 0;
+            in >> rows >> columns;
+            // 参数表只有几十行，超出范围说明缓存已损坏
+            if(in.status() != QDataStream::Ok || rows > 0xFFFF || columns > 0xFF)
+                return false;
+            CrcParamSheet &sheet = *sheetAt(&loaded, i);
+            sheet.resize(int(rows));
+            for(auto &row : sheet)
+            {
+                row.resize(int(columns));
+                for(auto &cell : row)
+                    in >> cell;
+            }
+        }
+        if(in.status() != QDataStream::Ok)
+            return false;
+        *tables = loaded;
+        return true;
+    }
+
+    void writeCache(const QString &cacheName, const QFileInfo &source, const CrcParamTables &tables)
+    {
+        QSaveFile file(cacheName);
+        if(!file.open(QIODevice::WriteOnly))
+            return;
+        QDataStream out(&file);
+        out.setVersion(QDataStream::Qt_5_12);
+        out << CacheMagic << CacheVersion << qint64(source.size()) << qint64(source.lastModified().toMSecsSinceEpoch());
+        for(auto i = 0; i < 3; ++i)
+        {
+            const CrcParamSheet &sheet = sheetAt(tables, i);
+            const int columns = sheet.isEmpty() ? 0 : sheet.first().size();
+            out << quint32(sheet.size()) << quint32(columns);
+            for(const auto &row : sheet)
+            {
+                for(const auto &cell : row)
+                    out << cell;
+            }
+        }
+        file.commit();
+    }
+}
+
+bool CrcParamLoader::load(const QString &fileName, CrcParamTables *tables, QString *errorString)
+{
+    *tables = CrcParamTables();
+    const QFileInfo source(fileName);
+    if(!source.exists())
+    {
+        if(errorString)
+            *errorString = QStringLiteral("%1 文件不存在！").arg(fileName);
+        return false;
+    }
+
+    const QString cacheName = cacheFileName(fileName);
+    if(readCache(cacheName, source, tables))
+        return true;
+
+    const bool ok = source.suffix().compare(QLatin1String("csv"), Qt::CaseInsensitive) == 0
+            ? readCsv(fileName, tables, errorString)
+            : readXlsx(fileName, tables, errorString);
+    if(!ok)
+    {
+        *tables = CrcParamTables();
+        return false;
+    }
+    writeCache(cacheName, source, *tables);
+    return true;
+}
+
+bool CrcParamLoader::rowParams(const CrcParamSheet &sheet, int row, int defaultWidth, CrcParams *params, QString *name)
+{
+    if(row < 0 || row + 1 >= sheet.size())
+        return false;
+    int columns[ParamColumnCount];
+    findColumns(sheet.first(), columns);
+    if(columns[PolyColumn] < 0 || columns[RefInColumn] < 0 || columns[RefOutColumn] < 0)
+        return false;
+
+    const QVector<QString> &cells = sheet.at(row + 1);
+    auto cell = [&](int column) {
+        return columns[column] >= 0 ? cells.value(columns[column]) : QString();
+    };
+
+    CrcParams p;
+    p.width = defaultWidth;
+    if(columns[WidthColumn] >= 0)
+    {
+        bool ok = false;
+        p.width = cell(WidthColumn).trimmed().toInt(&ok);
+        if(!ok)
+            return false;
+    }
+    // 初始值、结果异或值为空时按0处理
+    if(!parseHex(cell(PolyColumn), &p.poly)
+            || (!cell(InitColumn).trimmed().isEmpty() && !parseHex(cell(InitColumn), &p.init))
+            || (!cell(XorOutColumn).trimmed().isEmpty() && !parseHex(cell(XorOutColumn), &p.xorOut))
+            || !parseBool(cell(RefInColumn), &p.refIn)
+            || !parseBool(cell(RefOutColumn), &p.refOut)
+            || !p.isValid())
+        return false;
+
+    *params = p;
+    if(name)
+        *name = cell(NameColumn).trimmed();
+    return true;
+}
+
+QString CrcParamLoader::cacheFileName(const QString &fileName)
+{
+    return fileName + QStringLiteral(".cache");
+}
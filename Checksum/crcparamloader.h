@@ -0,0 +1,40 @@
+#ifndef CRCPARAMLOADER_H
+#define CRCPARAMLOADER_H
+
+#include <QString>
+#include <QVector>
+#include "crcmodel.h"
+
+/*********************************************************************************
+** 文件描述：       CRC参数配置表加载
+** 设计：          CRC参数配置文件（config/data/CRC.xlsx）包含CRC8、CRC16、CRC32三个工作表，
+**                也可以使用等价的CSV文件：以[CRC8]、[CRC16]、[CRC32]单独一行开始各表。
+**                首次加载时解析源文件（.xlsx用XlsxReader，不依赖Excel），并在源文件旁写入
+**                二进制缓存（<源文件名>.cache），缓存中记录源文件的大小和修改时间；
+**                之后源文件未改动时直接读取缓存，不再解析xlsx。缓存不可写时只解析不缓存。
+**                每张表与Excel UsedRange.Value的结构相同：首行为表头，其余每行一个算法。
+**                rowParams()按表头（如"多项式POLY"、"RefIn"）定位各参数列，把一行转换为
+**                CrcParams，交给CrcModel计算表中的自定义算法。
+**********************************************************************************/
+
+typedef QVector<QVector<QString>> CrcParamSheet;
+
+struct CrcParamTables
+{
+    CrcParamSheet crc8;
+    CrcParamSheet crc16;
+    CrcParamSheet crc32;
+};
+
+namespace CrcParamLoader
+{
+    // 加载fileName（.xlsx或.csv）中的CRC参数表，源文件不存在或解析失败返回false
+    bool load(const QString &fileName, CrcParamTables *tables, QString *errorString = nullptr);
+    // fileName对应的缓存文件名
+    QString cacheFileName(const QString &fileName);
+    // 把sheet第row行（不含表头，从0开始）转换为CRC参数，表中没有宽度列时使用defaultWidth；
+    // name返回该行的算法名称，参数缺失或格式错误返回false
+    bool rowParams(const CrcParamSheet &sheet, int row, int defaultWidth, CrcParams *params, QString *name = nullptr);
+}
+
+#endif // CRCPARAMLOADER_H
@@ -0,0 +1,638 @@
+#include "crcreveng.h"
+#include "crccombine.h"
+#include "parallelchecksum.h"
+#include <QtAlgorithms>
+
+namespace
+{
+    // 求解时每个线程池任务处理的候选多项式个数
+    constexpr int CandidatesPerTask = 4096;
+    // 由因式组合出的候选多项式个数上限
+    constexpr int MaxCandidates = 1 << 20;
+    // 没有约束时允许逐个穷举多项式的最大宽度
+    constexpr int ExhaustiveMaxWidth = 16;
+    // Init有多个解时最多尝试的个数
+    constexpr int MaxInitSolutions = 256;
+
+    // GF(2)上的任意次数多项式，第i位为x^i的系数
+    class Gf2Poly
+    {
+    public:
+        bool isZero() const
+        {
+            return degree() < 0;
+        }
+
+        int degree() const
+        {
+            for(auto i = words.size() - 1; i >= 0; --i)
+            {
+                if(words[i])
+                    return i * 64 + 63 - qCountLeadingZeroBits(words[i]);
+            }
+            return -1;
+        }
+
+        bool bit(int i) const
+        {
+            return (i >> 6) < words.size() && ((words[i >> 6] >> (i & 63)) & 1);
+        }
+
+        // 加上value·x^shift
+        void addValue(quint64 value, int shift)
+        {
+            for(auto i = 0; i < 64; ++i)
+            {
+                if((value >> i) & 1)
+                    flip(shift + i);
+            }
+        }
+
+        // 加上o·x^shift
+        void addShifted(const Gf2Poly &o, int shift)
+        {
+            const int deg = o.degree();
+            if(deg < 0)
+                return;
+            reserveBits(deg + shift + 1);
+            const int wordShift = shift >> 6;
+            const int bitShift = shift & 63;
+            for(auto i = 0; i < o.words.size(); ++i)
+            {
+                const quint64 w = o.words[i];
+                if(!w)
+                    continue;
+                words[i + wordShift] ^= w << bitShift;
+                if(bitShift && i + wordShift + 1 < words.size())
+                    words[i + wordShift + 1] ^= w >> (64 - bitShift);
+            }
+        }
+
+        void add(const Gf2Poly &o)
+        {
+            addShifted(o, 0);
+        }
+
+        Gf2Poly mod(const Gf2Poly &d) const
+        {
+            return divide(d, nullptr);
+        }
+
+        // 带余除法，quotient非空时返回商
+        Gf2Poly divide(const Gf2Poly &d, Gf2Poly *quotient) const
+        {
+            Gf2Poly r = *this;
+            const int dd = d.degree();
+            Q_ASSERT(dd >= 0);
+            if(quotient)
+                *quotient = Gf2Poly();
+            for(int k = r.degree(); k >= dd; k = r.degree())
+            {
+                r.addShifted(d, k - dd);
+                if(quotient)
+                    quotient->flip(k - dd);
+            }
+            return r;
+        }
+
+        Gf2Poly multiply(const Gf2Poly &o) const
+        {
+            Gf2Poly r;
+            for(int i = o.degree(); i >= 0; --i)
+            {
+                if(o.bit(i))
+                    r.addShifted(*this, i);
+            }
+            return r;
+        }
+
+        // a·b mod m，a、b的次数都小于m
+        static Gf2Poly mulMod(const Gf2Poly &a, const Gf2Poly &b, const Gf2Poly &m)
+        {
+            Gf2Poly r;
+            const int dm = m.degree();
+            for(int i = b.degree(); i >= 0; --i)
+            {
+                r.shiftUp();
+                if(r.bit(dm))
+                    r.add(m);
+                if(b.bit(i))
+                    r.add(a);
+            }
+            return r;
+        }
+
+        static Gf2Poly gcd(Gf2Poly a, Gf2Poly b)
+        {
+            while (!b.isZero())
+            {
+                Gf2Poly r = a.mod(b);
+                a = b;
+                b = r;
+            }
+            return a;
+        }
+
+        // 低64位
+        quint64 low() const
+        {
+            return words.isEmpty() ? 0 : words[0];
+        }
+
+        const QVector<quint64>& data() const
+        {
+            return words;
+        }
+
+        static Gf2Poly monomial(int i)
+        {
+            Gf2Poly r;
+            r.flip(i);
+            return r;
+        }
+
+    private:
+        // 乘以x
+        void shiftUp()
+        {
+            if(words.isEmpty())
+                return;
+            if(words.last() >> 63)
+                words.append(0);
+            for(auto i = words.size() - 1; i > 0; --i)
+                words[i] = (words[i] << 1) | (words[i - 1] >> 63);
+            words[0] <<= 1;
+        }
+
+        void reserveBits(int bits)
+        {
+            const int n = (bits + 63) / 64;
+            if(words.size() < n)
+                words.resize(n);
+        }
+
+        void flip(int i)
+        {
+            reserveBits(i + 1);
+            words[i >> 6] ^= quint64(1) << (i & 63);
+        }
+
+        QVector<quint64> words;
+    };
+
+    struct Sample
+    {
+        QByteArray message;
+        quint64 check;
+    };
+
+    // 数据M(x)·x^shift，第一个字节的最高位为最高次项；reflectBytes为true时先把每个字节位反转
+    Gf2Poly messagePoly(const QByteArray &message, bool reflectBytes, int shift)
+    {
+        Gf2Poly poly;
+        const int n = message.size();
+        for(auto k = 0; k < n; ++k)
+        {
+            quint8 byte = quint8(message.at(k));
+            if(reflectBytes)
+                byte = quint8(CrcCombine::reflect(byte, 8));
+            poly.addValue(byte, 8 * (n - 1 - k) + shift);
+        }
+        return poly;
+    }
+
+    struct Factor
+    {
+        Gf2Poly poly;
+        int degree;
+        int multiplicity;
+    };
+
+    // 等次数分解：h为若干个互不相同的d次不可约多项式之积，用迹映射随机分裂（Cantor–Zassenhaus）
+    void splitEqualDegree(const Gf2Poly &h, int d, quint64 *seed, QVector<Gf2Poly> *factors)
+    {
+        const int dh = h.degree();
+        if(dh == d)
+        {
+            factors->append(h);
+            return;
+        }
+        for(;;)
+        {
+            Gf2Poly a;
+            for(auto i = 0; i < dh; i += 64)
+            {
+                *seed ^= *seed << 13;
+                *seed ^= *seed >> 7;
+                *seed ^= *seed << 17;
+                a.addValue(dh - i >= 64 ? *seed : *seed & ((quint64(1) << (dh - i)) - 1), i);
+            }
+            // T(a) = a + a^2 + ... + a^(2^(d-1)) mod h，约有一半的因式整除T(a)
+            Gf2Poly t = a;
+            for(auto i = 1; i < d; ++i)
+            {
+                a = Gf2Poly::mulMod(a, a, h);
+                t.add(a);
+            }
+            const Gf2Poly f = Gf2Poly::gcd(h, t);
+            const int df = f.degree();
+            if(df > 0 && df < dh)
+            {
+                Gf2Poly rest;
+                h.divide(f, &rest);
+                splitEqualDegree(f, d, seed, factors);
+                splitEqualDegree(rest, d, seed, factors);
+                return;
+            }
+        }
+    }
+
+    // g中次数不超过maxDegree、常数项为1的不可约因式及其重数
+    QVector<Factor> smallFactors(const Gf2Poly &g, int maxDegree)
+    {
+        QVector<Factor> factors;
+        quint64 seed = 0x9E3779B97F4A7C15ULL;
+        Gf2Poly rest = g;
+        Gf2Poly xp = Gf2Poly::monomial(1).mod(rest);
+        // 逐次数分解：gcd(rest, x^(2^d) - x)为rest中全部d次不可约因式之积
+        for(auto d = 1; d <= maxDegree && rest.degree() >= d; ++d)
+        {
+            xp = Gf2Poly::mulMod(xp, xp, rest);
+            Gf2Poly t = xp;
+            t.addValue(2, 0);
+            const Gf2Poly h = Gf2Poly::gcd(rest, t);
+            if(h.degree() <= 0)
+                continue;
+            // 去掉这些因式的全部幂次，避免在d的倍数次时再次出现
+            for(Gf2Poly c = h; c.degree() > 0; c = Gf2Poly::gcd(rest, c))
+            {
+                Gf2Poly q;
+                rest.divide(c, &q);
+                rest = q;
+            }
+            if(rest.degree() > 0)
+                xp = xp.mod(rest);
+
+            QVector<Gf2Poly> irreducibles;
+            splitEqualDegree(h, d, &seed, &irreducibles);
+            for(const auto &f : qAsConst(irreducibles))
+            {
+                if(!f.bit(0))
+                    continue;
+                // 重数只需统计到maxDegree次为止
+                int multiplicity = 0;
+                Gf2Poly q = g;
+                while ((multiplicity + 1) * d <= maxDegree)
+                {
+                    Gf2Poly next;
+                    if(!q.divide(f, &next).isZero())
+                        break;
+                    q = next;
+                    ++multiplicity;
+                }
+                factors.append(Factor{f, d, multiplicity});
+            }
+        }
+        return factors;
+    }
+
+    // 枚举factors中各因式（不超过其重数）相乘得到的全部w次多项式
+    void combineFactors(const QVector<Factor> &factors, int index, const Gf2Poly &product, int w,
+                        QVector<quint64> *candidates)
+    {
+        const int degree = product.degree();
+        if(degree == w)
+        {
+            candidates->append(product.low() & ((quint64(1) << w) - 1));
+            return;
+        }
+        if(index == factors.size() || candidates->size() >= MaxCandidates)
+            return;
+        const Factor &f = factors[index];
+        Gf2Poly p = product;
+        for(auto k = 0; k <= f.multiplicity && degree + k * f.degree <= w; ++k)
+        {
+            combineFactors(factors, index + 1, p, w, candidates);
+            p = p.multiply(f.poly);
+        }
+    }
+
+    // 在GF(2)上解 Refl(Init·K mod P) = t，返回全部解（最多MaxInitSolutions个）
+    QVector<quint64> solveInit(quint64 k, quint64 t, quint64 poly, int w, bool refOut)
+    {
+        // 以各位单独为1时的像为列，消元时记录每个基向量由哪些列组合而成
+        quint64 value[64], combo[64];
+        bool has[64] = {};
+        QVector<quint64> kernel;
+        for(auto j = 0; j < w; ++j)
+        {
+            quint64 v = CrcCombine::mulMod(quint64(1) << j, k, poly, w);
+            if(refOut)
+                v = CrcCombine::reflect(v, w);
+            quint64 c = quint64(1) << j;
+            for(auto b = w - 1; b >= 0 && v; --b)
+            {
+                if(!((v >> b) & 1))
+                    continue;
+                if(!has[b])
+                {
+                    has[b] = true;
+                    value[b] = v;
+                    combo[b] = c;
+                    v = 0;
+                    c = 0;
+                    break;
+                }
+                v ^= value[b];
+                c ^= combo[b];
+            }
+            if(c)
+                kernel.append(c);
+        }
+
+        quint64 particular = 0;
+        for(auto b = w - 1; b >= 0; --b)
+        {
+            if(!((t >> b) & 1))
+                continue;
+            if(!has[b])
+                return QVector<quint64>();
+            t ^= value[b];
+            particular ^= combo[b];
+        }
+
+        // 特解加上核空间中的任意向量
+        QVector<quint64> solutions;
+        const int bits = qMin(kernel.size(), 8);
+        for(auto mask = 0; mask < (1 << bits) && solutions.size() < MaxInitSolutions; ++mask)
+        {
+            quint64 s = particular;
+            for(auto i = 0; i < bits; ++i)
+            {
+                if((mask >> i) & 1)
+                    s ^= kernel[i];
+            }
+            solutions.append(s);
+        }
+        return solutions;
+    }
+
+    class ComboSearch
+    {
+    public:
+        ComboSearch(const QVector<Sample> &samples, const CrcSearchOptions &options,
+                    bool refIn, bool refOut, bool bigEndian)
+            : samples(samples), options(options), w(options.width),
+              refIn(refIn), refOut(refOut), bigEndian(bigEndian)
+        {
+        }
+
+        // 返回false表示样本不足以搜索
+        bool run(QVector<CrcSearchResult> *results)
+        {
+            QVector<quint64> candidates;
+            if(options.polyKnown)
+                candidates.append(options.poly & mask());
+            else if(!candidatePolys(&candidates))
+                return false;
+
+            // 各候选多项式互不相关，分块并行求解Init、XorOut并验证
+            const int tasks = (candidates.size() + CandidatesPerTask - 1) / CandidatesPerTask;
+            QVector<QVector<CrcSearchResult>> found(tasks);
+            ParallelChecksum::forEachChunk(tasks, [&](int task) {
+                const int begin = task * CandidatesPerTask;
+                const int end = qMin(candidates.size(), begin + CandidatesPerTask);
+                for(auto i = begin; i < end && !cancelled(); ++i)
+                    solve(candidates[i], &found[task]);
+            });
+            for(const auto &list : qAsConst(found))
+            {
+                for(const auto &result : list)
+                {
+                    if(results->size() >= options.maxResults)
+                        return true;
+                    results->append(result);
+                }
+            }
+            return true;
+        }
+
+    private:
+        quint64 mask() const
+        {
+            return (quint64(1) << w) - 1;
+        }
+
+        quint64 refl(quint64 v) const
+        {
+            return refOut ? CrcCombine::reflect(v, w) : v;
+        }
+
+        bool cancelled() const
+        {
+            return options.cancel && options.cancel->loadRelaxed();
+        }
+
+        // 由样本构造约束多项式，求最大公因式后得到候选多项式
+        bool candidatePolys(QVector<quint64> *candidates)
+        {
+            QVector<Gf2Poly> constraints;
+            if(options.initKnown)
+            {
+                const quint64 init = options.init & mask();
+                const int n0 = samples[0].message.size();
+                const Gf2Poly m0 = messagePoly(samples[0].message, refIn, w);
+                if(options.xorOutKnown)
+                {
+                    for(const auto &s : samples)
+                    {
+                        Gf2Poly f = messagePoly(s.message, refIn, w);
+                        f.addValue(init, 8 * s.message.size());
+                        f.addValue(refl(s.check ^ (options.xorOut & mask())), 0);
+                        constraints.append(f);
+                    }
+                }
+                for(auto i = 1; i < samples.size(); ++i)
+                {
+                    Gf2Poly f = messagePoly(samples[i].message, refIn, w);
+                    f.add(m0);
+                    f.addValue(init, 8 * n0);
+                    f.addValue(init, 8 * samples[i].message.size());
+                    f.addValue(refl(samples[0].check ^ samples[i].check), 0);
+                    constraints.append(f);
+                }
+            }
+            else
+            {
+                // Init未知时只能用等长的两帧消去Init和XorOut
+                for(auto i = 0; i < samples.size(); ++i)
+                {
+                    for(auto j = i + 1; j < samples.size(); ++j)
+                    {
+                        if(samples[j].message.size() != samples[i].message.size())
+                            continue;
+                        Gf2Poly f = messagePoly(samples[i].message, refIn, w);
+                        f.add(messagePoly(samples[j].message, refIn, w));
+                        f.addValue(refl(samples[i].check ^ samples[j].check), 0);
+                        constraints.append(f);
+                        break;
+                    }
+                }
+            }
+
+            Gf2Poly g;
+            for(const auto &f : qAsConst(constraints))
+                g = Gf2Poly::gcd(f, g);
+
+            if(g.isZero())
+            {
+                // 没有可用的约束（或样本完全相同），只能逐个尝试
+                if(w > ExhaustiveMaxWidth)
+                    return false;
+                for(quint64 p = 1; p <= mask(); p += 2)
+                    candidates->append(p);
+                return true;
+            }
+
+            const int degG = g.degree();
+            if(degG < w)
+                return true;
+            if(degG == w)
+            {
+                candidates->append(g.low() & mask());
+                return true;
+            }
+
+            // P是G的w次因式，分解出G中不超过w次的不可约因式后组合
+            combineFactors(smallFactors(g, w), 0, Gf2Poly::monomial(0), w, candidates);
+            return true;
+        }
+
+        // 对多项式p求Init、XorOut，并逐帧验证
+        void solve(quint64 p, QVector<CrcSearchResult> *found) const
+        {
+            CrcParams params;
+            params.width = w;
+            params.poly = p;
+            params.refIn = refIn;
+            params.refOut = refOut;
+            // Init、XorOut为0时的输出，与真实输出之差只与Init、XorOut有关
+            const CrcModel zero(params);
+            QVector<quint64> z(samples.size());
+            for(auto i = 0; i < samples.size(); ++i)
+                z[i] = zero.compute(samples[i].message.constData(), samples[i].message.size());
+
+            const Sample &s0 = samples[0];
+            const quint64 k0 = CrcCombine::xPowMod(quint64(8) * quint64(s0.message.size()), p, w);
+            QVector<quint64> inits;
+            bool ambiguous = false;
+            if(options.initKnown)
+                inits.append(options.init & mask());
+            else
+            {
+                int other = -1;
+                for(auto i = 1; i < samples.size() && other < 0; ++i)
+                {
+                    if(samples[i].message.size() != s0.message.size())
+                        other = i;
+                }
+                if(other >= 0)
+                {
+                    // 不等长的两帧消去XorOut：Refl(Init·(x^(8n0) + x^(8n1)) mod P) = c0^c1^z0^z1
+                    const quint64 k1 = CrcCombine::xPowMod(quint64(8) * quint64(samples[other].message.size()), p, w);
+                    inits = solveInit(k0 ^ k1, s0.check ^ samples[other].check ^ z[0] ^ z[other], p, w, refOut);
+                }
+                else if(options.xorOutKnown)
+                    inits = solveInit(k0, s0.check ^ z[0] ^ (options.xorOut & mask()), p, w, refOut);
+                else
+                {
+                    inits.append(0);
+                    ambiguous = true;
+                }
+            }
+
+            for(const auto init : qAsConst(inits))
+            {
+                params.init = init;
+                params.xorOut = options.xorOutKnown ? (options.xorOut & mask())
+                                                    : s0.check ^ z[0] ^ refl(CrcCombine::mulMod(init, k0, p, w));
+                const CrcModel model(params);
+                bool ok = true;
+                for(auto i = 0; i < samples.size() && ok; ++i)
+                    ok = model.compute(samples[i].message.constData(), samples[i].message.size()) == samples[i].check;
+                if(ok)
+                    found->append(CrcSearchResult{params, bigEndian, ambiguous});
+            }
+        }
+
+        const QVector<Sample> &samples;
+        const CrcSearchOptions &options;
+        const int w;
+        const bool refIn;
+        const bool refOut;
+        const bool bigEndian;
+    };
+}
+
+QVector<CrcSearchResult> CrcReveng::search(const QVector<QByteArray> &frames, const CrcSearchOptions &options,
+                                           QString *errorString)
+{
+    QVector<CrcSearchResult> results;
+    const int w = options.width;
+    const int bytes = w / 8;
+    if(w < 8 || w > 32 || w % 8 != 0)
+    {
+        if(errorString)
+            *errorString = QStringLiteral("校验码宽度只能为8、16、24、32位");
+        return results;
+    }
+    if(frames.isEmpty())
+    {
+        if(errorString)
+            *errorString = QStringLiteral("没有样本帧");
+        return results;
+    }
+    for(const auto &frame : frames)
+    {
+        if(frame.size() <= bytes)
+        {
+            if(errorString)
+                *errorString = QStringLiteral("样本帧长度必须大于校验码字节数");
+            return results;
+        }
+    }
+
+    bool enough = true;
+    // 8位校验码没有字节序之分
+    for(auto bigEndian : { true, false })
+    {
+        if(!bigEndian && bytes == 1)
+            break;
+        QVector<Sample> samples;
+        for(const auto &frame : frames)
+        {
+            const int n = frame.size() - bytes;
+            quint64 check = 0;
+            for(auto i = 0; i < bytes; ++i)
+            {
+                const quint64 b = quint8(frame.at(n + i));
+                check |= bigEndian ? b << (8 * (bytes - 1 - i)) : b << (8 * i);
+            }
+            samples.append(Sample{frame.left(n), check});
+        }
+        for(auto refIn : { false, true })
+        {
+            for(auto refOut : { false, true })
+            {
+                if(results.size() >= options.maxResults
+                        || (options.cancel && options.cancel->loadRelaxed()))
+                    return results;
+                ComboSearch search(samples, options, refIn, refOut, bigEndian);
+                enough = search.run(&results) && enough;
+            }
+        }
+    }
+    if(!enough && results.isEmpty() && errorString)
+        *errorString = QStringLiteral("%1位CRC需要至少两帧长度相同的样本，或给出已知的Init").arg(w);
+    return results;
+}
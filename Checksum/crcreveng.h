@@ -0,0 +1,56 @@
+#ifndef CRCREVENG_H
+#define CRCREVENG_H
+
+#include <QAtomicInt>
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include "crcmodel.h"
+
+/*********************************************************************************
+** 文件描述：       由样本帧反推CRC参数
+** 设计：          每个样本帧为"数据+校验码"，校验码在帧尾，宽度为8/16/24/32位，按大端或小端存放。
+**                在不反转的形式下（RefIn为true时先把每个字节位反转），寄存器满足
+**                    R = Init·x^(8n) + M(x)·x^w  (mod P)，输出 = Refl(R) ^ XorOut
+**                因此等长两帧的异或消去了Init和XorOut：P整除 ΔM(x)·x^w + Refl⁻¹(Δcrc)；
+**                Init已知时任意两帧都可以消去XorOut，Init、XorOut都已知时单帧即可。
+**                所有约束多项式的最大公因式G包含了P，只需枚举G的w次因式（与CRC RevEng相同）：
+**                G的次数等于w时直接得到P，否则在GF(2)上分解G（逐次数分解+Cantor–Zassenhaus），
+**                只求不超过w次的不可约因式，再组合出全部w次的候选多项式。
+**                确定P后，Init由不同长度的两帧（或已知XorOut的单帧）解GF(2)线性方程组得到，
+**                再求出XorOut，最后用CrcModel逐帧验证；各候选多项式在全局线程池中并行求解。
+**                没有任何约束（帧长度都不同且Init未知）时，16位以下逐个多项式穷举，32位需要
+**                至少两帧等长的样本或给出Init。
+**********************************************************************************/
+
+struct CrcSearchOptions
+{
+    int width = 16;             // 校验码位数：8、16、24、32
+    // 已知的参数，不知道时保持false
+    bool polyKnown = false;
+    quint64 poly = 0;
+    bool initKnown = false;
+    quint64 init = 0;
+    bool xorOutKnown = false;
+    quint64 xorOut = 0;
+    // 最多返回的结果个数
+    int maxResults = 64;
+    // 非空且置为非0时尽快结束搜索
+    const QAtomicInt *cancel = nullptr;
+};
+
+struct CrcSearchResult
+{
+    CrcParams params;
+    bool bigEndian;             // 帧尾校验码按大端存放
+    bool initAmbiguous;         // 样本帧长度都相同，Init不能确定（取0，XorOut与之对应）
+};
+
+namespace CrcReveng
+{
+    // 搜索与所有样本帧一致的CRC参数，参数非法或样本不足时返回空并给出原因
+    QVector<CrcSearchResult> search(const QVector<QByteArray> &frames, const CrcSearchOptions &options,
+                                    QString *errorString = nullptr);
+}
+
+#endif // CRCREVENG_H
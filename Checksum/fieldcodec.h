@@ -0,0 +1,168 @@
+#ifndef FIELDCODEC_H
+#define FIELDCODEC_H
+
+#include <QtGlobal>
+#include <QtEndian>
+#include <cstring>
+#include <type_traits>
+
+/*********************************************************************************
+** 文件描述：       数值字段与字节的编解码：8~64位有/无符号整数、float、double，按指定字节序读写
+** 设计：          字节序按4字节值0xAABBCCDD（A为最高字节）在内存中的排列命名：
+**                ABCD为大端，DCBA为小端，BADC为大端且每2字节内交换，CDAB为小端且每2字节内交换
+**                （即Modbus等设备常用的字交换格式）；8字节的值按同一规则推广。
+**                浮点数用memcpy按同宽度的无符号整数处理，不经过指针强制转换或QVariant，
+**                字节序是模板参数，编译期确定：encode/decode编译为一次读、一次bswap（及交换字节对的
+**                移位和掩码）、一次写，1字节的类型不做任何变换。
+**                运行时才确定字节序时（如界面上选择），调用以ByteOrder为参数的重载，在其中分派。
+**                不检查缓冲区长度，调用方保证有sizeof(T)个字节。
+** 用法：           FieldCodec::encode<float, FieldCodec::ABCD>(1.5f, out);
+**                qint16 v = FieldCodec::decode<qint16, FieldCodec::DCBA>(in);
+**********************************************************************************/
+
+namespace FieldCodec
+{
+    enum ByteOrder
+    {
+        ABCD = 0,       // 大端：高字节在前
+        DCBA,           // 小端：低字节在前
+        BADC,           // 大端，每2字节内交换
+        CDAB,           // 小端，每2字节内交换
+        BigEndian = ABCD,
+        LittleEndian = DCBA,
+    };
+
+    // 数据检验界面的数值类型，顺序与界面上整数类型下拉列表框一致
+    enum FieldType
+    {
+        Int8 = 0,
+        UInt8,
+        Int16,
+        UInt16,
+        Int32,
+        UInt32,
+        Int64,
+        UInt64,
+        Float,
+        Double,
+    };
+
+    // 各类型的字节数
+    inline int fieldSize(FieldType type)
+    {
+        static const int sizes[] = { 1, 1, 2, 2, 4, 4, 8, 8, 4, 8 };
+        return sizes[type];
+    }
+
+    namespace Detail
+    {
+        // 与T同宽度的无符号整数
+        template<int Size> struct UnsignedOf;
+        template<> struct UnsignedOf<1> { typedef quint8 type; };
+        template<> struct UnsignedOf<2> { typedef quint16 type; };
+        template<> struct UnsignedOf<4> { typedef quint32 type; };
+        template<> struct UnsignedOf<8> { typedef quint64 type; };
+
+        template<typename T>
+        using Bits = typename UnsignedOf<int(sizeof(T))>::type;
+
+        // 每2字节中低字节为0xFF的掩码，如quint32为0x00FF00FF
+        template<typename U>
+        constexpr U lowByteMask()
+        {
+            return U(U(~U(0)) / U(0xFFFF) * U(0x00FF));
+        }
+
+        // 交换每2字节内的高低字节，U至少2字节
+        template<typename U>
+        constexpr U swapBytePairs(U x)
+        {
+            return U(((x & lowByteMask<U>()) << 8) | ((x >> 8) & lowByteMask<U>()));
+        }
+
+        // 把值的各位按Order重排：重排后按小端存储即得到Order的字节排列。
+        // 各种重排都是自身的逆变换，解码时对按小端读出的值再做一次即可
+        template<ByteOrder Order, typename U>
+        Q_ALWAYS_INLINE U toStorage(U x)
+        {
+            if constexpr (sizeof(U) == 1)
+                return x;
+            else
+            {
+                switch (Order)
+                {
+                case ABCD:
+                    return qbswap(x);
+                case BADC:
+                    return qbswap(swapBytePairs(x));
+                case CDAB:
+                    return swapBytePairs(x);
+                default:
+                    return x;
+                }
+            }
+        }
+    }
+
+    // 把value按Order写入out的sizeof(T)个字节
+    template<typename T, ByteOrder Order>
+    Q_ALWAYS_INLINE void encode(T value, uchar *out)
+    {
+        static_assert(std::is_arithmetic<T>::value, "FieldCodec only encodes integers and floating point numbers");
+        typedef Detail::Bits<T> U;
+        U bits;
+        memcpy(&bits, &value, sizeof(T));
+        qToLittleEndian(Detail::toStorage<Order>(bits), out);
+    }
+
+    // 从in的sizeof(T)个字节按Order读出值
+    template<typename T, ByteOrder Order>
+    Q_ALWAYS_INLINE T decode(const uchar *in)
+    {
+        static_assert(std::is_arithmetic<T>::value, "FieldCodec only decodes integers and floating point numbers");
+        typedef Detail::Bits<T> U;
+        const U bits = Detail::toStorage<Order>(qFromLittleEndian<U>(in));
+        T value;
+        memcpy(&value, &bits, sizeof(T));
+        return value;
+    }
+
+    // 运行时选择字节序
+    template<typename T>
+    inline void encode(T value, ByteOrder order, uchar *out)
+    {
+        switch (order)
+        {
+        case ABCD:
+            encode<T, ABCD>(value, out);
+            break;
+        case BADC:
+            encode<T, BADC>(value, out);
+            break;
+        case CDAB:
+            encode<T, CDAB>(value, out);
+            break;
+        default:
+            encode<T, DCBA>(value, out);
+            break;
+        }
+    }
+
+    template<typename T>
+    inline T decode(const uchar *in, ByteOrder order)
+    {
+        switch (order)
+        {
+        case ABCD:
+            return decode<T, ABCD>(in);
+        case BADC:
+            return decode<T, BADC>(in);
+        case CDAB:
+            return decode<T, CDAB>(in);
+        default:
+            return decode<T, DCBA>(in);
+        }
+    }
+}
+
+#endif // FIELDCODEC_H
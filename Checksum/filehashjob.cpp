@@ -0,0 +1,154 @@
+#include "filehashjob.h"
+#include "checkalgorithm.h"
+#include "crcmodel.h"
+#include "parallelchecksum.h"
+#include <QFile>
+#include <QtConcurrent>
+
+FileHashJob::FileHashJob(QObject *parent)
+    : QObject(parent)
+{
+}
+
+FileHashJob::~FileHashJob()
+{
+    cancel();
+    future.waitForFinished();
+}
+
+bool FileHashJob::isRunning() const
+{
+    return running.loadAcquire() != 0;
+}
+
+bool FileHashJob::start(const QString &fileName, HashContext::Algorithm algorithm, const Filter &filter)
+{
+    return startRun([this, fileName, algorithm, filter]() {
+        run(fileName, algorithm, filter);
+    });
+}
+
+bool FileHashJob::start(const QString &fileName, const CheckAlgorithm *algorithm)
+{
+    const CheckAlgorithm::ComputeFileFunc computeFile = algorithm->computeFile;
+    const int bytes = algorithm->bytes();
+    return startRun([this, fileName, computeFile, bytes]() {
+        runChecksum(fileName, computeFile, bytes);
+    });
+}
+
+bool FileHashJob::start(const QString &fileName, const QSharedPointer<const CrcModel> &model)
+{
+    // 模型由共享指针持有到计算结束
+    const ComputeFile computeFile = [model](QFile &file, quint64 *result, QString *errorString,
+                                            const ParallelChecksum::Progress &progress) {
+        return ParallelChecksumFile(*model, file, result, errorString, progress);
+    };
+    const int bytes = (model->params().width + 7) / 8;
+    return startRun([this, fileName, computeFile, bytes]() {
+        runChecksum(fileName, computeFile, bytes);
+    });
+}
+
+bool FileHashJob::startRun(const std::function<void()> &func)
+{
+    if(!running.testAndSetAcquire(0, 1))
+        return false;
+    // 上一次计算已发出结束信号，等待其线程函数返回
+    future.waitForFinished();
+    cancelRequested.storeRelaxed(0);
+    future = QtConcurrent::run(func);
+    return true;
+}
+
+void FileHashJob::cancel()
+{
+    cancelRequested.storeRelaxed(1);
+}
+
+void FileHashJob::run(const QString &fileName, HashContext::Algorithm algorithm, const Filter &filter)
+{
+    QFile file(fileName);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        const QString errorString = file.errorString();
+        running.storeRelease(0);
+        emit failed(errorString);
+        return;
+    }
+
+    HashContext context(algorithm);
+    const qint64 total = file.size();
+    qint64 done = 0;
+    QByteArray filtered;
+    QString errorString;
+    // 取消后余下的窗口只映射不访问，很快遍历完
+    const bool ok = ParallelChecksum::forEachWindow(file, [&](const char *data, qint64 dataLen) {
+        for(qint64 offset = 0; offset < dataLen; offset += StepSize)
+        {
+            if(cancelRequested.loadRelaxed())
+                return;
+            const qint64 len = qMin(StepSize, dataLen - offset);
+            if(filter)
+            {
+                filtered.resize(0);
+                filter(data + offset, len, &filtered);
+                context.update(filtered.constData(), filtered.size());
+            }
+            else
+                context.update(data + offset, len);
+            done += len;
+            emit progress(done, total);
+        }
+    }, &errorString);
+    if(ok && filter && !cancelRequested.loadRelaxed())
+    {
+        filtered.resize(0);
+        filter(nullptr, 0, &filtered);
+        context.update(filtered.constData(), filtered.size());
+    }
+
+    running.storeRelease(0);
+    if(cancelRequested.loadRelaxed())
+        emit canceled();
+    else if(!ok)
+        emit failed(errorString);
+    else
+        emit finished(context.finalize());
+}
+
+void FileHashJob::runChecksum(const QString &fileName, const ComputeFile &compute, int bytes)
+{
+    QFile file(fileName);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        const QString errorString = file.errorString();
+        running.storeRelease(0);
+        emit failed(errorString);
+        return;
+    }
+
+    const qint64 total = file.size();
+    quint64 code = 0;
+    QString errorString;
+    // 每段结束时报告进度，取消后停止，余下的窗口只映射不访问
+    const bool ok = compute(file, &code, &errorString, [this, total](qint64 bytesDone) {
+        if(cancelRequested.loadRelaxed())
+            return false;
+        emit progress(bytesDone, total);
+        return true;
+    });
+
+    running.storeRelease(0);
+    if(cancelRequested.loadRelaxed())
+        emit canceled();
+    else if(!ok)
+        emit failed(errorString);
+    else
+    {
+        QByteArray digest(bytes, 0);
+        for(auto i = 0; i < bytes; ++i)
+            digest[bytes - 1 - i] = char(code >> (8 * i));
+        emit finished(digest);
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef FILEHASHJOB_H
+#define FILEHASHJOB_H
+
+#include <QAtomicInt>
+#include <QFuture>
+#include <QObject>
+#include <QSharedPointer>
+#include <functional>
+#include "hashcontext.h"
+#include "parallelchecksum.h"
+
+struct CheckAlgorithm;
+class CrcModel;
+
+/*********************************************************************************
+** 文件描述：       后台计算文件摘要
+** 设计：          start()把计算交给全局线程池后立即返回，界面线程不阻塞。文件按窗口映射到内存
+**                （不能映射时按大块读取，见ParallelChecksum::forEachWindow），窗口内再按StepSize
+**                分段输入HashContext，每段结束时检查取消请求并发出progress()，
+**                因此取消最多等待一段的计算时间，进度也能平滑更新。
+**                信号在工作线程中发出，接收者在界面线程时自动排队，槽函数中可直接操作控件。
+**                结束时只发出finished()、failed()、canceled()中的一个；发出前已结束运行状态，
+**                在槽函数中可以立即开始下一次计算。
+**                filter用于计算前转换数据（如把十六进制文本解码为字节），在工作线程中调用。
+**                以CheckAlgorithm或CrcModel为参数的start()计算文件的CRC/累加和：窗口内按
+**                ParallelChecksum::FileStepSize分段多线程计算（见parallelchecksum.h），每段结束时
+**                同样检查取消请求并发出progress()。
+**********************************************************************************/
+
+class FileHashJob : public QObject
+{
+    Q_OBJECT
+public:
+    // 每段输入的数据长度
+    static constexpr qint64 StepSize = qint64(4) << 20;
+
+    // 把文件中的一段数据转换为参与计算的字节，追加到out中；文件结束时再以dataLen为0调用一次，
+    // 输出转换过程中缓存的数据（如不成对的十六进制数字）
+    typedef std::function<void(const char *data, qint64 dataLen, QByteArray *out)> Filter;
+
+    explicit FileHashJob(QObject *parent = nullptr);
+    // 析构时取消正在进行的计算并等待其结束
+    ~FileHashJob() override;
+
+    bool isRunning() const;
+    // 在后台计算fileName的摘要，正在计算时返回false
+    bool start(const QString &fileName, HashContext::Algorithm algorithm, const Filter &filter = Filter());
+    // 在后台计算fileName的校验码，finished()给出按大端存放的algorithm->bytes()个字节
+    bool start(const QString &fileName, const CheckAlgorithm *algorithm);
+    // 用参数配置表中的自定义CRC模型计算，finished()给出按大端存放的(width + 7) / 8个字节
+    bool start(const QString &fileName, const QSharedPointer<const CrcModel> &model);
+    // 请求取消，当前一段计算完成后结束并发出canceled()
+    void cancel();
+
+signals:
+    // 已处理bytesDone字节，文件共bytesTotal字节
+    void progress(qint64 bytesDone, qint64 bytesTotal);
+    // 计算完成，digest为二进制摘要或校验码
+    void finished(const QByteArray &digest);
+    void failed(const QString &errorString);
+    void canceled();
+
+private:
+    bool startRun(const std::function<void()> &func);
+    void run(const QString &fileName, HashContext::Algorithm algorithm, const Filter &filter);
+    // 计算文件的校验码：compute为CheckAlgorithm::ComputeFileFunc或等价的函数，结果取低bytes个字节
+    typedef std::function<bool(QFile &file, quint64 *result, QString *errorString,
+                               const ParallelChecksum::Progress &progress)> ComputeFile;
+    void runChecksum(const QString &fileName, const ComputeFile &compute, int bytes);
+
+    QFuture<void> future;
+    QAtomicInt running;
+    QAtomicInt cancelRequested;
+};
+
+#endif // FILEHASHJOB_H
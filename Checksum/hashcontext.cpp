@@ -0,0 +1,101 @@
+#include "hashcontext.h"
+#include <limits>
+
+HashContext::HashContext(Algorithm algorithm)
+    : algorithm(algorithm)
+    , hash(toQt(algorithm))
+{
+}
+
+void HashContext::init()
+{
+    hash.reset();
+    xxh3.init();
+    blake3.init();
+}
+
+void HashContext::update(const char *data, qint64 dataLen)
+{
+    switch (algorithm)
+    {
+    case Xxh3_64:
+    case Xxh3_128:
+        xxh3.update(data, dataLen);
+        return;
+    case Blake3_256:
+        blake3.update(data, dataLen);
+        return;
+    default:
+        break;
+    }
+    // QCryptographicHash::addData的长度参数为int，按int范围分段输入
+    const qint64 maxChunk = std::numeric_limits<int>::max();
+    while (dataLen > 0)
+    {
+        const int len = int(qMin(dataLen, maxChunk));
+        hash.addData(data, len);
+        data += len;
+        dataLen -= len;
+    }
+}
+
+QByteArray HashContext::finalize() const
+{
+    switch (algorithm)
+    {
+    case Xxh3_64:
+        return Xxh3::canonical64(xxh3.digest64());
+    case Xxh3_128:
+    {
+        quint64 high;
+        const quint64 low = xxh3.digest128(&high);
+        return Xxh3::canonical128(high, low);
+    }
+    case Blake3_256:
+        return blake3.finalize();
+    default:
+        return hash.result();
+    }
+}
+
+QByteArray HashContext::compute(Algorithm algorithm, const char *data, qint64 dataLen)
+{
+    HashContext ctx(algorithm);
+    ctx.update(data, dataLen);
+    return ctx.finalize();
+}
+
+int HashContext::digestLength(Algorithm algorithm)
+{
+    switch (algorithm)
+    {
+    case Md5:
+        return 16;
+    case Sha1:
+        return 20;
+    case Sha256:
+        return 32;
+    case Xxh3_64:
+        return 8;
+    case Xxh3_128:
+        return 16;
+    case Blake3_256:
+        return Blake3::OutLen;
+    }
+    return 0;
+}
+
+QCryptographicHash::Algorithm HashContext::toQt(Algorithm algorithm)
+{
+    switch (algorithm)
+    {
+    case Sha1:
+        return QCryptographicHash::Sha1;
+    case Sha256:
+        return QCryptographicHash::Sha256;
+    // XXH3、BLAKE3不使用QCryptographicHash
+    case Md5:
+    default:
+        return QCryptographicHash::Md5;
+    }
+}
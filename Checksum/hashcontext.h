@@ -0,0 +1,53 @@
+#ifndef HASHCONTEXT_H
+#define HASHCONTEXT_H
+
+#include <QByteArray>
+#include <QCryptographicHash>
+#include "blake3.h"
+#include "xxh3.h"
+
+/*********************************************************************************
+** 文件描述：       流式摘要（Hash）计算上下文
+** 设计：          与ChecksumContext的用法一致：init()、update()、finalize()。MD5、SHA系列内部使用
+**                QCryptographicHash，update的数据长度为64位，超过int范围的数据分段输入；
+**                XXH3（非加密，校验大文件传输最快）和BLAKE3（加密，多线程树模式）由本库实现，
+**                摘要按各自官方规范的字节序输出，与常用命令行工具显示的结果一致。
+**                每个上下文对象只能在一个线程中使用，不同线程各自创建上下文即可并发计算。
+**********************************************************************************/
+class HashContext
+{
+public:
+    enum Algorithm
+    {
+        Md5 = 0,
+        Sha1,
+        Sha256,
+        Xxh3_64,
+        Xxh3_128,
+        Blake3_256,
+    };
+
+    explicit HashContext(Algorithm algorithm);
+
+    // 重新开始计算
+    void init();
+    // 输入一段数据
+    void update(const char *data, qint64 dataLen);
+    // 得到已输入数据的摘要（二进制）
+    QByteArray finalize() const;
+
+    // 一次性计算data的摘要
+    static QByteArray compute(Algorithm algorithm, const char *data, qint64 dataLen);
+    // 摘要的字节数
+    static int digestLength(Algorithm algorithm);
+
+private:
+    static QCryptographicHash::Algorithm toQt(Algorithm algorithm);
+
+    Algorithm algorithm;
+    QCryptographicHash hash;
+    Xxh3 xxh3;
+    Blake3 blake3;
+};
+
+#endif // HASHCONTEXT_H
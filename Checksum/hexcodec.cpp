@@ -0,0 +1,293 @@
+#include "hexcodec.h"
+#include "cpufeatures.h"
+
+#ifdef CPU_HAVE_X86_SIMD
+#  include <immintrin.h>
+#endif
+
+namespace
+{
+    const char UpperDigits[] = "0123456789ABCDEF";
+    const char LowerDigits[] = "0123456789abcdef";
+
+    // 字符的4位值；空白字符为Blank，其它字符为Invalid
+    constexpr int Blank = -1;
+    constexpr int Invalid = -2;
+
+    inline int charValue(ushort ch)
+    {
+        if(ch >= '0' && ch <= '9')
+            return ch - '0';
+        const ushort lower = ch | 0x20;
+        if(lower >= 'a' && lower <= 'f')
+            return lower - 'a' + 10;
+        if(ch == ' ' || (ch >= '\t' && ch <= '\r'))
+            return Blank;
+        return Invalid;
+    }
+
+    // 整块转换失败后至少逐字符处理的字符数，避免对不规则文本反复尝试
+    constexpr qint64 ScalarRun = 32;
+
+#ifdef CPU_HAVE_X86_SIMD
+    // 带空格格式每48个字符对应16个字节，48个字符分为3组，每组16个：
+    // 空格所在位置，以及各字节的高、低4位字符在每组中的位置（-1表示不在该组）
+    alignas(16) const qint8 SpaceMask[3][16] = {
+        { 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0 },
+        { 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0 },
+        { -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1 },
+    };
+    alignas(16) const qint8 DecodeHigh[3][16] = {
+        { 0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+        { -1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14, -1, -1, -1, -1, -1 },
+        { -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1, 4, 7, 10, 13 },
+    };
+    alignas(16) const qint8 DecodeLow[3][16] = {
+        { 1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+        { -1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1 },
+        { -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14 },
+    };
+    // 编码时每组各字符取自第几个字节的高、低4位字符
+    alignas(16) const qint8 EncodeHigh[3][16] = {
+        { 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1, 5 },
+        { -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10, -1 },
+        { -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1, -1 },
+    };
+    alignas(16) const qint8 EncodeLow[3][16] = {
+        { -1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1 },
+        { 5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10 },
+        { -1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1 },
+    };
+
+    inline __m128i loadTable(const qint8 *table)
+    {
+        return _mm_load_si128(reinterpret_cast<const __m128i*>(table));
+    }
+
+    // 16个UTF-16字符压缩为16个字节；大于255的字符饱和为0或255，都不是十六进制数字或空格
+    CPU_TARGET("sse4.1")
+    Q_ALWAYS_INLINE __m128i loadChars(const ushort *p)
+    {
+        return _mm_packus_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)),
+                                _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 8)));
+    }
+
+    // 16个字节零扩展为UTF-16写入out
+    CPU_TARGET("sse4.1")
+    Q_ALWAYS_INLINE void storeChars(ushort *out, __m128i c)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(c, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), _mm_unpackhi_epi8(c, zero));
+    }
+
+    // 16个ASCII字符的4位值，valid中合法的十六进制数字对应字节为0xFF
+    CPU_TARGET("sse4.1")
+    Q_ALWAYS_INLINE __m128i hexValues(__m128i c, __m128i *valid)
+    {
+        const __m128i digit = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+        const __m128i isDigit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+        const __m128i alpha = _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+        const __m128i isAlpha = _mm_cmpeq_epi8(_mm_min_epu8(alpha, _mm_set1_epi8(5)), alpha);
+        *valid = _mm_or_si128(isDigit, isAlpha);
+        return _mm_or_si128(_mm_and_si128(digit, isDigit),
+                            _mm_and_si128(_mm_add_epi8(alpha, _mm_set1_epi8(10)), isAlpha));
+    }
+
+    // 32个连续的十六进制数字转为16个字节，含其它字符时返回false
+    CPU_TARGET("sse4.1")
+    Q_ALWAYS_INLINE bool decodeCompactSse41(const ushort *text, uchar *out)
+    {
+        __m128i valid0;
+        __m128i valid1;
+        const __m128i v0 = hexValues(loadChars(text), &valid0);
+        const __m128i v1 = hexValues(loadChars(text + 16), &valid1);
+        if(_mm_movemask_epi8(_mm_and_si128(valid0, valid1)) != 0xFFFF)
+            return false;
+        // 相邻两个4位值合并为一个字节：高位·16 + 低位
+        const __m128i weights = _mm_set1_epi16(0x0110);
+        const __m128i bytes = _mm_packus_epi16(_mm_maddubs_epi16(v0, weights), _mm_maddubs_epi16(v1, weights));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), bytes);
+        return true;
+    }
+
+    // 48个字符的“HH ”×16转为16个字节，格式不符时返回false
+    CPU_TARGET("sse4.1")
+    Q_ALWAYS_INLINE bool decodeSpacedSse41(const ushort *text, uchar *out)
+    {
+        __m128i high = _mm_setzero_si128();
+        __m128i low = _mm_setzero_si128();
+        __m128i ok = _mm_set1_epi8(-1);
+        for(auto k = 0; k < 3; ++k)
+        {
+            const __m128i c = loadChars(text + 16 * k);
+            __m128i valid;
+            const __m128i v = hexValues(c, &valid);
+            const __m128i space = loadTable(SpaceMask[k]);
+            ok = _mm_and_si128(ok, _mm_blendv_epi8(valid, _mm_cmpeq_epi8(c, _mm_set1_epi8(' ')), space));
+            high = _mm_or_si128(high, _mm_shuffle_epi8(v, loadTable(DecodeHigh[k])));
+            low = _mm_or_si128(low, _mm_shuffle_epi8(v, loadTable(DecodeLow[k])));
+        }
+        if(_mm_movemask_epi8(ok) != 0xFFFF)
+            return false;
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_or_si128(_mm_slli_epi16(high, 4), low));
+        return true;
+    }
+
+    // 从text开始整块转换，遇到不能整块转换的位置停止，返回处理的字符数，*out后移
+    CPU_TARGET("sse4.1")
+    qint64 decodeBlocksSse41(const ushort *text, qint64 textLen, uchar **out)
+    {
+        qint64 i = 0;
+        uchar *o = *out;
+        for(;;)
+        {
+            const qint64 rest = textLen - i;
+            if(rest >= 48 && text[i + 2] == ' ')
+            {
+                if(!decodeSpacedSse41(text + i, o))
+                    break;
+                i += 48;
+            }
+            else if(rest >= 32)
+            {
+                if(!decodeCompactSse41(text + i, o))
+                    break;
+                i += 32;
+            }
+            else
+            {
+                break;
+            }
+            o += 16;
+        }
+        *out = o;
+        return i;
+    }
+
+    // 整块编码，返回编码的字节数；带空格格式每块末尾也写入空格，因此只编码后面还有数据的块
+    CPU_TARGET("sse4.1")
+    qint64 encodeBlocksSse41(const uchar *data, qint64 dataLen, ushort **out, int options)
+    {
+        const __m128i digits = _mm_loadu_si128(reinterpret_cast<const __m128i*>(
+                                                   options & HexCodec::LowerCase ? LowerDigits : UpperDigits));
+        const __m128i nibble = _mm_set1_epi8(0x0F);
+        const bool spaced = options & HexCodec::Spaced;
+        qint64 i = 0;
+        ushort *o = *out;
+        for(; spaced ? dataLen - i > 16 : dataLen - i >= 16; i += 16)
+        {
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            const __m128i high = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(b, 4), nibble));
+            const __m128i low = _mm_shuffle_epi8(digits, _mm_and_si128(b, nibble));
+            if(spaced)
+            {
+                for(auto k = 0; k < 3; ++k)
+                {
+                    const __m128i c = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(high, loadTable(EncodeHigh[k])),
+                                                                _mm_shuffle_epi8(low, loadTable(EncodeLow[k]))),
+                                                   _mm_and_si128(loadTable(SpaceMask[k]), _mm_set1_epi8(' ')));
+                    storeChars(o, c);
+                    o += 16;
+                }
+            }
+            else
+            {
+                storeChars(o, _mm_unpacklo_epi8(high, low));
+                storeChars(o + 16, _mm_unpackhi_epi8(high, low));
+                o += 32;
+            }
+        }
+        *out = o;
+        return i;
+    }
+#endif
+}
+
+qint64 HexCodec::encodedLength(qint64 dataLen, int options)
+{
+    if(dataLen <= 0)
+        return 0;
+    return options & Spaced ? dataLen * 3 - 1 : dataLen * 2;
+}
+
+void HexCodec::encode(const uchar *data, qint64 dataLen, ushort *out, int options)
+{
+    qint64 i = 0;
+#ifdef CPU_HAVE_X86_SIMD
+    if(CpuFeatures::hasSse41())
+        i = encodeBlocksSse41(data, dataLen, &out, options);
+#endif
+    const char *digits = options & LowerCase ? LowerDigits : UpperDigits;
+    for(; i < dataLen; ++i)
+    {
+        *out++ = ushort(digits[data[i] >> 4]);
+        *out++ = ushort(digits[data[i] & 0x0F]);
+        if((options & Spaced) && i + 1 < dataLen)
+            *out++ = ' ';
+    }
+}
+
+qint64 HexCodec::decode(const ushort *text, qint64 textLen, uchar *out, qint64 *firstInvalid)
+{
+    uchar *o = out;
+    qint64 invalidPos = -1;
+    int pending = -1;   // 未配对的高4位
+    qint64 i = 0;
+#ifdef CPU_HAVE_X86_SIMD
+    const bool simd = CpuFeatures::hasSse41();
+#endif
+    while (i < textLen)
+    {
+#ifdef CPU_HAVE_X86_SIMD
+        if(simd && pending < 0)
+            i += decodeBlocksSse41(text + i, textLen - i, &o);
+#endif
+        // 逐字符处理一段，停在字节边界上的非空白字符处，带空格的文本由此重新对齐到“HH ”
+        const qint64 runEnd = qMin(textLen, i + ScalarRun);
+        for(; i < textLen; ++i)
+        {
+            const int value = charValue(text[i]);
+            if(i >= runEnd && pending < 0 && value != Blank)
+                break;
+            if(value >= 0)
+            {
+                if(pending < 0)
+                {
+                    pending = value;
+                }
+                else
+                {
+                    *o++ = uchar((pending << 4) | value);
+                    pending = -1;
+                }
+            }
+            else if(value == Invalid && invalidPos < 0)
+            {
+                invalidPos = i;
+            }
+        }
+    }
+    if(pending >= 0)
+        *o++ = uchar(pending);
+    if(firstInvalid)
+        *firstInvalid = invalidPos;
+    return o - out;
+}
+
+QString HexCodec::toHex(const QByteArray &data, int options)
+{
+    QString text(int(encodedLength(data.size(), options)), Qt::Uninitialized);
+    encode(reinterpret_cast<const uchar*>(data.constData()), data.size(), reinterpret_cast<ushort*>(text.data()),
+           options);
+    return text;
+}
+
+QByteArray HexCodec::fromHex(const QString &text, qint64 *firstInvalid)
+{
+    QByteArray data(int(maxDecodedSize(text.size())), Qt::Uninitialized);
+    const qint64 len = decode(reinterpret_cast<const ushort*>(text.constData()), text.size(),
+                              reinterpret_cast<uchar*>(data.data()), firstInvalid);
+    data.truncate(int(len));
+    return data;
+}
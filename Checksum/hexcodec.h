@@ -0,0 +1,48 @@
+#ifndef HEXCODEC_H
+#define HEXCODEC_H
+
+#include <QByteArray>
+#include <QString>
+
+/*********************************************************************************
+** 文件描述：       十六进制文本与字节数组的整段转换（UTF-16文本，即QString的内部存储）
+** 设计：          编码：每16个字节用PSHUFB查表得到32个十六进制字符，紧凑格式交错高低4位，
+**                带空格格式（“12 AD EE”）再用3组重排掩码排成48个字符，最后零扩展为UTF-16。
+**                解码：每16个UTF-16字符饱和压缩为16个ASCII字节，用无符号比较一次得到
+**                全部字符的4位值和合法性，紧凑文本每32个字符、标准的带空格文本每48个字符
+**                整块转换16个字节；块中含其它空白、非法字符或空格位置不规则时，
+**                该段逐字符处理后再回到整块转换，结果与逐字符处理完全相同。
+**                逐字符规则：空白字符跳过，十六进制数字两两组成一个字节，
+**                末尾单个数字按低4位输出一个字节；其它字符计为非法并跳过。
+**                x86-64上CPU支持SSE4.1时使用SIMD内核，运行时检测，否则全部逐字符处理。
+**                输出缓冲区由调用方提供，转换过程不分配内存。
+**********************************************************************************/
+
+namespace HexCodec
+{
+    enum Option
+    {
+        Compact = 0x0,      // 字节之间不加空格，如“12ADEE”
+        Spaced = 0x1,       // 字节之间加一个空格，如“12 AD EE”
+        LowerCase = 0x2,    // 小写字母a~f，缺省为大写
+    };
+
+    // 编码dataLen个字节产生的字符数
+    qint64 encodedLength(qint64 dataLen, int options);
+    // 编码：out至少需要encodedLength(dataLen, options)个字符
+    void encode(const uchar *data, qint64 dataLen, ushort *out, int options);
+
+    // 解码textLen个字符最多产生的字节数
+    inline qint64 maxDecodedSize(qint64 textLen)
+    {
+        return (textLen + 1) / 2;
+    }
+    // 解码：字节写入out，返回写入的字节数；out至少需要maxDecodedSize(textLen)字节。
+    // firstInvalid非空时返回第一个非法字符的位置，没有非法字符时为-1
+    qint64 decode(const ushort *text, qint64 textLen, uchar *out, qint64 *firstInvalid = nullptr);
+
+    QString toHex(const QByteArray &data, int options = Spaced);
+    QByteArray fromHex(const QString &text, qint64 *firstInvalid = nullptr);
+}
+
+#endif // HEXCODEC_H
@@ -0,0 +1,156 @@
+#include "hexstreamdecoder.h"
+#include <initializer_list>
+
+namespace
+{
+    // 字符分类：0~15为十六进制数字的值，其余为下面的类别
+    enum CharClass : quint8
+    {
+        Skip = 0x10,        // 空白和分隔符
+        Prefix = 0x20,      // x/X，跟在0之后时是前缀
+        Invalid = 0x40,
+    };
+
+    struct CharTable
+    {
+        quint8 value[256];
+
+        constexpr CharTable() : value()
+        {
+            for(auto c = 0; c < 256; ++c)
+                value[c] = Invalid;
+            for(auto c = '0'; c <= '9'; ++c)
+                value[int(c)] = quint8(c - '0');
+            for(auto c = 'A'; c <= 'F'; ++c)
+            {
+                value[int(c)] = quint8(c - 'A' + 10);
+                value[int(c - 'A' + 'a')] = quint8(c - 'A' + 10);
+            }
+            for(const char c : { ' ', '\t', '\r', '\n', '\v', '\f', ',', ';', ':', '-' })
+                value[int(c)] = Skip;
+            value[int('x')] = Prefix;
+            value[int('X')] = Prefix;
+        }
+    };
+
+    constexpr CharTable Table;
+}
+
+HexStreamDecoder::HexStreamDecoder()
+{
+    reset();
+}
+
+void HexStreamDecoder::reset()
+{
+    pending = -1;
+    zeroLast = false;
+    invalid = 0;
+}
+
+qint64 HexStreamDecoder::decode(const char *text, qint64 len, char *out)
+{
+    const uchar *p = reinterpret_cast<const uchar*>(text);
+    const uchar *const end = p + len;
+    char *o = out;
+    // 状态放在局部变量中，循环内不读写成员
+    int high = pending;
+    bool zero = zeroLast;
+    qint64 bad = 0;
+    while (p < end)
+    {
+        if(high < 0)
+        {
+            // 快速路径：数字对之间只有空白、分隔符，如“12AD”“12 AD\n”
+            while (end - p >= 2)
+            {
+                const quint8 a = Table.value[p[0]];
+                const quint8 b = Table.value[p[1]];
+                if((a | b) >= 16)
+                {
+                    if(a != Skip)
+                        break;
+                    ++p;
+                    continue;
+                }
+                *o++ = char((a << 4) | b);
+                p += 2;
+            }
+            if(p == end)
+                break;
+        }
+        const quint8 v = Table.value[*p];
+        if(v < 16)
+        {
+            if(high < 0)
+            {
+                high = v;
+                zero = (*p == '0');
+            }
+            else
+            {
+                // 与非法字符同组时整组丢弃
+                if(high != InvalidHalf)
+                    *o++ = char((high << 4) | v);
+                high = -1;
+                zero = false;
+            }
+        }
+        else if(v == Prefix && zero)
+        {
+            // “0x”前缀：丢弃前面的0
+            high = -1;
+            zero = false;
+        }
+        else if(v != Skip)
+        {
+            // 非法字符占组中的一个位置，所在的组整组丢弃
+            high = high < 0 ? int(InvalidHalf) : -1;
+            zero = false;
+            ++bad;
+        }
+        else
+        {
+            zero = false;
+        }
+        ++p;
+    }
+    pending = high;
+    zeroLast = zero;
+    invalid += bad;
+    return o - out;
+}
+
+void HexStreamDecoder::decode(const char *text, qint64 len, QByteArray *out)
+{
+    const int size = out->size();
+    out->resize(int(size + maxDecodedSize(len)));
+    out->resize(int(size + decode(text, len, out->data() + size)));
+}
+
+int HexStreamDecoder::finish(char *out)
+{
+    const int high = pending;
+    pending = -1;
+    zeroLast = false;
+    if(high < 0 || high == InvalidHalf)
+        return 0;
+    *out = char(high);
+    return 1;
+}
+
+void HexStreamDecoder::finish(QByteArray *out)
+{
+    char c;
+    if(finish(&c) > 0)
+        out->append(c);
+}
+
+QByteArray HexStreamDecoder::decodeAll(const char *text, qint64 len)
+{
+    HexStreamDecoder decoder;
+    QByteArray out;
+    decoder.decode(text, len, &out);
+    decoder.finish(&out);
+    return out;
+}
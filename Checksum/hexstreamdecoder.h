@@ -0,0 +1,62 @@
+#ifndef HEXSTREAMDECODER_H
+#define HEXSTREAMDECODER_H
+
+#include <QByteArray>
+
+/*********************************************************************************
+** 文件描述：       流式十六进制文本解码
+** 设计：          把十六进制文本（如“12 AD EE”“0x12,0xAD”或分行的十六进制转储）解码为字节，
+**                文本可以任意分段输入：不成对的半个字节和“0x”前缀的识别状态保存在对象中，
+**                跨越分段边界的字节也能正确解码。
+**                每个字符查一次256项的分类表：十六进制数字两两组成一个字节，空白直接跳过；
+**                非法字符与数字一起两两分组，含非法字符的组整组丢弃，如“1G23”得到0x23，
+**                这两条与TypeConvert::HexStringToByteArray相同。此外常用分隔符（, ; : -）也直接跳过，
+**                紧跟在数字0之后的x/X作为前缀与前面的0一起丢弃，HexStringToByteArray把它们计为非法字符，
+**                因此只有含分隔符或“0x”前缀的文本两者的解码结果不同。
+**                连续的数字对走快速路径，每次处理两个字符。解码过程不分配内存，
+**                输出缓冲区由调用方提供，每个字符最多产生半个字节。
+**********************************************************************************/
+
+class HexStreamDecoder
+{
+public:
+    HexStreamDecoder();
+
+    // 重新开始解码
+    void reset();
+    // 解码len个字符，字节写入out，返回写入的字节数；out至少需要maxDecodedSize(len)字节
+    qint64 decode(const char *text, qint64 len, char *out);
+    // 解码len个字符，字节追加到out末尾
+    void decode(const char *text, qint64 len, QByteArray *out);
+    // 文本结束：剩下单个十六进制数字时按低4位输出一个字节，剩下单个非法字符时不输出
+    // （与HexStringToByteArray相同），返回写入out的字节数（0或1），之后可以重新开始解码
+    int finish(char *out);
+    void finish(QByteArray *out);
+
+    // 遇到的非法字符数
+    qint64 invalidChars() const
+    {
+        return invalid;
+    }
+
+    // 解码len个字符最多产生的字节数
+    static qint64 maxDecodedSize(qint64 len)
+    {
+        return len / 2 + 1;
+    }
+
+    // 一次性解码整段文本
+    static QByteArray decodeAll(const char *text, qint64 len);
+
+private:
+    // 组中只有一个字符时为非法字符
+    static constexpr int InvalidHalf = 16;
+
+    // 未配对的高4位或InvalidHalf，没有时为-1
+    int pending;
+    // 上一个字符是作为高4位的数字0，接着出现x/X时是“0x”前缀
+    bool zeroLast;
+    qint64 invalid;
+};
+
+#endif // HEXSTREAMDECODER_H
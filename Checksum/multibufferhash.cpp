@@ -0,0 +1,401 @@
+#include "multibufferhash.h"
+#include "cpufeatures.h"
+#include "parallelchecksum.h"
+#include <QtEndian>
+#include <cstring>
+#include <utility>
+
+#ifdef CPU_HAVE_X86_SIMD
+#  include <immintrin.h>
+#endif
+
+namespace
+{
+    // 逐帧计算
+    void hashEach(HashContext::Algorithm algorithm, const char *const *data, const qint64 *lengths, int count,
+                  uchar *digests)
+    {
+        const int digestLen = HashContext::digestLength(algorithm);
+        for(auto i = 0; i < count; ++i)
+        {
+            const QByteArray digest = HashContext::compute(algorithm, data[i], lengths[i]);
+            memcpy(digests + qint64(i) * digestLen, digest.constData(), size_t(digestLen));
+        }
+    }
+
+#ifdef CPU_HAVE_X86_SIMD
+    constexpr int Lanes = MultiBufferHash::Lanes;
+    constexpr int BlockLen = 64;
+
+    const quint32 Md5Init[4] = { 0x67452301U, 0xEFCDAB89U, 0x98BADCFEU, 0x10325476U };
+
+    const quint32 Md5K[64] = {
+        0xD76AA478U, 0xE8C7B756U, 0x242070DBU, 0xC1BDCEEEU, 0xF57C0FAFU, 0x4787C62AU, 0xA8304613U, 0xFD469501U,
+        0x698098D8U, 0x8B44F7AFU, 0xFFFF5BB1U, 0x895CD7BEU, 0x6B901122U, 0xFD987193U, 0xA679438EU, 0x49B40821U,
+        0xF61E2562U, 0xC040B340U, 0x265E5A51U, 0xE9B6C7AAU, 0xD62F105DU, 0x02441453U, 0xD8A1E681U, 0xE7D3FBC8U,
+        0x21E1CDE6U, 0xC33707D6U, 0xF4D50D87U, 0x455A14EDU, 0xA9E3E905U, 0xFCEFA3F8U, 0x676F02D9U, 0x8D2A4C8AU,
+        0xFFFA3942U, 0x8771F681U, 0x6D9D6122U, 0xFDE5380CU, 0xA4BEEA44U, 0x4BDECFA9U, 0xF6BB4B60U, 0xBEBFBC70U,
+        0x289B7EC6U, 0xEAA127FAU, 0xD4EF3085U, 0x04881D05U, 0xD9D4D039U, 0xE6DB99E5U, 0x1FA27CF8U, 0xC4AC5665U,
+        0xF4292244U, 0x432AFF97U, 0xAB9423A7U, 0xFC93A039U, 0x655B59C3U, 0x8F0CCC92U, 0xFFEFF47DU, 0x85845DD1U,
+        0x6FA87E4FU, 0xFE2CE6E0U, 0xA3014314U, 0x4E0811A1U, 0xF7537E82U, 0xBD3AF235U, 0x2AD7D2BBU, 0xEB86D391U,
+    };
+
+    const quint32 Sha256Init[8] = {
+        0x6A09E667U, 0xBB67AE85U, 0x3C6EF372U, 0xA54FF53AU, 0x510E527FU, 0x9B05688CU, 0x1F83D9ABU, 0x5BE0CD19U,
+    };
+
+    const quint32 Sha256K[64] = {
+        0x428A2F98U, 0x71374491U, 0xB5C0FBCFU, 0xE9B5DBA5U, 0x3956C25BU, 0x59F111F1U, 0x923F82A4U, 0xAB1C5ED5U,
+        0xD807AA98U, 0x12835B01U, 0x243185BEU, 0x550C7DC3U, 0x72BE5D74U, 0x80DEB1FEU, 0x9BDC06A7U, 0xC19BF174U,
+        0xE49B69C1U, 0xEFBE4786U, 0x0FC19DC6U, 0x240CA1CCU, 0x2DE92C6FU, 0x4A7484AAU, 0x5CB0A9DCU, 0x76F988DAU,
+        0x983E5152U, 0xA831C66DU, 0xB00327C8U, 0xBF597FC7U, 0xC6E00BF3U, 0xD5A79147U, 0x06CA6351U, 0x14292967U,
+        0x27B70A85U, 0x2E1B2138U, 0x4D2C6DFCU, 0x53380D13U, 0x650A7354U, 0x766A0ABBU, 0x81C2C92EU, 0x92722C85U,
+        0xA2BFE8A1U, 0xA81A664BU, 0xC24B8B70U, 0xC76C51A3U, 0xD192E819U, 0xD6990624U, 0xF40E3585U, 0x106AA070U,
+        0x19A4C116U, 0x1E376C08U, 0x2748774CU, 0x34B0BCB5U, 0x391C0CB3U, 0x4ED8AA4AU, 0x5B9CCA4FU, 0x682E6FF3U,
+        0x748F82EEU, 0x78A5636FU, 0x84C87814U, 0x8CC70208U, 0x90BEFFFAU, 0xA4506CEBU, 0xBEF9A3F7U, 0xC67178F2U,
+    };
+
+    // 空闲通道压缩的分组
+    alignas(32) const uchar ZeroBlock[BlockLen] = {};
+
+    // MD5第i步使用的消息字和循环左移位数
+    constexpr int md5Index(int i)
+    {
+        return i < 16 ? i : i < 32 ? (5 * i + 1) & 15 : i < 48 ? (3 * i + 5) & 15 : (7 * i) & 15;
+    }
+
+    constexpr int md5Shift(int i)
+    {
+        constexpr int shifts[4][4] = { { 7, 12, 17, 22 }, { 5, 9, 14, 20 }, { 4, 11, 16, 23 }, { 6, 10, 15, 21 } };
+        return shifts[i / 16][i % 4];
+    }
+
+    template<int N>
+    CPU_TARGET("avx2")
+    Q_ALWAYS_INLINE __m256i rotlAvx2(__m256i x)
+    {
+        return _mm256_or_si256(_mm256_slli_epi32(x, N), _mm256_srli_epi32(x, 32 - N));
+    }
+
+    template<int N>
+    CPU_TARGET("avx2")
+    Q_ALWAYS_INLINE __m256i rotrAvx2(__m256i x)
+    {
+        return rotlAvx2<32 - N>(x);
+    }
+
+    // 8×8的32位矩阵转置
+    CPU_TARGET("avx2")
+    Q_ALWAYS_INLINE void transpose8Avx2(__m256i *r)
+    {
+        const __m256i ab0145 = _mm256_unpacklo_epi32(r[0], r[1]);
+        const __m256i ab2367 = _mm256_unpackhi_epi32(r[0], r[1]);
+        const __m256i cd0145 = _mm256_unpacklo_epi32(r[2], r[3]);
+        const __m256i cd2367 = _mm256_unpackhi_epi32(r[2], r[3]);
+        const __m256i ef0145 = _mm256_unpacklo_epi32(r[4], r[5]);
+        const __m256i ef2367 = _mm256_unpackhi_epi32(r[4], r[5]);
+        const __m256i gh0145 = _mm256_unpacklo_epi32(r[6], r[7]);
+        const __m256i gh2367 = _mm256_unpackhi_epi32(r[6], r[7]);
+        const __m256i abcd04 = _mm256_unpacklo_epi64(ab0145, cd0145);
+        const __m256i abcd15 = _mm256_unpackhi_epi64(ab0145, cd0145);
+        const __m256i abcd26 = _mm256_unpacklo_epi64(ab2367, cd2367);
+        const __m256i abcd37 = _mm256_unpackhi_epi64(ab2367, cd2367);
+        const __m256i efgh04 = _mm256_unpacklo_epi64(ef0145, gh0145);
+        const __m256i efgh15 = _mm256_unpackhi_epi64(ef0145, gh0145);
+        const __m256i efgh26 = _mm256_unpacklo_epi64(ef2367, gh2367);
+        const __m256i efgh37 = _mm256_unpackhi_epi64(ef2367, gh2367);
+        r[0] = _mm256_permute2x128_si256(abcd04, efgh04, 0x20);
+        r[1] = _mm256_permute2x128_si256(abcd15, efgh15, 0x20);
+        r[2] = _mm256_permute2x128_si256(abcd26, efgh26, 0x20);
+        r[3] = _mm256_permute2x128_si256(abcd37, efgh37, 0x20);
+        r[4] = _mm256_permute2x128_si256(abcd04, efgh04, 0x31);
+        r[5] = _mm256_permute2x128_si256(abcd15, efgh15, 0x31);
+        r[6] = _mm256_permute2x128_si256(abcd26, efgh26, 0x31);
+        r[7] = _mm256_permute2x128_si256(abcd37, efgh37, 0x31);
+    }
+
+    // 8路分组的16个消息字：w[j]的第k个通道为blocks[k]的第j个32位字（小端）
+    CPU_TARGET("avx2")
+    Q_ALWAYS_INLINE void loadBlocksAvx2(const uchar *const *blocks, __m256i *w)
+    {
+        for(auto half = 0; half < 2; ++half)
+        {
+            __m256i *r = w + 8 * half;
+            for(auto k = 0; k < Lanes; ++k)
+                r[k] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(blocks[k] + 32 * half));
+            transpose8Avx2(r);
+        }
+    }
+
+    /************************************ MD5 ************************************/
+
+    // 第I步：v中4个状态字的角色每步轮换一次，新值写入a的位置
+    template<int I>
+    CPU_TARGET("avx2")
+    Q_ALWAYS_INLINE void md5StepAvx2(__m256i *v, const __m256i *w)
+    {
+        constexpr int r = I & 3;
+        __m256i &a = v[(4 - r) & 3];
+        const __m256i b = v[(5 - r) & 3];
+        const __m256i c = v[(6 - r) & 3];
+        const __m256i d = v[(7 - r) & 3];
+        __m256i f;
+        if constexpr (I < 16)
+            f = _mm256_xor_si256(d, _mm256_and_si256(b, _mm256_xor_si256(c, d)));
+        else if constexpr (I < 32)
+            f = _mm256_xor_si256(c, _mm256_and_si256(d, _mm256_xor_si256(b, c)));
+        else if constexpr (I < 48)
+            f = _mm256_xor_si256(_mm256_xor_si256(b, c), d);
+        else
+            f = _mm256_xor_si256(c, _mm256_or_si256(b, _mm256_xor_si256(d, _mm256_set1_epi32(-1))));
+        const __m256i t = _mm256_add_epi32(_mm256_add_epi32(a, f),
+                                           _mm256_add_epi32(_mm256_set1_epi32(int(Md5K[I])), w[md5Index(I)]));
+        a = _mm256_add_epi32(b, rotlAvx2<md5Shift(I)>(t));
+    }
+
+    template<int... I>
+    CPU_TARGET("avx2")
+    Q_ALWAYS_INLINE void md5RoundsAvx2(__m256i *v, const __m256i *w, std::integer_sequence<int, I...>)
+    {
+        (md5StepAvx2<I>(v, w), ...);
+    }
+
+    struct Md5Avx2
+    {
+        static constexpr int StateWords = 4;
+        static constexpr bool BigEndian = false;
+
+        static const quint32* init()
+        {
+            return Md5Init;
+        }
+
+        CPU_TARGET("avx2")
+        static void compress(quint32 (*state)[Lanes], const uchar *const *blocks)
+        {
+            __m256i w[16];
+            loadBlocksAvx2(blocks, w);
+            __m256i h[StateWords];
+            __m256i v[StateWords];
+            for(auto j = 0; j < StateWords; ++j)
+                v[j] = h[j] = _mm256_load_si256(reinterpret_cast<const __m256i*>(state[j]));
+            md5RoundsAvx2(v, w, std::make_integer_sequence<int, 64>());
+            for(auto j = 0; j < StateWords; ++j)
+                _mm256_store_si256(reinterpret_cast<__m256i*>(state[j]), _mm256_add_epi32(h[j], v[j]));
+            _mm256_zeroupper();
+        }
+    };
+
+    /********************************** SHA-256 **********************************/
+
+    // 第T步：8个状态字的角色每步轮换一次，消息扩展在16个字的环形缓冲区中进行
+    template<int T>
+    CPU_TARGET("avx2")
+    Q_ALWAYS_INLINE void sha256StepAvx2(__m256i *v, __m256i *w)
+    {
+        if constexpr (T >= 16)
+        {
+            const __m256i w2 = w[(T - 2) & 15];
+            const __m256i w15 = w[(T - 15) & 15];
+            const __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(rotrAvx2<7>(w15), rotrAvx2<18>(w15)),
+                                                _mm256_srli_epi32(w15, 3));
+            const __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(rotrAvx2<17>(w2), rotrAvx2<19>(w2)),
+                                                _mm256_srli_epi32(w2, 10));
+            w[T & 15] = _mm256_add_epi32(_mm256_add_epi32(w[T & 15], s0), _mm256_add_epi32(w[(T - 7) & 15], s1));
+        }
+        const __m256i a = v[(0 - T) & 7];
+        const __m256i b = v[(1 - T) & 7];
+        const __m256i c = v[(2 - T) & 7];
+        const __m256i e = v[(4 - T) & 7];
+        const __m256i f = v[(5 - T) & 7];
+        const __m256i g = v[(6 - T) & 7];
+        const __m256i h = v[(7 - T) & 7];
+        const __m256i sum1 = _mm256_xor_si256(_mm256_xor_si256(rotrAvx2<6>(e), rotrAvx2<11>(e)), rotrAvx2<25>(e));
+        const __m256i ch = _mm256_xor_si256(g, _mm256_and_si256(e, _mm256_xor_si256(f, g)));
+        const __m256i t1 = _mm256_add_epi32(_mm256_add_epi32(_mm256_add_epi32(h, sum1), ch),
+                                            _mm256_add_epi32(_mm256_set1_epi32(int(Sha256K[T])), w[T & 15]));
+        const __m256i sum0 = _mm256_xor_si256(_mm256_xor_si256(rotrAvx2<2>(a), rotrAvx2<13>(a)), rotrAvx2<22>(a));
+        const __m256i maj = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+        v[(3 - T) & 7] = _mm256_add_epi32(v[(3 - T) & 7], t1);
+        v[(7 - T) & 7] = _mm256_add_epi32(t1, _mm256_add_epi32(sum0, maj));
+    }
+
+    template<int... T>
+    CPU_TARGET("avx2")
+    Q_ALWAYS_INLINE void sha256RoundsAvx2(__m256i *v, __m256i *w, std::integer_sequence<int, T...>)
+    {
+        (sha256StepAvx2<T>(v, w), ...);
+    }
+
+    struct Sha256Avx2
+    {
+        static constexpr int StateWords = 8;
+        static constexpr bool BigEndian = true;
+
+        static const quint32* init()
+        {
+            return Sha256Init;
+        }
+
+        CPU_TARGET("avx2")
+        static void compress(quint32 (*state)[Lanes], const uchar *const *blocks)
+        {
+            // 消息字按大端读取
+            const __m256i swap = _mm256_broadcastsi128_si256(
+                        _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3));
+            __m256i w[16];
+            loadBlocksAvx2(blocks, w);
+            for(auto j = 0; j < 16; ++j)
+                w[j] = _mm256_shuffle_epi8(w[j], swap);
+            __m256i h[StateWords];
+            __m256i v[StateWords];
+            for(auto j = 0; j < StateWords; ++j)
+                v[j] = h[j] = _mm256_load_si256(reinterpret_cast<const __m256i*>(state[j]));
+            sha256RoundsAvx2(v, w, std::make_integer_sequence<int, 64>());
+            for(auto j = 0; j < StateWords; ++j)
+                _mm256_store_si256(reinterpret_cast<__m256i*>(state[j]), _mm256_add_epi32(h[j], v[j]));
+            _mm256_zeroupper();
+        }
+    };
+
+    /*********************************** 调度 ***********************************/
+
+    // 一路正在计算的帧
+    struct Lane
+    {
+        int frame;                  // 帧下标，空闲时为-1
+        const uchar *data;
+        qint64 fullBlocks;          // 帧数据中完整的分组数
+        qint64 totalBlocks;         // 加上填充后的分组数
+        qint64 block;               // 下一个压缩的分组
+        uchar tail[2 * BlockLen];   // 最后不完整的数据及填充
+
+        const uchar* blockData() const
+        {
+            return block < fullBlocks ? data + block * BlockLen : tail + (block - fullBlocks) * BlockLen;
+        }
+    };
+
+    template<typename Algo>
+    void hashFramesAvx2(const char *const *data, const qint64 *lengths, int count, uchar *digests)
+    {
+        constexpr int digestLen = Algo::StateWords * 4;
+        // state[j][k]为第k路的第j个状态字
+        alignas(32) quint32 state[Algo::StateWords][Lanes];
+        Lane lanes[Lanes];
+        int next = 0;
+        int active = 0;
+
+        // 第k路装入下一帧：完整分组直接读取，剩余数据、0x80、补0和位长度放入tail
+        const auto load = [&](int k) {
+            Lane &lane = lanes[k];
+            if(next >= count)
+            {
+                lane.frame = -1;
+                return;
+            }
+            const qint64 len = lengths[next];
+            const qint64 rest = len % BlockLen;
+            const int padBlocks = rest < BlockLen - 8 ? 1 : 2;
+            lane.frame = next;
+            lane.data = reinterpret_cast<const uchar*>(data[next]);
+            lane.fullBlocks = len / BlockLen;
+            lane.totalBlocks = lane.fullBlocks + padBlocks;
+            lane.block = 0;
+            memset(lane.tail, 0, sizeof(lane.tail));
+            memcpy(lane.tail, lane.data + lane.fullBlocks * BlockLen, size_t(rest));
+            lane.tail[rest] = 0x80;
+            uchar *bits = lane.tail + padBlocks * BlockLen - 8;
+            if(Algo::BigEndian)
+                qToBigEndian<quint64>(quint64(len) * 8, bits);
+            else
+                qToLittleEndian<quint64>(quint64(len) * 8, bits);
+            for(auto j = 0; j < Algo::StateWords; ++j)
+                state[j][k] = Algo::init()[j];
+            ++next;
+            ++active;
+        };
+
+        for(auto k = 0; k < Lanes; ++k)
+            load(k);
+        const uchar *blocks[Lanes];
+        while (active > 0)
+        {
+            for(auto k = 0; k < Lanes; ++k)
+                blocks[k] = lanes[k].frame < 0 ? ZeroBlock : lanes[k].blockData();
+            Algo::compress(state, blocks);
+            for(auto k = 0; k < Lanes; ++k)
+            {
+                Lane &lane = lanes[k];
+                if(lane.frame < 0 || ++lane.block < lane.totalBlocks)
+                    continue;
+                uchar *out = digests + qint64(lane.frame) * digestLen;
+                for(auto j = 0; j < Algo::StateWords; ++j)
+                {
+                    if(Algo::BigEndian)
+                        qToBigEndian<quint32>(state[j][k], out + 4 * j);
+                    else
+                        qToLittleEndian<quint32>(state[j][k], out + 4 * j);
+                }
+                --active;
+                load(k);
+            }
+        }
+    }
+#endif
+}
+
+bool MultiBufferHash::isAccelerated(HashContext::Algorithm algorithm)
+{
+#ifdef CPU_HAVE_X86_SIMD
+    return (algorithm == HashContext::Md5 || algorithm == HashContext::Sha256) && CpuFeatures::hasAvx2();
+#else
+    Q_UNUSED(algorithm);
+    return false;
+#endif
+}
+
+void MultiBufferHash::hash(HashContext::Algorithm algorithm, const char *const *data, const qint64 *lengths, int count,
+                           uchar *digests)
+{
+    if(count <= 0)
+        return;
+    if(!isAccelerated(algorithm))
+    {
+        hashEach(algorithm, data, lengths, count, digests);
+        return;
+    }
+#ifdef CPU_HAVE_X86_SIMD
+    const int digestLen = HashContext::digestLength(algorithm);
+    const auto run = [&](int begin, int end) {
+        if(algorithm == HashContext::Md5)
+            hashFramesAvx2<Md5Avx2>(data + begin, lengths + begin, end - begin, digests + qint64(begin) * digestLen);
+        else
+            hashFramesAvx2<Sha256Avx2>(data + begin, lengths + begin, end - begin, digests + qint64(begin) * digestLen);
+    };
+    if(count < 2 * FramesPerTask)
+    {
+        run(0, count);
+        return;
+    }
+    const int tasks = (count + FramesPerTask - 1) / FramesPerTask;
+    ParallelChecksum::forEachChunk(tasks, [&](int task) {
+        run(task * FramesPerTask, qMin(count, (task + 1) * FramesPerTask));
+    });
+#endif
+}
+
+QByteArray MultiBufferHash::hash(HashContext::Algorithm algorithm, const QVector<QByteArray> &frames)
+{
+    const int count = frames.size();
+    QVector<const char*> data(count);
+    QVector<qint64> lengths(count);
+    for(auto i = 0; i < count; ++i)
+    {
+        data[i] = frames[i].constData();
+        lengths[i] = frames[i].size();
+    }
+    QByteArray digests(count * HashContext::digestLength(algorithm), Qt::Uninitialized);
+    hash(algorithm, data.constData(), lengths.constData(), count, reinterpret_cast<uchar*>(digests.data()));
+    return digests;
+}
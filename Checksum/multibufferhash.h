@@ -0,0 +1,38 @@
+#ifndef MULTIBUFFERHASH_H
+#define MULTIBUFFERHASH_H
+
+#include <QByteArray>
+#include <QVector>
+#include "hashcontext.h"
+
+/*********************************************************************************
+** 文件描述：       多路并行计算大量短帧的摘要（多缓冲区MD5、SHA-256）
+** 设计：          MD5、SHA-256的每个64字节分组要经过64步严格串行的运算，单个短帧无法加速，
+**                逐帧计算时创建上下文、填充等固定开销也占了短帧的大部分时间。互不相关的帧
+**                可以同时计算：AVX2的8个32位通道各负责一帧，每次压缩8帧各一个分组，
+**                8路分组的消息字经8×8矩阵转置排成按通道存放的向量。
+**                各帧长度不同：某一路的帧结束（含填充分组）时输出摘要并立即装入下一帧，
+**                通道始终满载；帧全部装入后空闲的通道压缩一个全零分组，结果丢弃。
+**                只有每帧最后不完整的分组和填充复制到该路的小缓冲区中，其余分组直接读取帧数据。
+**                帧数较多时按FramesPerTask分组交给全局线程池，每个线程独立调度8路。
+**                CPU不支持AVX2时以及其它摘要算法逐帧用HashContext计算，结果相同。
+**********************************************************************************/
+
+namespace MultiBufferHash
+{
+    // 同时计算的帧数
+    constexpr int Lanes = 8;
+    // 多线程计算时每个任务的帧数，帧数不到两个任务时在当前线程计算
+    constexpr int FramesPerTask = 1024;
+
+    // 是否多路并行计算（MD5、SHA-256，且CPU支持AVX2）
+    bool isAccelerated(HashContext::Algorithm algorithm);
+    // 分别计算count帧的摘要：第i帧为data[i]开始的lengths[i]字节，摘要按帧的顺序写入digests，
+    // 每帧HashContext::digestLength(algorithm)字节
+    void hash(HashContext::Algorithm algorithm, const char *const *data, const qint64 *lengths, int count,
+              uchar *digests);
+    // 分别计算各帧的摘要，返回按帧的顺序拼接的摘要
+    QByteArray hash(HashContext::Algorithm algorithm, const QVector<QByteArray> &frames);
+}
+
+#endif // MULTIBUFFERHASH_H
@@ -0,0 +1,78 @@
+#include "parallelchecksum.h"
+#include <QFile>
+#include <QThread>
+#include <QtConcurrent>
+
+namespace
+{
+    // 每次映射的文件窗口大小
+#if QT_POINTER_SIZE == 8
+    constexpr qint64 WindowSize = qint64(1) << 30;
+#else
+    constexpr qint64 WindowSize = qint64(1) << 26;
+#endif
+    // 不能映射时每次读取的大小
+    constexpr qint64 ReadSize = qint64(1) << 26;
+}
+
+qint64 ParallelChecksum::chunkSize(qint64 dataLen)
+{
+    const qint64 threads = qMax(1, QThread::idealThreadCount());
+    const qint64 chunk = (dataLen / (threads * 4) + 63) & ~qint64(63);
+    return qMax(chunk, MinChunkSize);
+}
+
+void ParallelChecksum::forEachChunk(int chunks, const std::function<void(int)> &func)
+{
+    QVector<int> indexes(chunks);
+    for(auto i = 0; i < chunks; ++i)
+        indexes[i] = i;
+    QtConcurrent::blockingMap(indexes, [&func](const int &i) { func(i); });
+}
+
+bool ParallelChecksum::forEachWindow(QFile &file, const std::function<void(const char*, qint64)> &func,
+                                     QString *errorString)
+{
+    const qint64 fileSize = file.size();
+    qint64 offset = 0;
+    // 先尝试映射，映射失败（如管道、设备文件）时改为读取
+    while (offset < fileSize)
+    {
+        const qint64 len = qMin(WindowSize, fileSize - offset);
+        uchar *p = file.map(offset, len);
+        if(p == nullptr)
+            break;
+        func(reinterpret_cast<const char*>(p), len);
+        file.unmap(p);
+        offset += len;
+    }
+    if(offset >= fileSize && fileSize > 0)
+        return true;
+
+    if(!file.seek(offset))
+    {
+        if(errorString)
+            *errorString = file.errorString();
+        return false;
+    }
+    QByteArray buf;
+    while (!file.atEnd())
+    {
+        buf = file.read(ReadSize);
+        if(buf.isEmpty())
+        {
+            if(file.error() != QFileDevice::NoError)
+            {
+                if(errorString)
+                    *errorString = file.errorString();
+                return false;
+            }
+            break;
+        }
+        // 窗口保持偶数长度，16位累加和的字边界不随读取长度错开
+        if(buf.size() % 2 != 0 && !file.atEnd())
+            buf.append(file.read(1));
+        func(buf.constData(), buf.size());
+    }
+    return true;
+}
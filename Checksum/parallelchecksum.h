@@ -0,0 +1,130 @@
+#ifndef PARALLELCHECKSUM_H
+#define PARALLELCHECKSUM_H
+
+#include <QVector>
+#include <functional>
+
+class QFile;
+class QString;
+
+/*********************************************************************************
+** 文件描述：       多线程并行校验计算
+** 设计：          数据按分块长度切分，第一块从当前状态开始、其余各块从Engine::empty()开始，
+**                在全局线程池中并行计算，再按顺序用Engine::combine()合并，结果与顺序计算
+**                完全相同。文件按窗口映射到内存（不能映射时按窗口读取），窗口内并行计算，
+**                窗口之间顺序衔接，超大文件在32位进程中也不会占满地址空间；窗口内按FileStepSize
+**                分段，每段结束时报告进度，调用方可据此取消。
+**                Engine为CrcEngine的任一实例、checksumengine.h中的累加和类算法或CrcModel。
+**                16位累加和的状态中暂存了未成对的字节时，先顺序补齐这个字，各块才从字边界开始。
+**********************************************************************************/
+
+namespace ParallelChecksum
+{
+    // 每个分块的最小长度，不足两个分块的数据直接顺序计算
+    constexpr qint64 MinChunkSize = 1 << 20;
+    // 计算文件时每段的长度：每段结束时报告进度、检查是否停止，仍足够多线程分块
+    constexpr qint64 FileStepSize = qint64(64) << 20;
+
+    // 文件计算的进度：已处理bytesDone字节，返回false时停止计算
+    typedef std::function<bool(qint64 bytesDone)> Progress;
+
+    // dataLen字节数据的分块长度：按线程数均分，每个线程分到多块以平衡负载，长度为64的倍数
+    qint64 chunkSize(qint64 dataLen);
+    // 在全局线程池中对0~chunks-1并行调用func，全部完成后返回
+    void forEachChunk(int chunks, const std::function<void(int)> &func);
+    // 从头按窗口依次把文件映射（或读取）到内存，对每个窗口调用func，失败返回false
+    bool forEachWindow(QFile &file, const std::function<void(const char*, qint64)> &func,
+                       QString *errorString);
+
+    // 状态中暂存了未成对的字节（如Checksum16State::pending）时返回true，其它状态返回false
+    template<typename State>
+    auto hasPending(const State &state, int) -> decltype(state.pending >= 0)
+    {
+        return state.pending >= 0;
+    }
+    template<typename State>
+    bool hasPending(const State &, long)
+    {
+        return false;
+    }
+}
+
+// 从state开始并行更新dataLen字节数据，等价于engine.update(state, data, dataLen)。
+// engine为引擎对象：静态引擎传入临时对象即可，CrcModel等运行时生成的模型传入模型本身
+template<typename Engine>
+typename Engine::state_type ParallelChecksumUpdate(const Engine &engine, typename Engine::state_type state,
+                                                   const char *data, qint64 dataLen)
+{
+    typedef typename Engine::state_type state_type;
+
+    // 先补齐未成对的字节，否则第一块以奇数个字节结束，后面各块的字都错开一个字节
+    if(dataLen > 0 && ParallelChecksum::hasPending(state, 0))
+    {
+        state = engine.update(state, data, 1);
+        ++data;
+        --dataLen;
+    }
+
+    const qint64 chunk = ParallelChecksum::chunkSize(dataLen);
+    if(dataLen < 2 * chunk)
+        return engine.update(state, data, dataLen);
+
+    const int chunks = int((dataLen + chunk - 1) / chunk);
+    QVector<state_type> states(chunks);
+    ParallelChecksum::forEachChunk(chunks, [&](int i) {
+        const qint64 offset = i * chunk;
+        states[i] = engine.update(i == 0 ? state : engine.empty(), data + offset, qMin(chunk, dataLen - offset));
+    });
+
+    state = states[0];
+    for(auto i = 1; i < chunks; ++i)
+        state = engine.combine(state, states[i], qMin(chunk, dataLen - i * chunk));
+    return state;
+}
+
+template<typename Engine>
+typename Engine::state_type ParallelChecksumUpdate(typename Engine::state_type state, const char *data, qint64 dataLen)
+{
+    return ParallelChecksumUpdate(Engine(), state, data, dataLen);
+}
+
+// 并行计算data的校验码
+template<typename Engine>
+typename Engine::value_type ParallelChecksumCompute(const char *data, qint64 dataLen)
+{
+    return Engine::finalize(ParallelChecksumUpdate<Engine>(Engine::initial(), data, dataLen));
+}
+
+// 并行计算文件的校验码，文件需已按只读方式打开。每个窗口按FileStepSize分段计算，
+// 每段结束时调用progress（可为空）；progress返回false时停止，余下的窗口只映射不访问，返回false
+template<typename Engine>
+bool ParallelChecksumFile(const Engine &engine, QFile &file, typename Engine::value_type *result,
+                          QString *errorString = nullptr, const ParallelChecksum::Progress &progress = nullptr)
+{
+    typename Engine::state_type state = engine.initial();
+    qint64 done = 0;
+    bool stopped = false;
+    const bool ok = ParallelChecksum::forEachWindow(file, [&](const char *data, qint64 dataLen) {
+        for(qint64 offset = 0; offset < dataLen && !stopped; offset += ParallelChecksum::FileStepSize)
+        {
+            const qint64 len = qMin(ParallelChecksum::FileStepSize, dataLen - offset);
+            state = ParallelChecksumUpdate(engine, state, data + offset, len);
+            done += len;
+            if(progress && !progress(done))
+                stopped = true;
+        }
+    }, errorString);
+    if(!ok || stopped)
+        return false;
+    *result = engine.finalize(state);
+    return true;
+}
+
+template<typename Engine>
+bool ParallelChecksumFile(QFile &file, typename Engine::value_type *result, QString *errorString = nullptr,
+                          const ParallelChecksum::Progress &progress = nullptr)
+{
+    return ParallelChecksumFile(Engine(), file, result, errorString, progress);
+}
+
+#endif // PARALLELCHECKSUM_H
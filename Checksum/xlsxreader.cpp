@@ -0,0 +1,604 @@
+#include "xlsxreader.h"
+#include <QFile>
+#include <QLocale>
+#include <QXmlStreamReader>
+#include <QtEndian>
+#include <climits>
+
+namespace
+{
+    /*****************************************************************************
+    ** Deflate（RFC 1951）解压：按规范逐位解码，规范Huffman码由码长表重建。
+    ** 工作簿中的XML只有几十KB，不需要查表加速。
+    *****************************************************************************/
+    class Inflater
+    {
+    public:
+        Inflater(const uchar *data, qint64 dataLen, qint64 expectedSize)
+            : in(data), inLen(dataLen)
+        {
+            out.reserve(int(qMin<qint64>(expectedSize, 64 << 20)));
+        }
+
+        bool run()
+        {
+            bool last = false;
+            while (!last && !error)
+            {
+                last = bits(1);
+                switch (bits(2))
+                {
+                case 0:
+                    stored();
+                    break;
+                case 1:
+                    fixed();
+                    break;
+                case 2:
+                    dynamic();
+                    break;
+                default:
+                    error = true;
+                    break;
+                }
+            }
+            return !error;
+        }
+
+        QByteArray result() const
+        {
+            return out;
+        }
+
+    private:
+        static constexpr int MaxBits = 15;
+        static constexpr int MaxLitLen = 288;
+        static constexpr int MaxDist = 30;
+
+        struct Huffman
+        {
+            quint16 count[MaxBits + 1];     // 每种码长的符号个数
+            quint16 symbol[MaxLitLen];      // 按码值排序的符号
+        };
+
+        int bits(int need)
+        {
+            quint32 val = bitBuf;
+            while (bitCnt < need)
+            {
+                if(pos >= inLen)
+                {
+                    error = true;
+                    return 0;
+                }
+                val |= quint32(in[pos++]) << bitCnt;
+                bitCnt += 8;
+            }
+            bitBuf = val >> need;
+            bitCnt -= need;
+            return int(val & ((1u << need) - 1));
+        }
+
+        // 由码长表构造规范Huffman码，码长超额（过度订阅）时返回false
+        static bool build(Huffman &h, const quint8 *lengths, int n)
+        {
+            for(auto len = 0; len <= MaxBits; ++len)
+                h.count[len] = 0;
+            for(auto i = 0; i < n; ++i)
+                ++h.count[lengths[i]];
+            if(h.count[0] == n)
+                return true;
+            int left = 1;
+            for(auto len = 1; len <= MaxBits; ++len)
+            {
+                left <<= 1;
+                left -= h.count[len];
+                if(left < 0)
+                    return false;
+            }
+            quint16 offs[MaxBits + 1];
+            offs[1] = 0;
+            for(auto len = 1; len < MaxBits; ++len)
+                offs[len + 1] = offs[len] + h.count[len];
+            for(auto i = 0; i < n; ++i)
+            {
+                if(lengths[i] != 0)
+                    h.symbol[offs[lengths[i]]++] = quint16(i);
+            }
+            return true;
+        }
+
+        int decode(const Huffman &h)
+        {
+            int code = 0, first = 0, index = 0;
+            for(auto len = 1; len <= MaxBits; ++len)
+            {
+                code |= bits(1);
+                if(error)
+                    return -1;
+                const int count = h.count[len];
+                if(code - first < count)
+                    return h.symbol[index + (code - first)];
+                index += count;
+                first += count;
+                first <<= 1;
+                code <<= 1;
+            }
+            error = true;
+            return -1;
+        }
+
+        void stored()
+        {
+            bitBuf = 0;
+            bitCnt = 0;
+            if(pos + 4 > inLen)
+            {
+                error = true;
+                return;
+            }
+            const quint16 len = qFromLittleEndian<quint16>(in + pos);
+            const quint16 nlen = qFromLittleEndian<quint16>(in + pos + 2);
+            pos += 4;
+            if(len != quint16(~nlen) || pos + len > inLen)
+            {
+                error = true;
+                return;
+            }
+            out.append(reinterpret_cast<const char*>(in + pos), len);
+            pos += len;
+        }
+
+        void codes(const Huffman &lencode, const Huffman &distcode)
+        {
+            static const quint16 lenBase[29] = {
+                3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+            static const quint8 lenExtra[29] = {
+                0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+            static const quint16 distBase[30] = {
+                1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+            static const quint8 distExtra[30] = {
+                0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+            for(;;)
+            {
+                int symbol = decode(lencode);
+                if(symbol < 0)
+                    return;
+                if(symbol < 256)
+                {
+                    out.append(char(symbol));
+                    continue;
+                }
+                if(symbol == 256)
+                    return;
+                symbol -= 257;
+                if(symbol >= 29)
+                {
+                    error = true;
+                    return;
+                }
+                const int len = lenBase[symbol] + bits(lenExtra[symbol]);
+                symbol = decode(distcode);
+                if(symbol < 0 || symbol >= 30)
+                {
+                    error = true;
+                    return;
+                }
+                const int dist = distBase[symbol] + bits(distExtra[symbol]);
+                if(error || dist > out.size())
+                {
+                    error = true;
+                    return;
+                }
+                // 复制区域可能与输出重叠（dist < len），只能逐字节复制
+                int from = out.size() - dist;
+                for(auto i = 0; i < len; ++i)
+                    out.append(out.at(from++));
+            }
+        }
+
+        void fixed()
+        {
+            static Huffman lencode, distcode;
+            static const bool built = [] {
+                quint8 lengths[MaxLitLen];
+                int i = 0;
+                for(; i < 144; ++i) lengths[i] = 8;
+                for(; i < 256; ++i) lengths[i] = 9;
+                for(; i < 280; ++i) lengths[i] = 7;
+                for(; i < MaxLitLen; ++i) lengths[i] = 8;
+                build(lencode, lengths, MaxLitLen);
+                for(i = 0; i < MaxDist; ++i)
+                    lengths[i] = 5;
+                build(distcode, lengths, MaxDist);
+                return true;
+            }();
+            Q_UNUSED(built);
+            codes(lencode, distcode);
+        }
+
+        void dynamic()
+        {
+            static const quint8 order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+            const int nlen = bits(5) + 257;
+            const int ndist = bits(5) + 1;
+            const int ncode = bits(4) + 4;
+            if(error || nlen > 286 || ndist > MaxDist)
+            {
+                error = true;
+                return;
+            }
+            quint8 lengths[MaxLitLen + MaxDist] = {};
+            for(auto i = 0; i < ncode; ++i)
+                lengths[order[i]] = quint8(bits(3));
+            Huffman lencode, distcode;
+            if(!build(lencode, lengths, 19))
+            {
+                error = true;
+                return;
+            }
+
+            // 码长本身也经过Huffman编码，16~18为重复码
+            int index = 0;
+            while (index < nlen + ndist && !error)
+            {
+                int symbol = decode(lencode);
+                if(symbol < 0)
+                    return;
+                if(symbol < 16)
+                {
+                    lengths[index++] = quint8(symbol);
+                    continue;
+                }
+                quint8 len = 0;
+                if(symbol == 16)
+                {
+                    if(index == 0)
+                    {
+                        error = true;
+                        return;
+                    }
+                    len = lengths[index - 1];
+                    symbol = 3 + bits(2);
+                }
+                else if(symbol == 17)
+                    symbol = 3 + bits(3);
+                else
+                    symbol = 11 + bits(7);
+                if(index + symbol > nlen + ndist)
+                {
+                    error = true;
+                    return;
+                }
+                while (symbol--)
+                    lengths[index++] = len;
+            }
+            if(error || lengths[256] == 0)
+            {
+                error = true;
+                return;
+            }
+            if(!build(lencode, lengths, nlen) || !build(distcode, lengths + nlen, ndist))
+            {
+                error = true;
+                return;
+            }
+            codes(lencode, distcode);
+        }
+
+        const uchar *in;
+        qint64 inLen;
+        qint64 pos = 0;
+        quint32 bitBuf = 0;
+        int bitCnt = 0;
+        bool error = false;
+        QByteArray out;
+    };
+
+    // 单元格引用转为行列号（均从0开始），如"BC12"为第11行、第54列
+    bool parseCellRef(const QString &ref, int *row, int *column)
+    {
+        int col = 0;
+        int i = 0;
+        for(; i < ref.size() && ref.at(i).isLetter(); ++i)
+            col = col * 26 + (ref.at(i).toUpper().unicode() - 'A' + 1);
+        bool ok = false;
+        const int r = ref.mid(i).toInt(&ok);
+        if(col == 0 || !ok || r <= 0)
+            return false;
+        *row = r - 1;
+        *column = col - 1;
+        return true;
+    }
+
+    // 读取当前元素下所有<t>的文本，跳过注音<rPh>，用于共享字符串<si>和内联字符串<is>
+    QString readRichText(QXmlStreamReader &xml)
+    {
+        const QString element = xml.name().toString();
+        QString text;
+        int phonetic = 0;
+        while (!xml.atEnd())
+        {
+            xml.readNext();
+            if(xml.isStartElement())
+            {
+                if(xml.name() == QLatin1String("rPh"))
+                    ++phonetic;
+                else if(xml.name() == QLatin1String("t") && phonetic == 0)
+                    text += xml.readElementText();
+            }
+            else if(xml.isEndElement())
+            {
+                if(xml.name() == QLatin1String("rPh"))
+                    --phonetic;
+                else if(xml.name() == element)
+                    break;
+            }
+        }
+        return text;
+    }
+
+    QString attribute(const QXmlStreamReader &xml, const char *name)
+    {
+        for(const auto &attr : xml.attributes())
+        {
+            if(attr.name() == QLatin1String(name))
+                return attr.value().toString();
+        }
+        return QString();
+    }
+}
+
+bool XlsxReader::open(const QString &fileName)
+{
+    archive.clear();
+    entries.clear();
+    names.clear();
+    sheetPaths.clear();
+    sharedStrings.clear();
+    sharedStringsLoaded = false;
+    error.clear();
+
+    QFile file(fileName);
+    if(!file.open(QIODevice::ReadOnly))
+        return fail(file.errorString());
+    archive = file.readAll();
+
+    // 从尾部向前查找中央目录结束记录（22字节，后跟最长65535字节的注释）
+    const uchar *p = reinterpret_cast<const uchar*>(archive.constData());
+    const qint64 size = archive.size();
+    qint64 eocd = -1;
+    for(qint64 i = size - 22; i >= 0 && i >= size - 22 - 0xFFFF; --i)
+    {
+        if(qFromLittleEndian<quint32>(p + i) == 0x06054b50)
+        {
+            eocd = i;
+            break;
+        }
+    }
+    if(eocd < 0)
+        return fail(QStringLiteral("不是有效的xlsx文件（找不到ZIP目录）"));
+
+    const int count = qFromLittleEndian<quint16>(p + eocd + 10);
+    qint64 offset = qFromLittleEndian<quint32>(p + eocd + 16);
+    for(auto i = 0; i < count; ++i)
+    {
+        if(offset + 46 > size || qFromLittleEndian<quint32>(p + offset) != 0x02014b50)
+            return fail(QStringLiteral("ZIP目录损坏"));
+        const int nameLen = qFromLittleEndian<quint16>(p + offset + 28);
+        const int extraLen = qFromLittleEndian<quint16>(p + offset + 30);
+        const int commentLen = qFromLittleEndian<quint16>(p + offset + 32);
+        if(offset + 46 + nameLen > size)
+            return fail(QStringLiteral("ZIP目录损坏"));
+        ZipEntry e;
+        e.method = qFromLittleEndian<quint16>(p + offset + 10);
+        e.compressedSize = qFromLittleEndian<quint32>(p + offset + 20);
+        e.size = qFromLittleEndian<quint32>(p + offset + 24);
+        e.localHeaderOffset = qFromLittleEndian<quint32>(p + offset + 42);
+        entries.insert(QString::fromUtf8(archive.constData() + offset + 46, nameLen), e);
+        offset += 46 + nameLen + extraLen + commentLen;
+    }
+
+    // 工作表名称及关系ID
+    bool ok = false;
+    QXmlStreamReader workbook(entry(QStringLiteral("xl/workbook.xml"), &ok));
+    if(!ok)
+        return fail(QStringLiteral("缺少xl/workbook.xml"));
+    QHash<QString, QString> nameToId;
+    while (!workbook.atEnd())
+    {
+        workbook.readNext();
+        if(workbook.isStartElement() && workbook.name() == QLatin1String("sheet"))
+        {
+            const QString name = attribute(workbook, "name");
+            names.append(name);
+            // r:id，与sheetId不同
+            nameToId.insert(name, attribute(workbook, "id"));
+        }
+    }
+
+    // 关系ID到工作表XML路径
+    QHash<QString, QString> idToPath;
+    QXmlStreamReader rels(entry(QStringLiteral("xl/_rels/workbook.xml.rels")));
+    while (!rels.atEnd())
+    {
+        rels.readNext();
+        if(rels.isStartElement() && rels.name() == QLatin1String("Relationship"))
+        {
+            QString target = attribute(rels, "Target");
+            // 目标路径相对于xl/，以/开头时为包内绝对路径
+            target = target.startsWith('/') ? target.mid(1) : QStringLiteral("xl/") + target;
+            idToPath.insert(attribute(rels, "Id"), target);
+        }
+    }
+    for(const auto &name : qAsConst(names))
+        sheetPaths.insert(name, idToPath.value(nameToId.value(name)));
+    return true;
+}
+
+QStringList XlsxReader::sheetNames() const
+{
+    return names;
+}
+
+bool XlsxReader::readSheet(const QString &name, Sheet *rows)
+{
+    rows->clear();
+    const QString path = sheetPaths.value(name);
+    if(path.isEmpty())
+        return fail(QStringLiteral("工作表%1不存在").arg(name));
+    if(!readSharedStrings())
+        return false;
+
+    bool ok = false;
+    QXmlStreamReader xml(entry(path, &ok));
+    if(!ok)
+        return fail(QStringLiteral("缺少%1").arg(path));
+
+    // 先按(行, 列)收集有值的单元格，再按已用区域生成矩形表格
+    struct Cell
+    {
+        int row;
+        int column;
+        QString value;
+    };
+    QVector<Cell> cells;
+    int minRow = INT_MAX, minColumn = INT_MAX, maxRow = -1, maxColumn = -1;
+    int row = -1, column = -1;
+    while (!xml.atEnd())
+    {
+        xml.readNext();
+        if(!xml.isStartElement())
+            continue;
+        if(xml.name() == QLatin1String("row"))
+        {
+            bool rowOk = false;
+            const int r = attribute(xml, "r").toInt(&rowOk);
+            row = rowOk ? r - 1 : row + 1;
+            column = -1;
+        }
+        else if(xml.name() == QLatin1String("c"))
+        {
+            const QString ref = attribute(xml, "r");
+            const QString type = attribute(xml, "t");
+            if(ref.isEmpty() || !parseCellRef(ref, &row, &column))
+                ++column;
+
+            QString value;
+            bool hasValue = false;
+            while (xml.readNextStartElement())
+            {
+                if(xml.name() == QLatin1String("v"))
+                {
+                    value = xml.readElementText();
+                    hasValue = true;
+                }
+                else if(xml.name() == QLatin1String("is"))
+                {
+                    value = readRichText(xml);
+                    hasValue = true;
+                }
+                else
+                {
+                    xml.skipCurrentElement();
+                }
+            }
+            if(!hasValue)
+                continue;
+
+            if(type == QLatin1String("s"))
+                value = sharedStrings.value(value.toInt());
+            else if(type == QLatin1String("b"))
+                value = value == QLatin1String("1") ? QStringLiteral("true") : QStringLiteral("false");
+            else if(type.isEmpty() || type == QLatin1String("n"))
+                // 与Excel返回的double转字符串一致：整数不带小数点，小数取最短表示
+                value = QString::number(value.toDouble(), 'g', QLocale::FloatingPointShortest);
+
+            cells.append(Cell{row, column, value});
+            minRow = qMin(minRow, row);
+            maxRow = qMax(maxRow, row);
+            minColumn = qMin(minColumn, column);
+            maxColumn = qMax(maxColumn, column);
+        }
+    }
+    if(xml.hasError())
+        return fail(QStringLiteral("%1解析失败：%2").arg(path, xml.errorString()));
+    if(cells.isEmpty())
+        return true;
+
+    rows->resize(maxRow - minRow + 1);
+    for(auto &r : *rows)
+        r.resize(maxColumn - minColumn + 1);
+    for(const auto &cell : qAsConst(cells))
+        (*rows)[cell.row - minRow][cell.column - minColumn] = cell.value;
+    return true;
+}
+
+QString XlsxReader::errorString() const
+{
+    return error;
+}
+
+QByteArray XlsxReader::entry(const QString &name, bool *ok)
+{
+    if(ok)
+        *ok = false;
+    auto it = entries.constFind(name);
+    if(it == entries.constEnd())
+        return QByteArray();
+
+    const ZipEntry &e = it.value();
+    const uchar *p = reinterpret_cast<const uchar*>(archive.constData());
+    const qint64 offset = e.localHeaderOffset;
+    if(offset + 30 > archive.size() || qFromLittleEndian<quint32>(p + offset) != 0x04034b50)
+        return QByteArray();
+    const qint64 dataOffset = offset + 30 + qFromLittleEndian<quint16>(p + offset + 26)
+                                         + qFromLittleEndian<quint16>(p + offset + 28);
+    if(dataOffset + e.compressedSize > archive.size())
+        return QByteArray();
+
+    if(e.method == 0)
+    {
+        if(ok)
+            *ok = true;
+        return archive.mid(int(dataOffset), int(e.compressedSize));
+    }
+    if(e.method != 8)
+        return QByteArray();
+    Inflater inflater(p + dataOffset, e.compressedSize, e.size);
+    if(!inflater.run())
+        return QByteArray();
+    if(ok)
+        *ok = true;
+    return inflater.result();
+}
+
+bool XlsxReader::readSharedStrings()
+{
+    if(sharedStringsLoaded)
+        return true;
+    // 没有字符串的工作簿可以不含sharedStrings.xml
+    QXmlStreamReader xml(entry(QStringLiteral("xl/sharedStrings.xml")));
+    while (!xml.atEnd())
+    {
+        xml.readNext();
+        if(xml.isStartElement() && xml.name() == QLatin1String("si"))
+            sharedStrings.append(readRichText(xml));
+    }
+    if(xml.hasError() && xml.error() != QXmlStreamReader::PrematureEndOfDocumentError)
+        return fail(QStringLiteral("xl/sharedStrings.xml解析失败：%1").arg(xml.errorString()));
+    sharedStringsLoaded = true;
+    return true;
+}
+
+bool XlsxReader::fail(const QString &reason)
+{
+    error = reason;
+    return false;
+}
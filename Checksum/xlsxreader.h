@@ -0,0 +1,58 @@
+#ifndef XLSXREADER_H
+#define XLSXREADER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/*********************************************************************************
+** 文件描述：       Excel工作簿（.xlsx）只读解析
+** 设计：          .xlsx是ZIP压缩包中的一组XML文件：xl/workbook.xml给出工作表名称，
+**                xl/_rels/workbook.xml.rels给出各工作表的XML路径，xl/sharedStrings.xml
+**                保存共享字符串，工作表XML中的单元格按引用（如B3）给出值。
+**                本类自行解析ZIP目录并解压（Deflate），用QXmlStreamReader读取XML，
+**                只依赖QtCore，不需要安装Excel，也不经过COM自动化。
+**                readSheet()返回与Excel UsedRange.Value相同的矩形区域：从第一个有值的
+**                行列到最后一个有值的行列，空单元格为空字符串。
+**********************************************************************************/
+class XlsxReader
+{
+public:
+    typedef QVector<QVector<QString>> Sheet;
+
+    // 打开并解析工作簿目录，失败返回false，原因见errorString()
+    bool open(const QString &fileName);
+    // 工作簿中所有工作表的名称
+    QStringList sheetNames() const;
+    // 读取名为name的工作表，工作表不存在或解析失败返回false
+    bool readSheet(const QString &name, Sheet *rows);
+
+    QString errorString() const;
+
+private:
+    // 解压ZIP中名为name的文件，不存在或损坏时返回空
+    QByteArray entry(const QString &name, bool *ok = nullptr);
+    bool readSharedStrings();
+    bool fail(const QString &reason);
+
+    struct ZipEntry
+    {
+        quint16 method;         // 0：不压缩，8：Deflate
+        qint64 compressedSize;
+        qint64 size;
+        qint64 localHeaderOffset;
+    };
+
+    QByteArray archive;
+    QHash<QString, ZipEntry> entries;
+    // 工作表名称（按工作簿中的顺序）及其XML路径
+    QStringList names;
+    QHash<QString, QString> sheetPaths;
+    QVector<QString> sharedStrings;
+    bool sharedStringsLoaded = false;
+    QString error;
+};
+
+#endif // XLSXREADER_H
@@ -0,0 +1,632 @@
+#include "xxh3.h"
+#include "cpufeatures.h"
+#include <QtEndian>
+#include <cstring>
+
+#ifdef CPU_HAVE_X86_SIMD
+#  include <immintrin.h>
+#endif
+
+namespace
+{
+    constexpr quint32 Prime32_1 = 0x9E3779B1U;
+    constexpr quint32 Prime32_2 = 0x85EBCA77U;
+    constexpr quint32 Prime32_3 = 0xC2B2AE3DU;
+    constexpr quint64 Prime64_1 = 0x9E3779B185EBCA87ULL;
+    constexpr quint64 Prime64_2 = 0xC2B2AE3D27D4EB4FULL;
+    constexpr quint64 Prime64_3 = 0x165667B19E3779F9ULL;
+    constexpr quint64 Prime64_4 = 0x85EBCA77C2B2AE63ULL;
+    constexpr quint64 Prime64_5 = 0x27D4EB2F165667C5ULL;
+    constexpr quint64 PrimeMx1 = 0x165667919E3779F9ULL;
+    constexpr quint64 PrimeMx2 = 0x9FB21C651E98DF25ULL;
+
+    // 默认密钥
+    alignas(64) const uchar Secret[192] = {
+        0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+        0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+        0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+        0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+        0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+        0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+        0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+        0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+        0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+        0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+        0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+        0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+    };
+    constexpr int SecretSize = int(sizeof(Secret));
+    // 短输入分段的界限
+    constexpr int MidSizeMax = 240;
+    constexpr int SecretSizeMin = 136;
+    constexpr int MidSizeStartOffset = 3;
+    constexpr int MidSizeLastOffset = 17;
+    // 每个条带密钥前移的字节数、每块条带数
+    constexpr int SecretConsumeRate = 8;
+    constexpr int StripesPerBlock = (SecretSize - Xxh3::StripeLen) / SecretConsumeRate;
+    // 扰乱、合并、最后一个条带使用的密钥位置
+    constexpr int SecretLimit = SecretSize - Xxh3::StripeLen;
+    constexpr int MergeAccsStart = 11;
+    constexpr int LastAccStart = 7;
+
+    inline quint32 readLE32(const uchar *p)
+    {
+        return qFromLittleEndian<quint32>(p);
+    }
+
+    inline quint64 readLE64(const uchar *p)
+    {
+        return qFromLittleEndian<quint64>(p);
+    }
+
+    inline quint64 swap64(quint64 x)
+    {
+        return qbswap(x);
+    }
+
+    inline quint32 rotl32(quint32 x, int r)
+    {
+        return (x << r) | (x >> (32 - r));
+    }
+
+    inline quint64 rotl64(quint64 x, int r)
+    {
+        return (x << r) | (x >> (64 - r));
+    }
+
+    // 64×64→128位乘法，返回低64位
+    inline quint64 mul128(quint64 a, quint64 b, quint64 *high)
+    {
+#if defined(__SIZEOF_INT128__)
+        const unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+        *high = quint64(product >> 64);
+        return quint64(product);
+#else
+        const quint64 loLo = (a & 0xFFFFFFFF) * (b & 0xFFFFFFFF);
+        const quint64 hiLo = (a >> 32) * (b & 0xFFFFFFFF);
+        const quint64 loHi = (a & 0xFFFFFFFF) * (b >> 32);
+        const quint64 hiHi = (a >> 32) * (b >> 32);
+        const quint64 cross = (loLo >> 32) + (hiLo & 0xFFFFFFFF) + loHi;
+        *high = (hiLo >> 32) + (cross >> 32) + hiHi;
+        return (cross << 32) | (loLo & 0xFFFFFFFF);
+#endif
+    }
+
+    // 128位乘积的高、低64位异或
+    inline quint64 mulFold64(quint64 a, quint64 b)
+    {
+        quint64 high;
+        const quint64 low = mul128(a, b, &high);
+        return low ^ high;
+    }
+
+    inline quint64 xxh64Avalanche(quint64 h)
+    {
+        h ^= h >> 33;
+        h *= Prime64_2;
+        h ^= h >> 29;
+        h *= Prime64_3;
+        h ^= h >> 32;
+        return h;
+    }
+
+    inline quint64 avalanche(quint64 h)
+    {
+        h ^= h >> 37;
+        h *= PrimeMx1;
+        h ^= h >> 32;
+        return h;
+    }
+
+    inline quint64 rrmxmx(quint64 h, quint64 len)
+    {
+        h ^= rotl64(h, 49) ^ rotl64(h, 24);
+        h *= PrimeMx2;
+        h ^= (h >> 35) + len;
+        h *= PrimeMx2;
+        h ^= h >> 28;
+        return h;
+    }
+
+    inline quint64 mix16B(const uchar *input, const uchar *secret)
+    {
+        return mulFold64(readLE64(input) ^ readLE64(secret), readLE64(input + 8) ^ readLE64(secret + 8));
+    }
+
+    /************************************ 64位短输入 ************************************/
+
+    quint64 len0To16_64(const uchar *input, size_t len)
+    {
+        if(len > 8)
+        {
+            const quint64 bitflip1 = readLE64(Secret + 24) ^ readLE64(Secret + 32);
+            const quint64 bitflip2 = readLE64(Secret + 40) ^ readLE64(Secret + 48);
+            const quint64 lo = readLE64(input) ^ bitflip1;
+            const quint64 hi = readLE64(input + len - 8) ^ bitflip2;
+            return avalanche(len + swap64(lo) + hi + mulFold64(lo, hi));
+        }
+        if(len >= 4)
+        {
+            const quint64 input64 = readLE32(input + len - 4) + (quint64(readLE32(input)) << 32);
+            const quint64 bitflip = readLE64(Secret + 8) ^ readLE64(Secret + 16);
+            return rrmxmx(input64 ^ bitflip, len);
+        }
+        if(len > 0)
+        {
+            const quint32 combined = (quint32(input[0]) << 16) | (quint32(input[len >> 1]) << 24)
+                                   | quint32(input[len - 1]) | (quint32(len) << 8);
+            const quint64 bitflip = readLE32(Secret) ^ readLE32(Secret + 4);
+            return xxh64Avalanche(combined ^ bitflip);
+        }
+        return xxh64Avalanche(readLE64(Secret + 56) ^ readLE64(Secret + 64));
+    }
+
+    quint64 len17To128_64(const uchar *input, size_t len)
+    {
+        quint64 acc = len * Prime64_1;
+        if(len > 32)
+        {
+            if(len > 64)
+            {
+                if(len > 96)
+                {
+                    acc += mix16B(input + 48, Secret + 96);
+                    acc += mix16B(input + len - 64, Secret + 112);
+                }
+                acc += mix16B(input + 32, Secret + 64);
+                acc += mix16B(input + len - 48, Secret + 80);
+            }
+            acc += mix16B(input + 16, Secret + 32);
+            acc += mix16B(input + len - 32, Secret + 48);
+        }
+        acc += mix16B(input, Secret);
+        acc += mix16B(input + len - 16, Secret + 16);
+        return avalanche(acc);
+    }
+
+    quint64 len129To240_64(const uchar *input, size_t len)
+    {
+        const int rounds = int(len / 16);
+        quint64 acc = len * Prime64_1;
+        for(auto i = 0; i < 8; ++i)
+            acc += mix16B(input + 16 * i, Secret + 16 * i);
+        acc = avalanche(acc);
+        quint64 accEnd = mix16B(input + len - 16, Secret + SecretSizeMin - MidSizeLastOffset);
+        for(auto i = 8; i < rounds; ++i)
+            accEnd += mix16B(input + 16 * i, Secret + 16 * (i - 8) + MidSizeStartOffset);
+        return avalanche(acc + accEnd);
+    }
+
+    quint64 short64(const uchar *input, size_t len)
+    {
+        if(len <= 16)
+            return len0To16_64(input, len);
+        if(len <= 128)
+            return len17To128_64(input, len);
+        return len129To240_64(input, len);
+    }
+
+    /************************************ 128位短输入 ************************************/
+
+    struct Hash128
+    {
+        quint64 low;
+        quint64 high;
+    };
+
+    Hash128 len0To16_128(const uchar *input, size_t len)
+    {
+        Hash128 h;
+        if(len > 8)
+        {
+            const quint64 bitflipl = readLE64(Secret + 32) ^ readLE64(Secret + 40);
+            const quint64 bitfliph = readLE64(Secret + 48) ^ readLE64(Secret + 56);
+            const quint64 lo = readLE64(input);
+            quint64 hi = readLE64(input + len - 8);
+            quint64 mHigh;
+            quint64 mLow = mul128(lo ^ hi ^ bitflipl, Prime64_1, &mHigh);
+            mLow += quint64(len - 1) << 54;
+            hi ^= bitfliph;
+            mHigh += hi + quint64(quint32(hi)) * (Prime32_2 - 1);
+            mLow ^= swap64(mHigh);
+            h.low = mul128(mLow, Prime64_2, &h.high);
+            h.high += mHigh * Prime64_2;
+            h.low = avalanche(h.low);
+            h.high = avalanche(h.high);
+            return h;
+        }
+        if(len >= 4)
+        {
+            const quint64 input64 = readLE32(input) + (quint64(readLE32(input + len - 4)) << 32);
+            const quint64 bitflip = readLE64(Secret + 16) ^ readLE64(Secret + 24);
+            h.low = mul128(input64 ^ bitflip, Prime64_1 + (len << 2), &h.high);
+            h.high += h.low << 1;
+            h.low ^= h.high >> 3;
+            h.low ^= h.low >> 35;
+            h.low *= PrimeMx2;
+            h.low ^= h.low >> 28;
+            h.high = avalanche(h.high);
+            return h;
+        }
+        if(len > 0)
+        {
+            const quint32 combinedl = (quint32(input[0]) << 16) | (quint32(input[len >> 1]) << 24)
+                                    | quint32(input[len - 1]) | (quint32(len) << 8);
+            const quint32 combinedh = rotl32(qbswap(combinedl), 13);
+            const quint64 bitflipl = readLE32(Secret) ^ readLE32(Secret + 4);
+            const quint64 bitfliph = readLE32(Secret + 8) ^ readLE32(Secret + 12);
+            h.low = xxh64Avalanche(combinedl ^ bitflipl);
+            h.high = xxh64Avalanche(combinedh ^ bitfliph);
+            return h;
+        }
+        h.low = xxh64Avalanche(readLE64(Secret + 64) ^ readLE64(Secret + 72));
+        h.high = xxh64Avalanche(readLE64(Secret + 80) ^ readLE64(Secret + 88));
+        return h;
+    }
+
+    inline void mix32B(Hash128 *acc, const uchar *input1, const uchar *input2, const uchar *secret)
+    {
+        acc->low += mix16B(input1, secret);
+        acc->low ^= readLE64(input2) + readLE64(input2 + 8);
+        acc->high += mix16B(input2, secret + 16);
+        acc->high ^= readLE64(input1) + readLE64(input1 + 8);
+    }
+
+    Hash128 finish17To240_128(const Hash128 &acc, size_t len)
+    {
+        Hash128 h;
+        h.low = avalanche(acc.low + acc.high);
+        h.high = quint64(0) - avalanche(acc.low * Prime64_1 + acc.high * Prime64_4 + len * Prime64_2);
+        return h;
+    }
+
+    Hash128 len17To128_128(const uchar *input, size_t len)
+    {
+        Hash128 acc = { len * Prime64_1, 0 };
+        if(len > 32)
+        {
+            if(len > 64)
+            {
+                if(len > 96)
+                    mix32B(&acc, input + 48, input + len - 64, Secret + 96);
+                mix32B(&acc, input + 32, input + len - 48, Secret + 64);
+            }
+            mix32B(&acc, input + 16, input + len - 32, Secret + 32);
+        }
+        mix32B(&acc, input, input + len - 16, Secret);
+        return finish17To240_128(acc, len);
+    }
+
+    Hash128 len129To240_128(const uchar *input, size_t len)
+    {
+        Hash128 acc = { len * Prime64_1, 0 };
+        size_t i;
+        for(i = 32; i < 160; i += 32)
+            mix32B(&acc, input + i - 32, input + i - 16, Secret + i - 32);
+        acc.low = avalanche(acc.low);
+        acc.high = avalanche(acc.high);
+        // len为32的倍数时最后32字节会重复混合一次，这是规范的一部分
+        for(i = 160; i <= len; i += 32)
+            mix32B(&acc, input + i - 32, input + i - 16, Secret + MidSizeStartOffset + i - 160);
+        mix32B(&acc, input + len - 16, input + len - 32, Secret + SecretSizeMin - MidSizeLastOffset - 16);
+        return finish17To240_128(acc, len);
+    }
+
+    Hash128 short128(const uchar *input, size_t len)
+    {
+        if(len <= 16)
+            return len0To16_128(input, len);
+        if(len <= 128)
+            return len17To128_128(input, len);
+        return len129To240_128(input, len);
+    }
+
+    /************************************ 长输入 ************************************/
+
+    // 累加stripes个条带（第n个条带使用secret + n·8处的密钥）
+    typedef void (*AccumulateFunc)(quint64 *acc, const uchar *input, const uchar *secret, size_t stripes);
+    // 扰乱累加器
+    typedef void (*ScrambleFunc)(quint64 *acc, const uchar *secret);
+
+    inline void accumulate512Scalar(quint64 *acc, const uchar *input, const uchar *secret)
+    {
+        for(auto i = 0; i < 8; ++i)
+        {
+            const quint64 data = readLE64(input + 8 * i);
+            const quint64 key = data ^ readLE64(secret + 8 * i);
+            acc[i ^ 1] += data;
+            acc[i] += quint64(quint32(key)) * (key >> 32);
+        }
+    }
+
+#ifdef CPU_HAVE_X86_SIMD
+    // 每个64位通道：acc[i^1] += data，acc[i] += (data^key)低32位 × 高32位
+    void accumulateSse2(quint64 *acc, const uchar *input, const uchar *secret, size_t stripes)
+    {
+        __m128i *const a = reinterpret_cast<__m128i*>(acc);
+        __m128i a0 = _mm_loadu_si128(a);
+        __m128i a1 = _mm_loadu_si128(a + 1);
+        __m128i a2 = _mm_loadu_si128(a + 2);
+        __m128i a3 = _mm_loadu_si128(a + 3);
+        const auto step = [](__m128i acc, const uchar *in, const uchar *key) {
+            const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+            const __m128i dataKey = _mm_xor_si128(data, _mm_loadu_si128(reinterpret_cast<const __m128i*>(key)));
+            const __m128i product = _mm_mul_epu32(dataKey, _mm_shuffle_epi32(dataKey, _MM_SHUFFLE(0, 3, 0, 1)));
+            const __m128i sum = _mm_add_epi64(acc, _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2)));
+            return _mm_add_epi64(product, sum);
+        };
+        for(size_t n = 0; n < stripes; ++n, input += Xxh3::StripeLen, secret += SecretConsumeRate)
+        {
+            a0 = step(a0, input, secret);
+            a1 = step(a1, input + 16, secret + 16);
+            a2 = step(a2, input + 32, secret + 32);
+            a3 = step(a3, input + 48, secret + 48);
+        }
+        _mm_storeu_si128(a, a0);
+        _mm_storeu_si128(a + 1, a1);
+        _mm_storeu_si128(a + 2, a2);
+        _mm_storeu_si128(a + 3, a3);
+    }
+
+    void scrambleSse2(quint64 *acc, const uchar *secret)
+    {
+        __m128i *const a = reinterpret_cast<__m128i*>(acc);
+        const __m128i prime = _mm_set1_epi32(int(Prime32_1));
+        for(auto i = 0; i < 4; ++i)
+        {
+            __m128i v = _mm_loadu_si128(a + i);
+            v = _mm_xor_si128(v, _mm_srli_epi64(v, 47));
+            v = _mm_xor_si128(v, _mm_loadu_si128(reinterpret_cast<const __m128i*>(secret + 16 * i)));
+            // 64位×32位：低32位乘积加上高32位乘积左移32位
+            const __m128i productLo = _mm_mul_epu32(v, prime);
+            const __m128i productHi = _mm_mul_epu32(_mm_shuffle_epi32(v, _MM_SHUFFLE(0, 3, 0, 1)), prime);
+            _mm_storeu_si128(a + i, _mm_add_epi64(productLo, _mm_slli_epi64(productHi, 32)));
+        }
+    }
+
+    CPU_TARGET("avx2")
+    void accumulateAvx2(quint64 *acc, const uchar *input, const uchar *secret, size_t stripes)
+    {
+        __m256i *const a = reinterpret_cast<__m256i*>(acc);
+        __m256i a0 = _mm256_loadu_si256(a);
+        __m256i a1 = _mm256_loadu_si256(a + 1);
+        for(size_t n = 0; n < stripes; ++n, input += Xxh3::StripeLen, secret += SecretConsumeRate)
+        {
+            const __m256i data0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input));
+            const __m256i data1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + 32));
+            const __m256i dataKey0 = _mm256_xor_si256(data0, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(secret)));
+            const __m256i dataKey1 = _mm256_xor_si256(data1, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(secret + 32)));
+            const __m256i product0 = _mm256_mul_epu32(dataKey0, _mm256_shuffle_epi32(dataKey0, _MM_SHUFFLE(0, 3, 0, 1)));
+            const __m256i product1 = _mm256_mul_epu32(dataKey1, _mm256_shuffle_epi32(dataKey1, _MM_SHUFFLE(0, 3, 0, 1)));
+            a0 = _mm256_add_epi64(_mm256_add_epi64(a0, _mm256_shuffle_epi32(data0, _MM_SHUFFLE(1, 0, 3, 2))), product0);
+            a1 = _mm256_add_epi64(_mm256_add_epi64(a1, _mm256_shuffle_epi32(data1, _MM_SHUFFLE(1, 0, 3, 2))), product1);
+        }
+        _mm256_storeu_si256(a, a0);
+        _mm256_storeu_si256(a + 1, a1);
+        _mm256_zeroupper();
+    }
+
+    CPU_TARGET("avx2")
+    void scrambleAvx2(quint64 *acc, const uchar *secret)
+    {
+        __m256i *const a = reinterpret_cast<__m256i*>(acc);
+        const __m256i prime = _mm256_set1_epi32(int(Prime32_1));
+        for(auto i = 0; i < 2; ++i)
+        {
+            __m256i v = _mm256_loadu_si256(a + i);
+            v = _mm256_xor_si256(v, _mm256_srli_epi64(v, 47));
+            v = _mm256_xor_si256(v, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(secret + 32 * i)));
+            const __m256i productLo = _mm256_mul_epu32(v, prime);
+            const __m256i productHi = _mm256_mul_epu32(_mm256_shuffle_epi32(v, _MM_SHUFFLE(0, 3, 0, 1)), prime);
+            _mm256_storeu_si256(a + i, _mm256_add_epi64(productLo, _mm256_slli_epi64(productHi, 32)));
+        }
+        _mm256_zeroupper();
+    }
+#else
+    void accumulateScalar(quint64 *acc, const uchar *input, const uchar *secret, size_t stripes)
+    {
+        for(size_t n = 0; n < stripes; ++n)
+            accumulate512Scalar(acc, input + n * Xxh3::StripeLen, secret + n * SecretConsumeRate);
+    }
+
+    void scrambleScalar(quint64 *acc, const uchar *secret)
+    {
+        for(auto i = 0; i < 8; ++i)
+        {
+            quint64 a = acc[i];
+            a ^= a >> 47;
+            a ^= readLE64(secret + 8 * i);
+            acc[i] = a * Prime32_1;
+        }
+    }
+#endif // CPU_HAVE_X86_SIMD
+
+    struct Kernels
+    {
+        AccumulateFunc accumulate;
+        ScrambleFunc scramble;
+    };
+
+    const Kernels &kernels()
+    {
+#ifdef CPU_HAVE_X86_SIMD
+        static const Kernels k = CpuFeatures::hasAvx2() ? Kernels{ accumulateAvx2, scrambleAvx2 }
+                                                        : Kernels{ accumulateSse2, scrambleSse2 };
+#else
+        static const Kernels k = { accumulateScalar, scrambleScalar };
+#endif
+        return k;
+    }
+
+    // 从当前块的第*stripesSoFar个条带开始累加stripes个条带，块满时扰乱，返回输入的结束位置
+    const uchar *consumeStripes(quint64 *acc, int *stripesSoFar, const uchar *input, size_t stripes)
+    {
+        const Kernels &k = kernels();
+        const uchar *secret = Secret + *stripesSoFar * SecretConsumeRate;
+        if(stripes >= size_t(StripesPerBlock - *stripesSoFar))
+        {
+            size_t thisBlock = size_t(StripesPerBlock - *stripesSoFar);
+            do
+            {
+                k.accumulate(acc, input, secret, thisBlock);
+                k.scramble(acc, Secret + SecretLimit);
+                input += thisBlock * Xxh3::StripeLen;
+                stripes -= thisBlock;
+                thisBlock = StripesPerBlock;
+                secret = Secret;
+            } while (stripes >= size_t(StripesPerBlock));
+            *stripesSoFar = 0;
+        }
+        if(stripes > 0)
+        {
+            k.accumulate(acc, input, secret, stripes);
+            input += stripes * Xxh3::StripeLen;
+            *stripesSoFar += int(stripes);
+        }
+        return input;
+    }
+
+    quint64 mergeAccs(const quint64 *acc, const uchar *secret, quint64 start)
+    {
+        quint64 result = start;
+        for(auto i = 0; i < 4; ++i)
+            result += mulFold64(acc[2 * i] ^ readLE64(secret + 16 * i), acc[2 * i + 1] ^ readLE64(secret + 16 * i + 8));
+        return avalanche(result);
+    }
+}
+
+Xxh3::Xxh3()
+{
+    init();
+}
+
+void Xxh3::init()
+{
+    acc[0] = Prime32_3;
+    acc[1] = Prime64_1;
+    acc[2] = Prime64_2;
+    acc[3] = Prime64_3;
+    acc[4] = Prime64_4;
+    acc[5] = Prime32_2;
+    acc[6] = Prime64_5;
+    acc[7] = Prime32_1;
+    bufferedSize = 0;
+    stripesSoFar = 0;
+    totalLen = 0;
+}
+
+void Xxh3::update(const char *data, qint64 dataLen)
+{
+    if(dataLen <= 0)
+        return;
+    const uchar *input = reinterpret_cast<const uchar*>(data);
+    const uchar *const end = input + dataLen;
+    totalLen += quint64(dataLen);
+    if(dataLen <= BufferSize - bufferedSize)
+    {
+        memcpy(buffer + bufferedSize, input, size_t(dataLen));
+        bufferedSize += int(dataLen);
+        return;
+    }
+
+    // 缓存填满后累加，但只在确定后面还有数据时才累加，最后一个条带总是留到结束时处理
+    if(bufferedSize > 0)
+    {
+        const int loadSize = BufferSize - bufferedSize;
+        memcpy(buffer + bufferedSize, input, size_t(loadSize));
+        input += loadSize;
+        consumeStripes(acc, &stripesSoFar, buffer, BufferSize / StripeLen);
+        bufferedSize = 0;
+    }
+    if(end - input > BufferSize)
+    {
+        const size_t stripes = size_t(end - 1 - input) / StripeLen;
+        input = consumeStripes(acc, &stripesSoFar, input, stripes);
+        // 剩余数据不足一个条带时，结束时要用到最后一个已累加的条带
+        memcpy(buffer + BufferSize - StripeLen, input - StripeLen, StripeLen);
+    }
+    memcpy(buffer, input, size_t(end - input));
+    bufferedSize = int(end - input);
+}
+
+void Xxh3::digestLong(quint64 *accCopy) const
+{
+    memcpy(accCopy, acc, sizeof(acc));
+    uchar lastStripe[StripeLen];
+    const uchar *lastStripePtr;
+    if(bufferedSize >= StripeLen)
+    {
+        int stripes = stripesSoFar;
+        consumeStripes(accCopy, &stripes, buffer, size_t(bufferedSize - 1) / StripeLen);
+        lastStripePtr = buffer + bufferedSize - StripeLen;
+    }
+    else
+    {
+        // 最后一个条带由上次留下的数据末尾和缓存中的数据拼成
+        const int catchupSize = StripeLen - bufferedSize;
+        memcpy(lastStripe, buffer + BufferSize - catchupSize, size_t(catchupSize));
+        memcpy(lastStripe + catchupSize, buffer, size_t(bufferedSize));
+        lastStripePtr = lastStripe;
+    }
+    accumulate512Scalar(accCopy, lastStripePtr, Secret + SecretLimit - LastAccStart);
+}
+
+quint64 Xxh3::digest64() const
+{
+    if(totalLen <= quint64(MidSizeMax))
+        return short64(buffer, size_t(totalLen));
+    alignas(32) quint64 accCopy[8];
+    digestLong(accCopy);
+    return mergeAccs(accCopy, Secret + MergeAccsStart, totalLen * Prime64_1);
+}
+
+quint64 Xxh3::digest128(quint64 *high) const
+{
+    if(totalLen <= quint64(MidSizeMax))
+    {
+        const Hash128 h = short128(buffer, size_t(totalLen));
+        *high = h.high;
+        return h.low;
+    }
+    alignas(32) quint64 accCopy[8];
+    digestLong(accCopy);
+    *high = mergeAccs(accCopy, Secret + SecretSize - StripeLen - MergeAccsStart, ~(totalLen * Prime64_2));
+    return mergeAccs(accCopy, Secret + MergeAccsStart, totalLen * Prime64_1);
+}
+
+quint64 Xxh3::hash64(const char *data, qint64 dataLen)
+{
+    if(dataLen <= MidSizeMax)
+        return short64(reinterpret_cast<const uchar*>(data), size_t(qMax<qint64>(dataLen, 0)));
+    Xxh3 state;
+    state.update(data, dataLen);
+    return state.digest64();
+}
+
+quint64 Xxh3::hash128(const char *data, qint64 dataLen, quint64 *high)
+{
+    if(dataLen <= MidSizeMax)
+    {
+        const Hash128 h = short128(reinterpret_cast<const uchar*>(data), size_t(qMax<qint64>(dataLen, 0)));
+        *high = h.high;
+        return h.low;
+    }
+    Xxh3 state;
+    state.update(data, dataLen);
+    return state.digest128(high);
+}
+
+QByteArray Xxh3::canonical64(quint64 hash)
+{
+    QByteArray out(8, 0);
+    qToBigEndian(hash, out.data());
+    return out;
+}
+
+QByteArray Xxh3::canonical128(quint64 high, quint64 low)
+{
+    QByteArray out(16, 0);
+    qToBigEndian(high, out.data());
+    qToBigEndian(low, out.data() + 8);
+    return out;
+}
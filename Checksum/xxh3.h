@@ -0,0 +1,57 @@
+#ifndef XXH3_H
+#define XXH3_H
+
+#include <QByteArray>
+#include <QtGlobal>
+
+/*********************************************************************************
+** 文件描述：       xxHash3（XXH3）64位、128位非加密摘要
+** 设计：          按xxHash 0.8的XXH3规范实现，使用默认密钥、种子为0，结果与官方
+**                XXH3_64bits()、XXH3_128bits()相同。
+**                不超过240字节的输入按长度分段直接混合；更长的输入由8个64位累加器
+**                按64字节条带累加，每16个条带（一个块）扰乱一次累加器，最后合并。
+**                流式计算时内部缓存256字节：总长度不超过240字节时最后一次性计算，
+**                否则始终保留最后一个条带，保证结束时与一次性计算的分段完全一致。
+**                条带累加是主要开销，x86-64上用SSE2（总是可用）或AVX2（运行时检测）实现，
+**                每个条带只需4/2次向量乘加，单线程即可达到内存带宽级别的速度。
+**                64位和128位结果共用同一累加状态，只在结束时的合并方式不同。
+**********************************************************************************/
+
+class Xxh3
+{
+public:
+    Xxh3();
+
+    // 重新开始计算
+    void init();
+    // 输入一段数据
+    void update(const char *data, qint64 dataLen);
+    // 64位结果
+    quint64 digest64() const;
+    // 128位结果，高64位存放在high中
+    quint64 digest128(quint64 *high) const;
+
+    // 一次性计算data的64位、128位结果
+    static quint64 hash64(const char *data, qint64 dataLen);
+    static quint64 hash128(const char *data, qint64 dataLen, quint64 *high);
+    // 按官方规范的字节序（大端）输出结果
+    static QByteArray canonical64(quint64 hash);
+    static QByteArray canonical128(quint64 high, quint64 low);
+
+    // 内部缓存长度和条带长度
+    static constexpr int BufferSize = 256;
+    static constexpr int StripeLen = 64;
+
+private:
+    // 把缓存中的剩余数据并入累加器的副本，用于结束时合并
+    void digestLong(quint64 *acc) const;
+
+    alignas(32) quint64 acc[8];
+    alignas(32) uchar buffer[BufferSize];
+    int bufferedSize;
+    // 当前块已累加的条带数
+    int stripesSoFar;
+    quint64 totalLen;
+};
+
+#endif // XXH3_H
@@ -1,9 +1,9 @@
-QT += widgets axcontainer core
+QT += widgets core
 
 TEMPLATE = lib
 DEFINES += UDPTEST_LIBRARY
 
-CONFIG += c++11
+CONFIG += c++17
 
 # You can make your code fail to compile if it uses deprecated APIs.
 # In order to do so, uncomment the following line.
@@ -11,11 +11,15 @@ CONFIG += c++11
 
 #包含接口文件路径
 INCLUDEPATH    += ../../framework
+#校验、摘要算法静态库
+include(../../Checksum/checksum.pri)
 #指定编译生成的dll文件目录
 DESTDIR     = ../Plugin
 
 SOURCES += \
+    bytepiecetable.cpp \
     datacheckform.cpp \
+    hexedit.cpp \
     numberconvertform.cpp \
     typeconvert.cpp \
     udpform.cpp \
@@ -24,7 +28,9 @@ SOURCES += \
 
 HEADERS += \
     UDPTest_global.h \
+    bytepiecetable.h \
     datacheckform.h \
+    hexedit.h \
     numberconvertform.h \
     typeconvert.h \
     udpform.h \
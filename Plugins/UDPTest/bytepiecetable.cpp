@@ -0,0 +1,161 @@
+#include "bytepiecetable.h"
+#include <algorithm>
+#include <cstring>
+
+BytePieceTable::BytePieceTable()
+{
+}
+
+void BytePieceTable::setData(const QByteArray &data)
+{
+    original = data;
+    addBuffer.clear();
+    pieces.clear();
+    ends.clear();
+    if(!data.isEmpty())
+    {
+        pieces.append(Piece{ false, 0, data.size() });
+        ends.append(data.size());
+    }
+}
+
+void BytePieceTable::clear()
+{
+    setData(QByteArray());
+}
+
+int BytePieceTable::findPiece(qint64 pos, qint64 *offset) const
+{
+    // 第一个末尾位置大于pos的段
+    const int i = int(std::upper_bound(ends.constBegin(), ends.constEnd(), pos) - ends.constBegin());
+    *offset = i < ends.size() ? pos - (i > 0 ? ends[i - 1] : 0) : 0;
+    return i;
+}
+
+int BytePieceTable::splitAt(qint64 pos)
+{
+    qint64 offset;
+    const int i = findPiece(pos, &offset);
+    if(i >= pieces.size() || offset == 0)
+        return i;
+    const Piece tail{ pieces[i].added, pieces[i].start + offset, pieces[i].length - offset };
+    pieces[i].length = offset;
+    pieces.insert(i + 1, tail);
+    ends.insert(i + 1, ends[i]);
+    ends[i] -= tail.length;
+    return i + 1;
+}
+
+void BytePieceTable::updateEnds(int from)
+{
+    qint64 end = from > 0 ? ends[from - 1] : 0;
+    for(auto i = from; i < pieces.size(); ++i)
+    {
+        end += pieces[i].length;
+        ends[i] = end;
+    }
+}
+
+void BytePieceTable::insert(qint64 pos, const char *data, qint64 len)
+{
+    if(len <= 0 || pos < 0 || pos > size())
+        return;
+    // 紧接在添加缓冲区最后一段之后输入时直接延长该段
+    if(pos > 0)
+    {
+        qint64 offset;
+        const int i = findPiece(pos - 1, &offset);
+        Piece &piece = pieces[i];
+        if(piece.added && offset == piece.length - 1 && piece.start + piece.length == addBuffer.size())
+        {
+            addBuffer.append(data, int(len));
+            piece.length += len;
+            updateEnds(i);
+            return;
+        }
+    }
+    const qint64 start = addBuffer.size();
+    addBuffer.append(data, int(len));
+    const int i = splitAt(pos);
+    pieces.insert(i, Piece{ true, start, len });
+    ends.insert(i, 0);
+    updateEnds(i);
+}
+
+void BytePieceTable::remove(qint64 pos, qint64 len)
+{
+    if(pos < 0 || pos >= size())
+        return;
+    len = qMin(len, size() - pos);
+    if(len <= 0)
+        return;
+    const int first = splitAt(pos);
+    const int last = splitAt(pos + len);
+    pieces.remove(first, last - first);
+    ends.remove(first, last - first);
+    updateEnds(first);
+}
+
+void BytePieceTable::setByte(qint64 pos, char byte)
+{
+    qint64 offset;
+    const int i = findPiece(pos, &offset);
+    if(pos < 0 || i >= pieces.size())
+        return;
+    if(pieces[i].added)
+    {
+        addBuffer[int(pieces[i].start + offset)] = byte;
+        return;
+    }
+    remove(pos, 1);
+    insert(pos, &byte, 1);
+}
+
+char BytePieceTable::at(qint64 pos) const
+{
+    qint64 offset;
+    const int i = findPiece(pos, &offset);
+    if(pos < 0 || i >= pieces.size())
+        return 0;
+    return pieceData(pieces[i])[offset];
+}
+
+qint64 BytePieceTable::read(qint64 pos, char *out, qint64 len) const
+{
+    if(pos < 0)
+        return 0;
+    qint64 offset;
+    qint64 done = 0;
+    for(auto i = findPiece(pos, &offset); i < pieces.size() && done < len; ++i, offset = 0)
+    {
+        const qint64 n = qMin(pieces[i].length - offset, len - done);
+        memcpy(out + done, pieceData(pieces[i]) + offset, size_t(n));
+        done += n;
+    }
+    return done;
+}
+
+QByteArray BytePieceTable::mid(qint64 pos, qint64 len) const
+{
+    len = qMax<qint64>(0, qMin(len, size() - pos));
+    QByteArray result(int(len), Qt::Uninitialized);
+    read(pos, result.data(), len);
+    return result;
+}
+
+QByteArray BytePieceTable::toByteArray() const
+{
+    // 没有修改过时直接共享原始数据
+    if(pieces.size() == 1 && !pieces[0].added && pieces[0].length == original.size())
+        return original;
+    return mid(0, size());
+}
+
+QVector<ChecksumSegment> BytePieceTable::segments() const
+{
+    QVector<ChecksumSegment> result;
+    result.reserve(pieces.size());
+    for(const Piece &piece : pieces)
+        result.append(ChecksumSegment{ pieceData(piece), piece.length });
+    return result;
+}
@@ -0,0 +1,86 @@
+#ifndef BYTEPIECETABLE_H
+#define BYTEPIECETABLE_H
+
+#include <QByteArray>
+#include <QVector>
+#include "checksumcontext.h"
+
+/*********************************************************************************
+** 文件描述：       字节序列的分段表（piece table），供十六进制编辑框保存大数据
+** 设计：          原始数据（setData时传入，隐式共享，不复制）只读，新输入的字节只追加到添加缓冲区，
+**                文档是若干段的顺序拼接，每段引用两个缓冲区之一的一个区间。插入、删除只拆分
+**                和增删段，不移动数据，代价与段数有关，与文档长度无关；连续输入时新字节紧接在
+**                上一段之后，直接延长该段。各段末尾在文档中的位置单独保存，按位置查找段用二分查找。
+**                修改添加缓冲区中的单个字节时直接改写（每个区间只被一段引用），不增加段数。
+**                segments()把各段作为ChecksumSegment返回，校验算法可以直接计算，
+**                不需要先拼接成一个数组；返回的指针在下一次修改前有效。
+**********************************************************************************/
+
+class BytePieceTable
+{
+public:
+    BytePieceTable();
+
+    // 替换全部内容
+    void setData(const QByteArray &data);
+    void clear();
+
+    qint64 size() const
+    {
+        return ends.isEmpty() ? 0 : ends.last();
+    }
+    bool isEmpty() const
+    {
+        return size() == 0;
+    }
+    // 段数
+    int pieceCount() const
+    {
+        return pieces.size();
+    }
+
+    // 在pos处插入len个字节，pos可以等于size()
+    void insert(qint64 pos, const char *data, qint64 len);
+    void insert(qint64 pos, const QByteArray &data)
+    {
+        insert(pos, data.constData(), data.size());
+    }
+    // 删除从pos开始的len个字节
+    void remove(qint64 pos, qint64 len);
+    // 改写pos处的一个字节
+    void setByte(qint64 pos, char byte);
+
+    char at(qint64 pos) const;
+    // 从pos开始读取最多len个字节写入out，返回读取的字节数
+    qint64 read(qint64 pos, char *out, qint64 len) const;
+    QByteArray mid(qint64 pos, qint64 len) const;
+    QByteArray toByteArray() const;
+    // 按顺序返回各段的数据
+    QVector<ChecksumSegment> segments() const;
+
+private:
+    struct Piece
+    {
+        bool added;         // true：引用添加缓冲区；false：引用原始数据
+        qint64 start;       // 在缓冲区中的起始位置
+        qint64 length;
+    };
+
+    const char* pieceData(const Piece &piece) const
+    {
+        return (piece.added ? addBuffer.constData() : original.constData()) + piece.start;
+    }
+    // pos所在的段，*offset返回pos在段内的偏移；pos等于size()时返回段数
+    int findPiece(qint64 pos, qint64 *offset) const;
+    // 在pos处把所在段一分为二，返回后一段的下标（pos在段的开始处时不拆分）
+    int splitAt(qint64 pos);
+    // 重新计算第from段及之后各段的末尾位置
+    void updateEnds(int from);
+
+    QByteArray original;
+    QByteArray addBuffer;
+    QVector<Piece> pieces;
+    QVector<qint64> ends;   // ends[i]：第i段末尾在文档中的位置
+};
+
+#endif // BYTEPIECETABLE_H
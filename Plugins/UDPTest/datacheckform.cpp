@@ -1,128 +1,39 @@
 #include "datacheckform.h"
 #include "ui_datacheckform.h"
+#include "columncodec.h"
+#include "crcengine.h"
+#include "fieldcodec.h"
+#include "hexcodec.h"
+#include "hexstreamdecoder.h"
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileDialog>
 #include <QMessageBox>
-#include <QMetaEnum>
-#include <QTextBlock>
 
-quint16 DataCheckForm::CRC16_USB(char *data, quint16 dataLen)
+quint16 DataCheckForm::CRC16_USB(char *data, qint64 dataLen)
 {
-    quint16 initValue = 0xFFFF;
-    quint16 poly = 0x8005;
-
-    InvertUint16(&poly, &poly);
-    while (dataLen--)
-    {
-        initValue ^= *(data++);
-        for(auto i = 0; i < 8; i++)
-        {
-            if(initValue & 0x01)
-            {
-                initValue = (initValue >> 1) ^ poly;
-            }
-            else
-            {
-                initValue = initValue >> 1;
-            }
-        }
-    }
-    return (initValue ^ 0xFFFF);
-
+    return Crc16Usb::compute(data, dataLen);
 }
 
-quint16 DataCheckForm::CRC16_DNP(char *data, quint16 dataLen)
+quint16 DataCheckForm::CRC16_DNP(char *data, qint64 dataLen)
 {
-    quint16 initValue = 0x0000;
-    quint16 poly = 0x3D65;
-
-    InvertUint16(&poly, &poly);
-    while (dataLen--)
-    {
-        initValue ^= *(data++);
-        for(int i = 0;i < 8;i++)
-        {
-            if(initValue & 0x01)
-            {
-                initValue = (initValue >> 1) ^ poly;
-            }
-            else
-            {
-                initValue = (initValue >> 1);
-            }
-        }
-    }
-
-    return (initValue ^ 0xFFFF);
+    return Crc16Dnp::compute(data, dataLen);
 }
 
-quint32 DataCheckForm::CRC32_WINRAR(char *data, quint16 dataLen)
+quint32 DataCheckForm::CRC32_WINRAR(char *data, qint64 dataLen)
 {
-    quint32 initValue = 0xFFFFFFFF;
-    quint32 poly = 0x04C11DB7;
-
-    InvertUint32(&poly, &poly);
-    while (dataLen--)
-    {
-        initValue ^= *(data++);
-        for(int i = 0;i < 8;i++)
-        {
-            if(initValue & 0x01)
-            {
-                initValue = (initValue >> 1) ^ poly;
-            }
-            else
-            {
-                initValue = initValue >> 1;
-            }
-        }
-    }
-
-    return (initValue ^ 0xFFFFFFFF) ;
+    return Crc32WinRar::compute(data, dataLen);
 }
 
-quint16 DataCheckForm::CRC16_IBM(char *data, quint16 dataLen)
+quint16 DataCheckForm::CRC16_IBM(char *data, qint64 dataLen)
 {
-    quint16 initValue = 0x0000;
-    quint16 poly = 0x8005;
-
-    InvertUint16(&poly, &poly);
-    while (dataLen--)
-    {
-        initValue ^= *(data++);
-        for(int i = 0;i < 8;i++)
-        {
-            if(initValue & 0x01)
-                initValue = (initValue >> 1) ^ poly;
-            else
-                initValue = initValue >> 1;
-        }
-    }
-    return initValue;
+    return Crc16Ibm::compute(data, dataLen);
 }
 
-quint16 DataCheckForm::CRC16_MAXIM(char *data, quint16 dataLen)
+quint16 DataCheckForm::CRC16_MAXIM(char *data, qint64 dataLen)
 {
-    quint16 initValue = 0x0000;
-    quint16 poly = 0x8005;
-
-    InvertUint16(&poly, &poly);
-    while (dataLen--)
-    {
-        initValue ^= *(data++);
-        for(auto i = 0; i < 8; i++)
-        {
-            if(initValue & 0x01)
-            {
-                initValue = (initValue >> 1) ^ poly;
-            }
-            else
-            {
-                initValue = initValue >> 1;
-            }
-        }
-    }
-
-    return (initValue ^ 0xFFFF);
+    return Crc16Maxim::compute(data, dataLen);
 }
 
 /****************************Info**********************************************
@@ -135,30 +46,9 @@ quint16 DataCheckForm::CRC16_MAXIM(char *data, quint16 dataLen)
 * Xorout:  0x0000000
 * Note:
 *****************************************************************************/
-quint32 DataCheckForm::CRC32_MPEG(char *data, quint16 dataLen)
+quint32 DataCheckForm::CRC32_MPEG(char *data, qint64 dataLen)
 {
-    quint32 initValue = 0xFFFFFFFF;
-    quint32 poly = 0x04C11DB7;
-    quint8 uCh = 0;
-
-    while (dataLen--)
-    {
-        uCh = *(data++);
-        initValue ^= (uCh << 24);
-        for(auto i = 0; i < 8; i++)
-        {
-            if(initValue & 0x80000000)
-            {
-                initValue = (initValue << 1) ^ poly;
-            }
-            else
-            {
-                initValue = initValue << 1;
-            }
-        }
-    }
-
-    return initValue;
+    return Crc32Mpeg::compute(data, dataLen);
 }
 
 DataCheckForm::DataCheckForm(QWidget *parent) :
@@ -241,9 +131,20 @@ DataCheckForm::DataCheckForm(QWidget *parent) :
     sendModeGroup->addButton(ui->radioButton_BigStorage, 1);
     // 初始设置小端存储
     ui->radioButton_SmallStorage->setChecked(true);
+    // 字节数据缺省在字节间显示空格
+    ui->checkBox_FormatData->setChecked(true);
     // 绑定信号与槽
     connect(ui->radioButton_SmallStorage, SIGNAL(clicked()), this, SLOT(onRadioClickSelecByteOrder()));
     connect(ui->radioButton_BigStorage, SIGNAL(clicked()), this, SLOT(onRadioClickSelecByteOrder()));
+
+    //******************************//
+    // 批量转换：类型、字节序的顺序分别与FieldCodec::FieldType、FieldCodec::ByteOrder一致
+    ui->comboBox_BulkType->addItems(list2 + QStringList{"Float", "Double"});
+    ui->comboBox_BulkType->setCurrentIndex(FieldCodec::Float);
+    ui->comboBox_BulkByteOrder->addItems({"ABCD（大端）", "DCBA（小端）", "BADC", "CDAB"});
+    ui->comboBox_BulkByteOrder->setCurrentIndex(FieldCodec::DCBA);
+    ui->spinBox_BulkColumn->setRange(1, 999);
+    ui->comboBox_BulkFormat->addItems({"十六进制", "二进制"});
 }
 
 DataCheckForm::~DataCheckForm()
@@ -251,53 +152,14 @@ DataCheckForm::~DataCheckForm()
     delete ui;
 }
 
-quint8 DataCheckForm::CRC8(char *data, quint16 dataLen)
+quint8 DataCheckForm::CRC8(char *data, qint64 dataLen)
 {
-    quint8 initValue = 0x00;
-    quint8 poly = 0x07;
-
-    while (dataLen--)
-    {
-        initValue ^= *(data++);
-        for(auto i = 0; i < 8; i++)
-        {
-            if(initValue & 0x80)
-            {
-                initValue = (initValue << 1) ^ poly;
-            }
-            else
-            {
-                initValue = initValue << 1;
-            }
-        }
-    }
-
-    return initValue;
+    return Crc8::compute(data, dataLen);
 }
 
-quint8 DataCheckForm::CRC8_MAXIM(char *data, quint16 dataLen)
+quint8 DataCheckForm::CRC8_MAXIM(char *data, qint64 dataLen)
 {
-    quint8 initValue = 0x00;
-    quint8 poly = 0x31;
-
-    InvertUint8(&poly, &poly);
-    while (dataLen--)
-    {
-        initValue ^= *(data++);
-        for(auto i = 0; i < 8; i++)
-        {
-            if(initValue & 0x01)
-            {
-                initValue = (initValue >> 1) ^ poly;
-            }
-            else
-            {
-                initValue = initValue >> 1;
-            }
-        }
-    }
-
-    return initValue;
+    return Crc8Maxim::compute(data, dataLen);
 }
 
 /****************************Info**********************************************
@@ -310,28 +172,9 @@ quint8 DataCheckForm::CRC8_MAXIM(char *data, quint16 dataLen)
 * Xorout:  0x55
 * Alias:   CRC-8/ATM
 *****************************************************************************/
-quint8 DataCheckForm::CRC8_ITU(char *data, quint16 dataLen)
+quint8 DataCheckForm::CRC8_ITU(char *data, qint64 dataLen)
 {
-    quint8 initValue = 0x00;
-    quint8 poly = 0x07;
-
-    while (dataLen--)
-    {
-        initValue ^= *(data++);
-        for(auto i = 0;i < 8;i++)
-        {
-            if(initValue & 0x80)
-            {
-                initValue = (initValue << 1) ^ poly;
-            }
-            else
-            {
-                initValue = initValue << 1;
-            }
-        }
-    }
-
-    return (initValue ^ 0x55);
+    return Crc8Itu::compute(data, dataLen);
 }
 
 /****************************Info**********************************************
@@ -344,56 +187,14 @@ quint8 DataCheckForm::CRC8_ITU(char *data, quint16 dataLen)
 * Xorout:  0x00
 * Note:
 *****************************************************************************/
-quint8 DataCheckForm::CRC8_ROHC(char *data, quint16 dataLen)
+quint8 DataCheckForm::CRC8_ROHC(char *data, qint64 dataLen)
 {
-    quint8 initValue = 0xFF;
-    quint8 poly = 0x07;
-
-    InvertUint8(&poly, &poly);
-    while (dataLen--)
-    {
-        initValue ^= *(data++);
-        for(auto i = 0; i < 8; i++)
-        {
-            if(initValue & 0x01)
-            {
-                initValue = (initValue >> 1) ^ poly;
-            }
-            else
-            {
-                initValue = initValue >> 1;
-            }
-        }
-    }
-
-    return initValue;
+    return Crc8Rohc::compute(data, dataLen);
 }
 
-//这里为了效率，我们不需要将所有Refin和refout为true的输入输出数据移位转换
-//只需要将poly二项式转换后，运算时将左移变为右移
-quint16 DataCheckForm::CRC16_CCITT_TRUE(char *data, quint16 dataLen)
+quint16 DataCheckForm::CRC16_CCITT_TRUE(char *data, qint64 dataLen)
 {
-    quint16 initValue = 0x0000;     // 初始值
-    quint16 poly = 0x1021;          // 多项式
-
-    InvertUint16(&poly, &poly);
-    while (dataLen--)
-    {
-        initValue ^= *(data++);
-        for(int i = 0;i < 8;i++)
-        {
-            if(initValue & 0x01)
-            {
-                initValue = (initValue >> 1) ^ poly;
-            }
-            else
-            {
-                initValue = initValue >> 1;
-            }
-        }
-    }
-
-    return initValue;
+    return Crc16CcittTrue::compute(data, dataLen);
 }
 
 /****************************Info**********************************************
@@ -406,28 +207,9 @@ quint16 DataCheckForm::CRC16_CCITT_TRUE(char *data, quint16 dataLen)
 * Xorout:  0x0000
 * Note:
 *****************************************************************************/
-quint16 DataCheckForm::CRC16_CCITT_FALSE(char *data, quint16 dataLen)
+quint16 DataCheckForm::CRC16_CCITT_FALSE(char *data, qint64 dataLen)
 {
-    quint16 initValue = 0xFFFF;
-    quint16 poly = 0x1021;
-
-    while (dataLen--)
-    {
-        initValue ^= *(data++) << 8;
-        for(int i = 0;i < 8; i++)
-        {
-            if(initValue & 0x8000)
-            {
-                initValue = (initValue << 1) ^ poly;
-            }
-            else
-            {
-                initValue = initValue << 1;
-            }
-        }
-    }
-
-    return initValue;
+    return Crc16CcittFalse::compute(data, dataLen);
 }
 
 /****************************Info**********************************************
@@ -440,86 +222,70 @@ quint16 DataCheckForm::CRC16_CCITT_FALSE(char *data, quint16 dataLen)
 * Xorout:  0x0000
 * Alias:   CRC-16/ZMODEM,CRC-16/ACORN
 *****************************************************************************/
-quint16 DataCheckForm::CRC16_XMODEM(char *data, quint16 dataLen)
+quint16 DataCheckForm::CRC16_XMODEM(char *data, qint64 dataLen)
 {
-    quint16 initValue = 0x0000;
-    quint16 poly = 0x1021;
-
-    while (dataLen--)
-    {
-        initValue ^= (*(data++) << 8);
-        for(int i = 0; i < 8; i++)
-        {
-            if(initValue & 0x8000)
-            {
-                initValue = (initValue << 1) ^ poly;
-            }
-            else
-            {
-                initValue = initValue << 1;
-            }
-        }
-    }
+    return Crc16Xmodem::compute(data, dataLen);
+}
 
-    return initValue;
+quint16 DataCheckForm::CRC16_X25(char *data, qint64 dataLen)
+{
+    return Crc16X25::compute(data, dataLen);
 }
 
-quint16 DataCheckForm::CRC16_X25(char *data, quint16 dataLen)
+quint16 DataCheckForm::CRC16_MODBUS(char *data, qint64 dataLen)
 {
-    quint16 initValue = 0xFFFF;
-    quint16 poly = 0x1021;
+    return Crc16Modbus::compute(data, dataLen);
+}
 
-    InvertUint16(&poly, &poly);
-    while (dataLen--)
+/***
+ * 浮点数、整数转换思路：由于强制转换会造成数据丢失，所以直接操作内存，按字节序读写数值的各字节（见fieldcodec.h）。
+ * double：8字节；float：4字节
+ * qulonglong：8字节；qint32、quint32：4字节
+ ***/
+namespace
+{
+    // 载荷数据按十六进制文本写入文件，每次编码一段，不需要一次生成全部文本
+    bool writeHexFile(QFile *file, const QByteArray &data)
     {
-        initValue ^= *(data++);
-        for(auto i = 0; i < 8; i++)
+        const int chunk = 64 * 1024;
+        QString text;
+        for(auto pos = 0; pos < data.size(); pos += chunk)
         {
-            if(initValue & 0x01)
-            {
-                initValue = (initValue >> 1) ^ poly;
-            }
-            else
-            {
-                initValue = initValue >> 1;
-            }
+            const int len = qMin(chunk, data.size() - pos);
+            text.resize(int(HexCodec::encodedLength(len, HexCodec::Spaced)));
+            HexCodec::encode(reinterpret_cast<const uchar*>(data.constData()) + pos, len,
+                             reinterpret_cast<ushort*>(text.data()), HexCodec::Spaced);
+            if(pos > 0 && file->write(" ", 1) != 1)
+                return false;
+            const QByteArray latin1 = text.toLatin1();
+            if(file->write(latin1) != latin1.size())
+                return false;
         }
+        return true;
     }
 
-    return (initValue ^ 0xFFFF);
-}
-
-quint16 DataCheckForm::CRC16_MODBUS(char *data, quint16 dataLen)
-{
-    quint16 initValue = 0xFFFF;
-    quint16 poly = 0x8005;
+    FieldCodec::ByteOrder byteOrder(bool littleEndian)
+    {
+        return littleEndian ? FieldCodec::LittleEndian : FieldCodec::BigEndian;
+    }
 
-    InvertUint16(&poly, &poly);
-    while (dataLen--)
+    // 按字节序把value编码为sizeof(T)个字节
+    template<typename T>
+    QByteArray encodeField(T value, bool littleEndian)
     {
-        initValue ^= *(data++);
-        for(int i = 0;i < 8;i++)
-        {
-            if(initValue & 0x01)
-            {
-                initValue = (initValue >> 1) ^ poly;
-            }
-            else
-            {
-                initValue = initValue >> 1;
-            }
-        }
+        QByteArray ba(int(sizeof(T)), Qt::Uninitialized);
+        FieldCodec::encode<T>(value, byteOrder(littleEndian), reinterpret_cast<uchar*>(ba.data()));
+        return ba;
     }
 
-    return initValue;
+    // 按字节序从ba的前sizeof(T)个字节解码，调用方保证长度足够
+    template<typename T>
+    T decodeField(const QByteArray &ba, bool littleEndian)
+    {
+        return FieldCodec::decode<T>(reinterpret_cast<const uchar*>(ba.constData()), byteOrder(littleEndian));
+    }
 }
 
-/***
- * 浮点数转换思路：由于强制转换会造成数据丢失，所以直接操作内存。将float/double的指针转换成其它类型的指针，再解引用。
- * double：8字节；float：4字节
- * qulonglong：8字节；qint32、quint32：4字节
- ***/
-
 // Floating point to hexadecimal conversion
 void DataCheckForm::on_pushButton_Convert1_clicked()
 {
@@ -531,11 +297,7 @@ void DataCheckForm::on_pushButton_Convert1_clicked()
 
     QString strFloat = ui->lineEdit_Float1->text();
     float f = strFloat.toFloat();
-    const char* ch = (char*)(&f);
-    QByteArray ba = QByteArray(ch, 4);
-    // Big end mode, reversed
-    if(!ui->checkBox_LittleEndian->isChecked())
-        std::reverse(ba.begin(), ba.end());
+    QByteArray ba = encodeField(f, ui->checkBox_LittleEndian->isChecked());
     QString str = "";
     if(ui->checkBox_Separator1->isChecked())
         str = ba.toHex(' ').toUpper();
@@ -547,18 +309,13 @@ void DataCheckForm::on_pushButton_Convert1_clicked()
 void DataCheckForm::on_pushButton_Convert2_clicked()
 {
     QString strHex = ui->lineEdit_Hex2->text().trimmed();
-    if(strHex.remove(' ').length() < 8)
+    QByteArray ba = QByteArray::fromHex(strHex.toLatin1());
+    if(ba.size() < 4)
     {
         QMessageBox::information(this, "信息提示", "请输入8个十六进制字符！");
         return;
     }
-    QByteArray ba = QByteArray::fromHex(strHex.toLatin1());
-    float f;
-    char* ch = (char*)(&f);
-    if(!ui->checkBox_LittleEndian2->isChecked())
-        std::reverse(ba.begin(), ba.end());
-    for(auto i=0; i<4; ++i)
-        *(ch+i) = ba[i];
+    float f = decodeField<float>(ba, ui->checkBox_LittleEndian2->isChecked());
 
     QString strFloat = QString::number(f, 'f', ui->comboBox_Float2_ReservedBits->currentIndex());
     ui->lineEdit_Float2->setText(strFloat);
@@ -622,11 +379,7 @@ void DataCheckForm::on_pushButton_Convert3_clicked()
 
     QString strDouble = ui->lineEdit_Double1->text();
     double d = strDouble.toDouble();
-    const char* ch = (char*)(&d);
-    QByteArray ba = QByteArray(ch, 8);
-    // Big end mode, reversed
-    if(!ui->checkBox_LittleEndian3->isChecked())
-        std::reverse(ba.begin(), ba.end());
+    QByteArray ba = encodeField(d, ui->checkBox_LittleEndian3->isChecked());
     QString str = "";
     if(ui->checkBox_Separator3->isChecked())
         str = ba.toHex(' ').toUpper();
@@ -646,18 +399,13 @@ void DataCheckForm::on_lineEdit_Double1_editingFinished()
 void DataCheckForm::on_pushButton_Convert4_clicked()
 {
     QString strHex = ui->lineEdit_Hex4->text().trimmed();
-    if(strHex.remove(' ').length() < 16)
+    QByteArray ba = QByteArray::fromHex(strHex.toLatin1());
+    if(ba.size() < 8)
     {
         QMessageBox::information(this, "信息提示", "请输入16个十六进制字符！");
         return;
     }
-    QByteArray ba = QByteArray::fromHex(strHex.toLatin1());
-    double d;
-    char* ch = (char*)(&d);
-    if(!ui->checkBox_LittleEndian4->isChecked())
-        std::reverse(ba.begin(), ba.end());
-    for(auto i=0; i<8; ++i)
-        *(ch+i) = ba[i];
+    double d = decodeField<double>(ba, ui->checkBox_LittleEndian4->isChecked());
 
     QString strDouble = QString::number(d, 'f', ui->comboBox_Double2_ReservedBits->currentIndex());
     ui->lineEdit_Double2->setText(strDouble);
@@ -702,91 +450,103 @@ void DataCheckForm::on_pushButton_Convert5_clicked()
     }
 
     QString strInt = ui->lineEdit_Int1->text();
-    QVariant i;
-    const char* ch = (char*)(&i);
+    const bool littleEndian = ui->checkBox_LittleEndian5->isChecked();
     bool ok;
     int base = 10;
     QByteArray ba;
     switch (ui->comboBox_IntType1->currentIndex())
     {
     case 0:
-        i = strInt.toInt(&ok, base);
-        if(i<-128 || i > 127)
+    {
+        const int i = strInt.toInt(&ok, base);
+        if(!ok || i < -128 || i > 127)
         {
             QMessageBox::information(this, "信息提示", "Int8类型整数范围：-128~127");
             return;
         }
-        ba = QByteArray(ch, 1);
+        ba = encodeField(qint8(i), littleEndian);
         break;
+    }
     case 1:
-        i = strInt.toInt(&ok, base);
-        if(i<0 || i > 255)
+    {
+        const int i = strInt.toInt(&ok, base);
+        if(!ok || i < 0 || i > 255)
         {
             QMessageBox::information(this, "信息提示", "UInt8类型整数范围：0~255");
             return;
         }
-        ba = QByteArray(ch, 1);
+        ba = encodeField(quint8(i), littleEndian);
         break;
+    }
     case 2:
-        i = strInt.toShort(&ok, base);
+    {
+        const qint16 i = strInt.toShort(&ok, base);
         if(!ok)
         {
             QMessageBox::information(this, "信息提示", "Int16类型整数范围：-32768~32767");
             return;
         }
-        ba = QByteArray(ch, 2);
+        ba = encodeField(i, littleEndian);
         break;
+    }
     case 3:
-        i = strInt.toUShort(&ok, base);
+    {
+        const quint16 i = strInt.toUShort(&ok, base);
         if(!ok)
         {
             QMessageBox::information(this, "信息提示", "Int16类型整数范围：0~65535");
             return;
         }
-        ba = QByteArray(ch, 2);
+        ba = encodeField(i, littleEndian);
         break;
+    }
     case 4:
-        i = strInt.toInt(&ok, base);
+    {
+        const qint32 i = strInt.toInt(&ok, base);
         if(!ok)
         {
             QMessageBox::information(this, "信息提示", "Int32类型整数范围：-2147483648~2147483647");
             return;
         }
-        ba = QByteArray(ch, 4);
+        ba = encodeField(i, littleEndian);
         break;
+    }
     case 5:
-        i = strInt.toUInt(&ok, base);
+    {
+        const quint32 i = strInt.toUInt(&ok, base);
         if(!ok)
         {
             QMessageBox::information(this, "信息提示", "UInt32类型整数范围：0~4294967295");
             return;
         }
-        ba = QByteArray(ch, 4);
+        ba = encodeField(i, littleEndian);
         break;
+    }
     case 6:
-        i = strInt.toLongLong(&ok, base);
+    {
+        const qint64 i = strInt.toLongLong(&ok, base);
         if(!ok)
         {
             QMessageBox::information(this, "信息提示", "输入的Int64类型整数超出有效范围！");
             return;
         }
-        ba = QByteArray(ch, 8);
+        ba = encodeField(i, littleEndian);
         break;
+    }
     case 7:
-        i = strInt.toULongLong(&ok, base);
+    {
+        const quint64 i = strInt.toULongLong(&ok, base);
         if(!ok)
         {
             QMessageBox::information(this, "信息提示", "输入的UInt64类型整数超出有效范围！");
             return;
         }
-        ba = QByteArray(ch, 8);
+        ba = encodeField(i, littleEndian);
         break;
+    }
     default:
         break;
     }
-    // Big end mode, reversed
-    if((ui->comboBox_IntType1->currentIndex() > 1) && (!ui->checkBox_LittleEndian5->isChecked()))
-        std::reverse(ba.begin(), ba.end());
     QString str = "";
     if(ui->checkBox_Separator5->isChecked())
         str = ba.toHex(' ').toUpper();
@@ -815,91 +575,42 @@ void DataCheckForm::on_pushButton_Convert6_clicked()
 {
     QString strHex = ui->lineEdit_Hex6->text().trimmed();
     QByteArray ba = QByteArray::fromHex(strHex.toLatin1());
-    quint16 byteLen = 0;
-    QVariant i;
-    switch (ui->comboBox_IntType2->currentIndex())
-    {
-    case 0:
-        i = (qint8)0;
-        byteLen = 1;
-        break;
-    case 1:
-        i = (quint8)0;
-        byteLen = 1;
-        break;
-    case 2:
-        i = (qint16)0;
-        byteLen = 2;
-        break;
-    case 3:
-        i = (quint16)0;
-        byteLen = 2;
-        break;
-    case 4:
-        i = (qint32)0;
-        byteLen = 4;
-        break;
-    case 5:
-        i = (quint32)0;
-        byteLen = 4;
-        break;
-    case 6:
-        i = (qint64)0;
-        byteLen = 8;
-        break;
-    case 7:
-        i = (quint64)0;
-        byteLen = 8;
-        break;
-    default:
-        break;
-    }
-    if(ba.size() != byteLen)
+    const int type = ui->comboBox_IntType2->currentIndex();
+    if(type < FieldCodec::Int8 || type > FieldCodec::UInt64)
+        return;
+    if(ba.size() != FieldCodec::fieldSize(FieldCodec::FieldType(type)))
     {
         QMessageBox::information(this, "信息提示", "输入的十六进制字节的长度与类型不匹配！");
         return;
     }
-    char* ch = (char*)(&i);
-    if(!ui->checkBox_LittleEndian6->isChecked())
-        std::reverse(ba.begin(), ba.end());
-    for(auto index=0; index<byteLen; ++index)
-        *(ch+index) = ba[index];
+    const bool littleEndian = ui->checkBox_LittleEndian6->isChecked();
 
     QString strInt = "";
-    bool ok;
-    switch (ui->comboBox_IntType2->currentIndex())
+    switch (type)
     {
-    case 0:
-        // handle negative numbers
-        if(i.toInt(&ok) & 0x80)
-            strInt = QString::number(i.toInt(&ok) - 0xFF - 1);
-        else
-            strInt = QString::number(i.toInt(&ok));
+    case FieldCodec::Int8:
+        strInt = QString::number(int(decodeField<qint8>(ba, littleEndian)));
         break;
-    case 1:
-        strInt = QString::number(i.toUInt());
+    case FieldCodec::UInt8:
+        strInt = QString::number(uint(decodeField<quint8>(ba, littleEndian)));
         break;
-    case 2:
-        // handle negative numbers
-        if(i.toInt(&ok) & 0x8000)
-            strInt = QString::number(i.toInt(&ok) - 0xFFFF - 1);
-        else
-            strInt = QString::number(i.toInt(&ok));
+    case FieldCodec::Int16:
+        strInt = QString::number(int(decodeField<qint16>(ba, littleEndian)));
         break;
-    case 3:
-        strInt = QString::number(i.toUInt());
+    case FieldCodec::UInt16:
+        strInt = QString::number(uint(decodeField<quint16>(ba, littleEndian)));
         break;
-    case 4:
-        strInt = QString::number(i.toInt());
+    case FieldCodec::Int32:
+        strInt = QString::number(decodeField<qint32>(ba, littleEndian));
         break;
-    case 5:
-        strInt = QString::number(i.toUInt());
+    case FieldCodec::UInt32:
+        strInt = QString::number(decodeField<quint32>(ba, littleEndian));
         break;
-    case 6:
-        strInt = QString::number(i.toLongLong());
+    case FieldCodec::Int64:
+        strInt = QString::number(decodeField<qint64>(ba, littleEndian));
         break;
-    case 7:
-        strInt = QString::number(i.toULongLong());
+    case FieldCodec::UInt64:
+        strInt = QString::number(decodeField<quint64>(ba, littleEndian));
         break;
     default:
         break;
@@ -916,96 +627,55 @@ void DataCheckForm::on_lineEdit_Hex6_textChanged(const QString &arg1)
 void DataCheckForm::on_comboBox_ChecksumLength_currentIndexChanged(int index)
 {
     ui->comboBox_CheckAlgorithm->clear();
-    QMetaEnum me;
-    switch (index)
-    {
-    case 0:
-        // 获得枚举类型的元数据对象
-        me = QMetaEnum::fromType<DataCheckForm::CRC8_Mode>();
-        for(auto i = 0; i < me.keyCount(); ++i)
-            ui->comboBox_CheckAlgorithm->addItem(me.key(i));
-        break;
-    case 1:
-        me = QMetaEnum::fromType<DataCheckForm::CRC16_Mode>();
-        for(auto i = 0; i < me.keyCount(); ++i)
-            ui->comboBox_CheckAlgorithm->addItem(me.key(i));
-        break;
-    case 2:
-        me = QMetaEnum::fromType<DataCheckForm::CRC32_Mode>();
-        for(auto i = 0; i < me.keyCount(); ++i)
-            ui->comboBox_CheckAlgorithm->addItem(me.key(i));
-        break;
-    default:
-        break;
-    }
+    // 1、2、4字节校验码分别对应8、16、32位CRC算法
+    const int widths[] = {8, 16, 32};
+    if(index < 0 || index > 2)
+        return;
+    const auto algorithms = CheckAlgorithmRegistry::getCARInstance().list(CheckAlgorithm::Crc, widths[index]);
+    for(auto algorithm : algorithms)
+        ui->comboBox_CheckAlgorithm->addItem(algorithm->name);
+}
+
+// 切换校验算法时从注册表取得算法，产生校验码时直接调用
+void DataCheckForm::on_comboBox_CheckAlgorithm_currentIndexChanged(int index)
+{
+    checkAlgorithm = CheckAlgorithmRegistry::getCARInstance().find(ui->comboBox_CheckAlgorithm->itemText(index));
 }
 
 // 产生校验码函数  20221102
 void DataCheckForm::on_pushButton_Generate_Checkcode_clicked()
 {
-    QString hexStr = ui->textEdit_ByteString->toPlainText();
-    QByteArray ba = tcInstance.HexStringToByteArray(hexStr);
-    DataCheckForm& pCRC = DataCheckForm::getDCFInstance();
-    char* pCrcCheckSum = ba.data();    // QByteArray转char*
-    quint8 ret8 = 0;
-    quint16 ret16 = 0;
-    quint32 ret32 = 0;
-    QString methodName = ui->comboBox_CheckAlgorithm->currentText().toUpper();
-    bool callResult = false;
-    switch (ui->comboBox_ChecksumLength->currentIndex())
-    {
-    case 0: // 处理1字节校验码
-        callResult = QMetaObject::invokeMethod(&pCRC, methodName.toLatin1().data(), Qt :: AutoConnection,
-                                               Q_RETURN_ARG(quint8, ret8),
-                                               Q_ARG(char*, pCrcCheckSum), Q_ARG(quint16, ba.size()));
-        break;
-    case 1: // 处理2字节校验码
-        // Note：被调用QMetaObject::invokeMethod的参数类型必须严格一致。Q_ARG()宏不识别quint8类型，需要使用char
-        callResult = QMetaObject::invokeMethod(&pCRC, methodName.toLatin1().data(), Qt :: AutoConnection,
-                                               Q_RETURN_ARG(quint16, ret16),
-                                               Q_ARG(char*, pCrcCheckSum), Q_ARG(quint16, ba.size()));
-        break;
-    case 2: // 处理4字节校验码
-        qRegisterMetaType<quint32>("quint32");
-        callResult = QMetaObject::invokeMethod(&pCRC, methodName.toLatin1().data(), Qt :: AutoConnection,
-                                               Q_RETURN_ARG(quint32, ret32),
-                                               Q_ARG(char*, pCrcCheckSum), Q_ARG(quint16, ba.size()));
-        break;
-    default:
-        ;
-    }
-    if(!callResult)
+    if(checkAlgorithm == nullptr)
     {
         ui->lineEdit_Checkcode->setText("调用校验函数失败！");
         return;
     }
+    // 直接按编辑框分段表中的各段字节计算，不经过十六进制文本
+    const QVector<ChecksumSegment> segments = ui->textEdit_ByteString->bytes().segments();
+    const quint64 ret = checkAlgorithm->computeSegments(segments.constData(), segments.size());
     // 根据字节长度返回校验码
-    QString checkcode = "";
-    switch (ui->comboBox_ChecksumLength->currentIndex())
+    qDebug().noquote() << "十进制校验码：" << ret;
+    QByteArray checkcode;
+    switch (checkAlgorithm->bytes())
     {
-    case 0:
-        qDebug().noquote() << "十进制校验码：" << ret8;
-        checkcode = tcInstance.DecToHexString(ret8, 1, !crcByteOrder);
-        qDebug().noquote() << "十六进制校验码：" << checkcode;
-        ui->lineEdit_Checkcode_Dec->setText(QString::number(ret8));
-        break;
     case 1:
-        qDebug().noquote() << "十进制校验码：" << ret16;
-        checkcode = tcInstance.DecToHexString(ret16, 2, !crcByteOrder);
-        qDebug().noquote() << "十六进制校验码：" << checkcode;
-        ui->lineEdit_Checkcode_Dec->setText(QString::number(ret16));
+        checkcode = encodeField(quint8(ret), !crcByteOrder);
         break;
     case 2:
-        qDebug().noquote() << "十进制校验码：" << ret32;
-        checkcode = tcInstance.DecToHexString(ret32, 4, !crcByteOrder);
-        qDebug().noquote() << "十六进制校验码：" << checkcode;
-        ui->lineEdit_Checkcode_Dec->setText(QString::number(ret32));
+        checkcode = encodeField(quint16(ret), !crcByteOrder);
+        break;
+    case 8:
+        checkcode = encodeField(quint64(ret), !crcByteOrder);
         break;
     default:
-        ;
+        checkcode = encodeField(quint32(ret), !crcByteOrder);
+        break;
     }
-    ui->lineEdit_Checkcode->setText(checkcode);
-    ui->textEdit_ByteString->setText(tcInstance.StringNoNullToNull(hexStr+checkcode));
+    const QString strCheckcode = HexCodec::toHex(checkcode);
+    qDebug().noquote() << "十六进制校验码：" << strCheckcode;
+    ui->lineEdit_Checkcode_Dec->setText(QString::number(ret));
+    ui->lineEdit_Checkcode->setText(strCheckcode);
+    ui->textEdit_ByteString->appendData(checkcode);
 
 }
 
@@ -1027,98 +697,102 @@ void DataCheckForm::onRadioClickSelecByteOrder()
     }
 }
 
-// 把quint16数（十六bit）颠倒过来，算法同InvertUint8
-void DataCheckForm::InvertUint16(quint16 *destUShort, quint16 *srcUShort)
+// 格式化数据只改变字节间是否显示空格，不需要重新解析和设置内容
+void DataCheckForm::on_checkBox_FormatData_stateChanged(int arg1)
 {
-    quint16 uShort = 0;
-
-    for(auto i = 0; i < 16; i++)
-    {
-        if(*srcUShort & (1 << i))
-        {
-            uShort |= 1 << (15 - i);
-        }
-    }
-
-    *destUShort = uShort;
+    ui->textEdit_ByteString->setSpaced(arg1 == 2);
 }
 
-/****************************Info**********************************************
-* Name: InvertUint8
-* Note: 把字节颠倒过来，如0x12变成0x48
-*       0x12: 0001 0010
-*       0x48: 0100 1000
-*****************************************************************************/
-void DataCheckForm::InvertUint8(quint8 *destUch, quint8 *srcUch)
+// CSV文件中的一列数值按类型和字节序打包为载荷字节，保存为十六进制文本或二进制文件
+void DataCheckForm::on_pushButton_BulkPack_clicked()
 {
-    quint8 uCh = 0;  // 临时变量，暂存翻转后的值
-
-    for(auto i = 0; i < 8; i++)
+    QString csvName = QFileDialog::getOpenFileName(this, "打开CSV文件", "", "CSV文件(*.csv *.txt);;所有文件(*.*)");
+    if(csvName.isEmpty())
+        return;
+    QFile csvFile(csvName);
+    if(!csvFile.open(QIODevice::ReadOnly))
     {
-        if(*srcUch & (1 << i))
-        {   // 判断srcUch的第i位，若为1，则翻转后的第7-i位置1
-            uCh |= 1 << (7-i);   // 将ch的第7-i位置1
-        }
+        QMessageBox::warning(this, "警告", tr("读取文件 %1 失败！原因：%2.").arg(csvName).arg(csvFile.errorString()));
+        return;
     }
-
-    *destUch = uCh;
-}
-
-void DataCheckForm::InvertUint32(quint32 *destUInt, quint32 *srcUInt)
-{
-    quint32 uInt = 0;
-
-    for(auto i=0; i< 32; i++)
-    {
-        if(*srcUInt & (1 << i))
-            uInt |= 1 << (31 - i);
+    const QByteArray text = csvFile.readAll();
+    csvFile.close();
+
+    const FieldCodec::FieldType type = FieldCodec::FieldType(ui->comboBox_BulkType->currentIndex());
+    const FieldCodec::ByteOrder order = FieldCodec::ByteOrder(ui->comboBox_BulkByteOrder->currentIndex());
+    QByteArray payload;
+    qint64 errorLine = 0;
+    QElapsedTimer timer;
+    timer.start();
+    const qint64 count = ColumnCodec::pack(text.constData(), text.size(), type, order,
+                                           ui->spinBox_BulkColumn->value() - 1, &payload, &errorLine);
+    const qint64 nsecs = timer.nsecsElapsed();
+    if(count < 0)
+    {
+        QMessageBox::information(this, "信息提示", tr("第%1行第%2列不是有效的%3类型数值！")
+                                 .arg(errorLine).arg(ui->spinBox_BulkColumn->value()).arg(ui->comboBox_BulkType->currentText()));
+        return;
     }
 
-    *destUInt = uInt;
-}
-
-void DataCheckForm::on_checkBox_FormatData_stateChanged(int arg1)
-{
-    QString sendStr = ui->textEdit_ByteString->toPlainText();
-    if(arg1 == 2)
-    {
-        QByteArray ba = tcInstance.HexStringToByteArray(sendStr);
-        sendStr = ba.toHex(' ').data();
-    }
-    else if(arg1 == 0)
+    const bool hex = ui->comboBox_BulkFormat->currentIndex() == 0;
+    QString outName = QFileDialog::getSaveFileName(this, "保存载荷数据", "",
+                                                   hex ? "十六进制文本(*.txt)" : "二进制文件(*.bin)");
+    if(outName.isEmpty())
+        return;
+    QFile outFile(outName);
+    if(!outFile.open(QIODevice::WriteOnly | QIODevice::Truncate)
+            || !(hex ? writeHexFile(&outFile, payload) : outFile.write(payload) == payload.size()))
     {
-        sendStr = sendStr.remove(" ");
+        QMessageBox::warning(this, "警告", tr("写入文件 %1 失败！原因：%2.").arg(outName).arg(outFile.errorString()));
+        return;
     }
-    ui->textEdit_ByteString->setText(sendStr.toUpper());
+    // 字节/纳秒 × 1000 = MB/s，按CSV文本的长度计算，不含读写文件的时间
+    const double speed = nsecs > 0 ? text.size() * 1000.0 / nsecs : 0;
+    QMessageBox::information(this, "信息提示", tr("已转换%1个数值，共%2字节，转换速度%3 MB/s。")
+                             .arg(count).arg(payload.size()).arg(speed, 0, 'f', 1));
 }
 
-void DataCheckForm::on_textEdit_ByteString_textChanged()
+// 十六进制文本或二进制文件中的载荷字节按类型和字节序解包为一列数值，保存为CSV文件
+void DataCheckForm::on_pushButton_BulkUnpack_clicked()
 {
-    QTextCursor cursor = ui->textEdit_ByteString->textCursor();   // 光标
-    quint16 lineNum = cursor.blockNumber(); // 行号
-    quint16 posInBlock = cursor.positionInBlock(); // 光标所在行的位置，从左边开始计算
-    QString lineText = ui->textEdit_ByteString->document()->findBlockByLineNumber(lineNum).text();
-
-    /* 按回车会新开一行，如果判断光标在行首位置且行号大于0则认为新开一行，把光标向下移动一行*/
-    if(posInBlock == 0 && lineNum > 0)
-    {
-        cursor.movePosition(QTextCursor::Down);
-        ui->textEdit_ByteString->setTextCursor(cursor);
+    const bool hex = ui->comboBox_BulkFormat->currentIndex() == 0;
+    QString inName = QFileDialog::getOpenFileName(this, "打开载荷数据", "",
+                                                  hex ? "十六进制文本(*.txt);;所有文件(*.*)" : "二进制文件(*.bin);;所有文件(*.*)");
+    if(inName.isEmpty())
         return;
-    }
-    char ch = ' ';
-    // 光标所在行的位置大于等于1，才取前一个字符，这是为了预防按下Backspace键回退到一行开始处的位置，会导致lineText.at(posInBlock-1)访问越界
-    if(posInBlock >= 1)
-    {
-        ch = lineText.at(posInBlock-1).toLatin1();
-    }
-    if((ch == ' ') || (ch >= '0' && ch <='9') || (ch >='a' && ch <= 'f') || (ch >='A' && ch <= 'F'))
+    QFile inFile(inName);
+    if(!inFile.open(QIODevice::ReadOnly))
     {
+        QMessageBox::warning(this, "警告", tr("读取文件 %1 失败！原因：%2.").arg(inName).arg(inFile.errorString()));
         return;
     }
-    else
+    QByteArray payload = inFile.readAll();
+    inFile.close();
+    if(hex)
+        payload = HexStreamDecoder::decodeAll(payload.constData(), payload.size());
+
+    const FieldCodec::FieldType type = FieldCodec::FieldType(ui->comboBox_BulkType->currentIndex());
+    const FieldCodec::ByteOrder order = FieldCodec::ByteOrder(ui->comboBox_BulkByteOrder->currentIndex());
+    QByteArray text;
+    QElapsedTimer timer;
+    timer.start();
+    const qint64 count = ColumnCodec::unpack(reinterpret_cast<const uchar*>(payload.constData()), payload.size(),
+                                             type, order, &text);
+    const qint64 nsecs = timer.nsecsElapsed();
+
+    QString csvName = QFileDialog::getSaveFileName(this, "保存CSV文件", "", "CSV文件(*.csv)");
+    if(csvName.isEmpty())
+        return;
+    QFile csvFile(csvName);
+    if(!csvFile.open(QIODevice::WriteOnly | QIODevice::Truncate) || csvFile.write(text) != text.size())
     {
-        cursor.deletePreviousChar();
-        ui->textEdit_ByteString->setTextCursor(ui->textEdit_ByteString->textCursor());
+        QMessageBox::warning(this, "警告", tr("写入文件 %1 失败！原因：%2.").arg(csvName).arg(csvFile.errorString()));
+        return;
     }
+    const double speed = nsecs > 0 ? payload.size() * 1000.0 / nsecs : 0;
+    QString info = tr("已转换%1个数值，转换速度%2 MB/s。").arg(count).arg(speed, 0, 'f', 1);
+    const int remainder = int(payload.size() % FieldCodec::fieldSize(type));
+    if(remainder > 0)
+        info += tr("末尾%1字节不足一个数值，已忽略。").arg(remainder);
+    QMessageBox::information(this, "信息提示", info);
 }
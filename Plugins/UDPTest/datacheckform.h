@@ -3,6 +3,7 @@
 
 #include <QWidget>
 #include "typeconvert.h"
+#include "checkalgorithm.h"
 #include <QButtonGroup>
 
 namespace Ui {
@@ -14,14 +15,6 @@ class DataCheckForm : public QWidget
     Q_OBJECT
 
 public:
-
-    /***** Singleton pattern class definition *******/
-    static DataCheckForm& getDCFInstance()
-    {
-        static DataCheckForm instance;
-        return instance;
-    }
-
     explicit DataCheckForm(QWidget *parent = nullptr);
     ~DataCheckForm();
 
@@ -54,23 +47,23 @@ public:
     Q_ENUM(CRC32_Mode)
 
     // Qt反射：就是运行时把字符串映射为类，函数声明时必须使用Q_INVOKABLE
-    Q_INVOKABLE quint8 CRC8(char *data, quint16 dataLen);
-    Q_INVOKABLE quint8 CRC8_MAXIM(char *data, quint16 dataLen);
-    Q_INVOKABLE quint8 CRC8_ITU(char *data, quint16 dataLen);
-    Q_INVOKABLE quint8 CRC8_ROHC(char *data, quint16 dataLen);
-
-    Q_INVOKABLE quint16 CRC16_CCITT_TRUE(char *data, quint16 dataLen);
-    Q_INVOKABLE quint16 CRC16_CCITT_FALSE(char *data, quint16 dataLen);
-    Q_INVOKABLE quint16 CRC16_XMODEM(char *data, quint16 dataLen);
-    Q_INVOKABLE quint16 CRC16_X25(char *data, quint16 dataLen);
-    Q_INVOKABLE quint16 CRC16_MODBUS(char *data, quint16 dataLen);
-    Q_INVOKABLE quint16 CRC16_IBM(char* data, quint16 dataLen);
-    Q_INVOKABLE quint16 CRC16_MAXIM(char *data, quint16 dataLen);
-    Q_INVOKABLE quint16 CRC16_USB(char* data, quint16 dataLen);
-    Q_INVOKABLE quint16 CRC16_DNP(char *data, quint16 dataLen);
-
-    Q_INVOKABLE quint32 CRC32_WINRAR(char *data, quint16 dataLen);         // WinRar使用该校验算法
-    Q_INVOKABLE quint32 CRC32_MPEG(char *data, quint16 dataLen);    // MPEG使用该校验算法
+    Q_INVOKABLE quint8 CRC8(char *data, qint64 dataLen);
+    Q_INVOKABLE quint8 CRC8_MAXIM(char *data, qint64 dataLen);
+    Q_INVOKABLE quint8 CRC8_ITU(char *data, qint64 dataLen);
+    Q_INVOKABLE quint8 CRC8_ROHC(char *data, qint64 dataLen);
+
+    Q_INVOKABLE quint16 CRC16_CCITT_TRUE(char *data, qint64 dataLen);
+    Q_INVOKABLE quint16 CRC16_CCITT_FALSE(char *data, qint64 dataLen);
+    Q_INVOKABLE quint16 CRC16_XMODEM(char *data, qint64 dataLen);
+    Q_INVOKABLE quint16 CRC16_X25(char *data, qint64 dataLen);
+    Q_INVOKABLE quint16 CRC16_MODBUS(char *data, qint64 dataLen);
+    Q_INVOKABLE quint16 CRC16_IBM(char* data, qint64 dataLen);
+    Q_INVOKABLE quint16 CRC16_MAXIM(char *data, qint64 dataLen);
+    Q_INVOKABLE quint16 CRC16_USB(char* data, qint64 dataLen);
+    Q_INVOKABLE quint16 CRC16_DNP(char *data, qint64 dataLen);
+
+    Q_INVOKABLE quint32 CRC32_WINRAR(char *data, qint64 dataLen);         // WinRar使用该校验算法
+    Q_INVOKABLE quint32 CRC32_MPEG(char *data, qint64 dataLen);    // MPEG使用该校验算法
 
 private slots:
     void on_pushButton_Convert1_clicked();
@@ -109,6 +102,8 @@ private slots:
 
     void on_comboBox_ChecksumLength_currentIndexChanged(int index);
 
+    void on_comboBox_CheckAlgorithm_currentIndexChanged(int index);
+
     void on_pushButton_Generate_Checkcode_clicked();
 
     // 选择CRC校验码字节序的多个QRadioButton控件的槽函数
@@ -116,19 +111,19 @@ private slots:
 
     void on_checkBox_FormatData_stateChanged(int arg1);
 
-    void on_textEdit_ByteString_textChanged();
+    void on_pushButton_BulkPack_clicked();
 
-private:
-    void InvertUint16(quint16 *destUShort, quint16 *srcUShort);
-    void InvertUint8(quint8 *destUch, quint8 *srcUch);
-    void InvertUint32(quint32 *destUInt, quint32 *srcUInt);
+    void on_pushButton_BulkUnpack_clicked();
 
+private:
     Ui::DataCheckForm *ui;
     // Variables for TypeConvert
-    TypeConvert tcInstance = TypeConvert::getTCInstance();
+    TypeConvert &tcInstance = TypeConvert::getTCInstance();
     // false：小端存储；true：大端存储。缺省为小端存储
     bool  crcByteOrder = false;
     QButtonGroup *sendModeGroup = nullptr;
+    // 当前选择的校验算法
+    const CheckAlgorithm *checkAlgorithm = nullptr;
 
 };
 
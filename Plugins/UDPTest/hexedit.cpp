@@ -0,0 +1,395 @@
+#include "hexedit.h"
+#include "hexcodec.h"
+#include <QApplication>
+#include <QClipboard>
+#include <QFontDatabase>
+#include <QKeyEvent>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QScrollBar>
+
+namespace
+{
+    // 文字与边框的距离
+    constexpr int Margin = 4;
+
+    int digitValue(QChar ch)
+    {
+        const ushort c = ch.unicode();
+        if(c >= '0' && c <= '9')
+            return c - '0';
+        if(c >= 'a' && c <= 'f')
+            return c - 'a' + 10;
+        if(c >= 'A' && c <= 'F')
+            return c - 'A' + 10;
+        return -1;
+    }
+}
+
+HexEdit::HexEdit(QWidget *parent) : QAbstractScrollArea(parent)
+{
+    setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    setFocusPolicy(Qt::StrongFocus);
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    viewport()->setCursor(Qt::IBeamCursor);
+    updateLayout();
+}
+
+void HexEdit::setData(const QByteArray &data)
+{
+    table.setData(data);
+    cursor = anchor = 0;
+    halfByte = -1;
+    verticalScrollBar()->setValue(0);
+    edited();
+}
+
+void HexEdit::appendData(const QByteArray &data)
+{
+    table.insert(table.size(), data);
+    cursor = anchor = table.size();
+    halfByte = -1;
+    edited();
+}
+
+void HexEdit::clear()
+{
+    setData(QByteArray());
+}
+
+void HexEdit::setText(const QString &hexText)
+{
+    setData(HexCodec::fromHex(hexText));
+}
+
+QString HexEdit::toPlainText() const
+{
+    return HexCodec::toHex(table.toByteArray(), spaced ? HexCodec::Spaced : HexCodec::Compact);
+}
+
+void HexEdit::setPlaceholderText(const QString &text)
+{
+    placeholder = text;
+    viewport()->update();
+}
+
+void HexEdit::setSpaced(bool on)
+{
+    spaced = on;
+    updateLayout();
+    ensureCursorVisible();
+    viewport()->update();
+}
+
+void HexEdit::updateLayout()
+{
+    const QFontMetrics metrics(font());
+    charWidth = qMax(1, metrics.horizontalAdvance(QLatin1Char('0')));
+    lineHeight = qMax(1, metrics.height());
+    // 带空格时最后一个字节后面不需要空格
+    const int width = viewport()->width() - 2 * Margin + (spaced ? charWidth : 0);
+    const int fit = qMax(1, width / (cellChars() * charWidth));
+    bytesPerRow = fit >= 8 ? fit - fit % 8 : fit;
+    updateScrollRange();
+}
+
+int HexEdit::visibleRows() const
+{
+    return qMax(1, (viewport()->height() - 2 * Margin) / lineHeight);
+}
+
+void HexEdit::updateScrollRange()
+{
+    // 末尾留出光标所在的位置
+    const qint64 rows = table.size() / bytesPerRow + 1;
+    const int pageRows = visibleRows();
+    verticalScrollBar()->setRange(0, int(qMax<qint64>(0, rows - pageRows)));
+    verticalScrollBar()->setPageStep(pageRows);
+    verticalScrollBar()->setSingleStep(1);
+}
+
+void HexEdit::ensureCursorVisible()
+{
+    const qint64 row = cursor / bytesPerRow;
+    const int first = verticalScrollBar()->value();
+    if(row < first)
+        verticalScrollBar()->setValue(int(row));
+    else if(row >= first + visibleRows())
+        verticalScrollBar()->setValue(int(row - visibleRows() + 1));
+}
+
+void HexEdit::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+    QPainter painter(viewport());
+    const QPalette &pal = palette();
+    if(table.isEmpty() && !placeholder.isEmpty())
+    {
+        painter.setPen(pal.color(QPalette::PlaceholderText));
+        painter.drawText(viewport()->rect().adjusted(Margin, Margin, -Margin, -Margin),
+                         Qt::AlignLeft | Qt::AlignTop | Qt::TextWordWrap, placeholder);
+    }
+
+    // 只读取可见行的字节
+    const qint64 firstRow = verticalScrollBar()->value();
+    const int rows = visibleRows() + 1;
+    const qint64 begin = firstRow * bytesPerRow;
+    const QByteArray visible = table.mid(begin, qint64(rows) * bytesPerRow);
+    const int options = spaced ? HexCodec::Spaced : HexCodec::Compact;
+    const int cell = cellChars() * charWidth;
+    const qint64 selStart = qMin(anchor, cursor);
+    const qint64 selEnd = qMax(anchor, cursor);
+    const int ascent = QFontMetrics(font()).ascent();
+    QString line;
+    for(auto r = 0; r < rows; ++r)
+    {
+        const qint64 rowBegin = begin + qint64(r) * bytesPerRow;
+        const int count = int(qMin<qint64>(bytesPerRow, visible.size() - qint64(r) * bytesPerRow));
+        const int y = Margin + r * lineHeight;
+        if(count > 0)
+        {
+            line.resize(int(HexCodec::encodedLength(count, options)));
+            HexCodec::encode(reinterpret_cast<const uchar*>(visible.constData()) + r * bytesPerRow, count,
+                             reinterpret_cast<ushort*>(line.data()), options);
+            // 只输入了一个数字的字节只显示该数字
+            if(halfByte >= rowBegin && halfByte < rowBegin + count)
+            {
+                const int i = int(halfByte - rowBegin) * cellChars();
+                line[i] = line[i + 1];
+                line[i + 1] = ' ';
+            }
+            painter.setPen(pal.color(QPalette::Text));
+            painter.drawText(Margin, y + ascent, line);
+
+            // 选中部分用高亮颜色重新绘制
+            const qint64 from = qMax(selStart, rowBegin);
+            const qint64 to = qMin(selEnd, rowBegin + count);
+            if(from < to)
+            {
+                const QRect rect(Margin + int(from - rowBegin) * cell, y,
+                                 int(to - from) * cell - (spaced ? charWidth : 0), lineHeight);
+                painter.fillRect(rect, pal.color(QPalette::Highlight));
+                painter.save();
+                painter.setClipRect(rect);
+                painter.setPen(pal.color(QPalette::HighlightedText));
+                painter.drawText(Margin, y + ascent, line);
+                painter.restore();
+            }
+        }
+
+        // 光标
+        if(hasFocus() && cursor >= rowBegin && cursor < rowBegin + bytesPerRow)
+        {
+            int x = Margin + int(cursor - rowBegin) * cell;
+            if(halfByte >= 0 && halfByte == cursor - 1 && cursor != rowBegin)
+                x -= cell - charWidth;
+            painter.fillRect(QRect(x, y, 2, lineHeight), pal.color(QPalette::Text));
+        }
+        if(count < bytesPerRow)
+            break;
+    }
+}
+
+void HexEdit::resizeEvent(QResizeEvent *event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+    updateLayout();
+}
+
+qint64 HexEdit::positionAt(const QPoint &point) const
+{
+    const int cell = cellChars() * charWidth;
+    const qint64 row = verticalScrollBar()->value() + qMax(0, point.y() - Margin) / lineHeight;
+    // 点在字节的后半部分时光标放在该字节之后
+    const int col = qBound(0, (point.x() - Margin + cell / 2) / cell, bytesPerRow);
+    return qMin(table.size(), row * bytesPerRow + col);
+}
+
+void HexEdit::moveCursor(qint64 pos, bool select)
+{
+    cursor = qBound<qint64>(0, pos, table.size());
+    if(!select)
+        anchor = cursor;
+    halfByte = -1;
+    ensureCursorVisible();
+    viewport()->update();
+}
+
+bool HexEdit::removeSelection()
+{
+    if(!hasSelection())
+        return false;
+    const qint64 from = qMin(anchor, cursor);
+    table.remove(from, qAbs(cursor - anchor));
+    cursor = anchor = from;
+    halfByte = -1;
+    return true;
+}
+
+void HexEdit::insertBytes(const QByteArray &bytes)
+{
+    removeSelection();
+    table.insert(cursor, bytes);
+    cursor = anchor = cursor + bytes.size();
+    halfByte = -1;
+    edited();
+}
+
+void HexEdit::inputDigit(int value)
+{
+    removeSelection();
+    if(halfByte >= 0 && halfByte == cursor - 1)
+    {
+        table.setByte(halfByte, char((uchar(table.at(halfByte)) << 4) | value));
+        halfByte = -1;
+    }
+    else
+    {
+        const char byte = char(value);
+        table.insert(cursor, &byte, 1);
+        halfByte = cursor;
+        cursor = anchor = cursor + 1;
+    }
+    edited();
+}
+
+void HexEdit::copy() const
+{
+    if(!hasSelection())
+        return;
+    const QByteArray selected = table.mid(qMin(anchor, cursor), qAbs(cursor - anchor));
+    QApplication::clipboard()->setText(HexCodec::toHex(selected, spaced ? HexCodec::Spaced : HexCodec::Compact));
+}
+
+void HexEdit::paste()
+{
+    const QByteArray bytes = HexCodec::fromHex(QApplication::clipboard()->text());
+    if(!bytes.isEmpty())
+        insertBytes(bytes);
+}
+
+void HexEdit::edited()
+{
+    updateScrollRange();
+    ensureCursorVisible();
+    viewport()->update();
+    emit dataChanged();
+}
+
+void HexEdit::keyPressEvent(QKeyEvent *event)
+{
+    const bool select = event->modifiers() & Qt::ShiftModifier;
+    const bool control = event->modifiers() & Qt::ControlModifier;
+    if(event->matches(QKeySequence::SelectAll))
+    {
+        anchor = 0;
+        moveCursor(table.size(), true);
+        return;
+    }
+    if(event->matches(QKeySequence::Copy))
+    {
+        copy();
+        return;
+    }
+    if(event->matches(QKeySequence::Cut))
+    {
+        copy();
+        if(removeSelection())
+            edited();
+        return;
+    }
+    if(event->matches(QKeySequence::Paste))
+    {
+        paste();
+        return;
+    }
+
+    const qint64 rowStart = cursor - cursor % bytesPerRow;
+    const qint64 page = qint64(visibleRows()) * bytesPerRow;
+    switch (event->key())
+    {
+    case Qt::Key_Left:
+        moveCursor(cursor - 1, select);
+        return;
+    case Qt::Key_Right:
+        moveCursor(cursor + 1, select);
+        return;
+    case Qt::Key_Up:
+        if(cursor >= bytesPerRow)
+            moveCursor(cursor - bytesPerRow, select);
+        return;
+    case Qt::Key_Down:
+        moveCursor(cursor + bytesPerRow, select);
+        return;
+    case Qt::Key_PageUp:
+        moveCursor(cursor - page, select);
+        return;
+    case Qt::Key_PageDown:
+        moveCursor(cursor + page, select);
+        return;
+    case Qt::Key_Home:
+        moveCursor(control ? 0 : rowStart, select);
+        return;
+    case Qt::Key_End:
+        moveCursor(control ? table.size() : qMin(table.size(), rowStart + bytesPerRow - 1), select);
+        return;
+    case Qt::Key_Backspace:
+        if(!removeSelection())
+        {
+            if(cursor == 0)
+                return;
+            table.remove(cursor - 1, 1);
+            cursor = anchor = cursor - 1;
+            halfByte = -1;
+        }
+        edited();
+        return;
+    case Qt::Key_Delete:
+        if(!removeSelection())
+        {
+            if(cursor == table.size())
+                return;
+            table.remove(cursor, 1);
+            halfByte = -1;
+        }
+        edited();
+        return;
+    default:
+        break;
+    }
+
+    const QString text = event->text();
+    if(text.size() == 1 && !control && !(event->modifiers() & Qt::AltModifier) && text.at(0).isPrint())
+    {
+        // 只接受十六进制数字，空格等其它字符直接忽略
+        const int value = digitValue(text.at(0));
+        if(value >= 0)
+            inputDigit(value);
+        return;
+    }
+    QAbstractScrollArea::keyPressEvent(event);
+}
+
+void HexEdit::mousePressEvent(QMouseEvent *event)
+{
+    if(event->button() == Qt::LeftButton)
+        moveCursor(positionAt(event->pos()), event->modifiers() & Qt::ShiftModifier);
+}
+
+void HexEdit::mouseMoveEvent(QMouseEvent *event)
+{
+    if(event->buttons() & Qt::LeftButton)
+        moveCursor(positionAt(event->pos()), true);
+}
+
+void HexEdit::focusInEvent(QFocusEvent *event)
+{
+    QAbstractScrollArea::focusInEvent(event);
+    viewport()->update();
+}
+
+void HexEdit::focusOutEvent(QFocusEvent *event)
+{
+    QAbstractScrollArea::focusOutEvent(event);
+    viewport()->update();
+}
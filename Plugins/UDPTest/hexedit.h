@@ -0,0 +1,113 @@
+#ifndef HEXEDIT_H
+#define HEXEDIT_H
+
+#include <QAbstractScrollArea>
+#include "bytepiecetable.h"
+
+/*********************************************************************************
+** 文件描述：       大数据量的十六进制编辑框，代替输入十六进制数据的QTextEdit
+** 设计：          内容以字节保存在BytePieceTable中，不保存文本：按键、粘贴只修改分段表，
+**                代价与数据长度无关；绘制时只读取并格式化可见的几行，滚动条按行计算。
+**                只接受十六进制数字，其它字符直接忽略，内容始终是合法的字节，不需要再校验全文。
+**                输入第一个数字时插入一个值为该数字的字节（只显示这一个数字），输入第二个数字后
+**                该字节变为高4位+低4位，与HexStringToByteArray对末尾单个数字的处理一致。
+**                光标和选择以字节为单位，支持方向键、Home/End、PageUp/PageDown、Shift和鼠标选择、
+**                全选、复制和剪切（十六进制文本）、粘贴（用HexCodec解码）。
+**                字节之间是否加空格只影响显示。setText()/toPlainText()兼容原QTextEdit的用法，
+**                计算校验时用bytes().segments()直接取得各段字节，不需要转换为文本再解析。
+**********************************************************************************/
+
+class HexEdit : public QAbstractScrollArea
+{
+    Q_OBJECT
+public:
+    explicit HexEdit(QWidget *parent = nullptr);
+
+    const BytePieceTable& bytes() const
+    {
+        return table;
+    }
+    QByteArray data() const
+    {
+        return table.toByteArray();
+    }
+    qint64 size() const
+    {
+        return table.size();
+    }
+    // 替换全部内容，QByteArray隐式共享，不复制
+    void setData(const QByteArray &data);
+    // 在末尾追加字节，光标移到末尾
+    void appendData(const QByteArray &data);
+    void clear();
+
+    // 十六进制文本，兼容QTextEdit的用法；大数据应使用data()、bytes()
+    void setText(const QString &hexText);
+    QString toPlainText() const;
+
+    void setPlaceholderText(const QString &text);
+    QString placeholderText() const
+    {
+        return placeholder;
+    }
+
+    // 字节之间是否显示空格
+    void setSpaced(bool on);
+    bool isSpaced() const
+    {
+        return spaced;
+    }
+
+signals:
+    // 内容被修改
+    void dataChanged();
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void keyPressEvent(QKeyEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void focusInEvent(QFocusEvent *event) override;
+    void focusOutEvent(QFocusEvent *event) override;
+
+private:
+    // 按宽度和字体重新计算每行的字节数
+    void updateLayout();
+    void updateScrollRange();
+    int visibleRows() const;
+    // 每个字节占的字符数
+    int cellChars() const
+    {
+        return spaced ? 3 : 2;
+    }
+    // 把光标移到pos；select为true时保留选择起点
+    void moveCursor(qint64 pos, bool select);
+    void ensureCursorVisible();
+    // 坐标point处的光标位置
+    qint64 positionAt(const QPoint &point) const;
+    bool hasSelection() const
+    {
+        return anchor != cursor;
+    }
+    // 删除选中的字节，没有选择时返回false
+    bool removeSelection();
+    void insertBytes(const QByteArray &bytes);
+    void inputDigit(int value);
+    void copy() const;
+    void paste();
+    // 内容修改后更新滚动条、显示并发出dataChanged()
+    void edited();
+
+    BytePieceTable table;
+    QString placeholder;
+    bool spaced = true;
+    int bytesPerRow = 16;
+    int charWidth = 1;
+    int lineHeight = 1;
+    qint64 cursor = 0;      // 光标在第cursor个字节之前
+    qint64 anchor = 0;      // 选择起点，没有选择时与cursor相同
+    qint64 halfByte = -1;   // 刚输入了一个数字的字节，没有时为-1
+};
+
+#endif // HEXEDIT_H
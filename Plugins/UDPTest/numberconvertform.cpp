@@ -1,16 +1,25 @@
 #include "numberconvertform.h"
 #include "ui_numberconvertform.h"
+#include "crcengine.h"
+#include "checksumengine.h"
+#include "checksumcontext.h"
+#include "hashcontext.h"
+#include "crcparamloader.h"
+#include "checksumbatch.h"
+#include "checksumdetect.h"
+#include "hexstreamdecoder.h"
 #include <QFile>
 #include <QDebug>
-#include <QAxObject>
 #include <QDir>
 #include <QScrollBar>
-#include <QMetaEnum>
 #include <QTextBlock>
 #include <QCryptographicHash>
 #include <QFileDialog>
+#include <QFileInfo>
 #include <QMessageBox>
 #include <QMimeDatabase>
+#include <QtConcurrent>
+#include <algorithm>
 
 NumberConvertForm::NumberConvertForm(QWidget *parent) :
     QWidget(parent),
@@ -102,23 +111,49 @@ NumberConvertForm::NumberConvertForm(QWidget *parent) :
     connect(ui->radioButton_ASCII, SIGNAL(clicked()), this, SLOT(onRadioClickSelecDataType()));
     connect(ui->radioButton_Hex, SIGNAL(clicked()), this, SLOT(onRadioClickSelecDataType()));
 
-    ui->textEdit_MD5Input->setPlaceholderText("请输入MD5校验数据！");
-    ui->textEdit_MD5Output->setPlaceholderText("输出MD5校验码！");
+    // 摘要算法，顺序与Hash_Mode一致
+    ui->comboBox_HashAlgorithm->addItem("MD5", HashContext::Md5);
+    ui->comboBox_HashAlgorithm->addItem("SHA-256", HashContext::Sha256);
+    ui->comboBox_HashAlgorithm->addItem("XXH3-64", HashContext::Xxh3_64);
+    ui->comboBox_HashAlgorithm->addItem("XXH3-128", HashContext::Xxh3_128);
+    ui->comboBox_HashAlgorithm->addItem("BLAKE3", HashContext::Blake3_256);
+    ui->label_HashSpeed->setToolTip("最近一次摘要计算的速度");
+    ui->textEdit_MD5Input->setPlaceholderText("请输入摘要校验数据！");
+    ui->textEdit_MD5Output->setPlaceholderText("输出摘要！");
     ui->lineEdit_File_Data_Source->setFocusPolicy(Qt::NoFocus);
     ui->checkBox_ByteOrder->setCheckState(Qt::Checked);
     ui->checkBox_FormatData_2->setCheckState(Qt::Unchecked);
-    ui->lineEdit_File_Data_Source->setPlaceholderText("请选择MD5校验文件！");
+    ui->lineEdit_File_Data_Source->setPlaceholderText("请选择摘要校验文件！");
+    ui->progressBar_FileHash->setValue(0);
+    // 文件摘要在后台计算，信号自动排队到界面线程
+    fileHash = new FileHashJob(this);
+    connect(fileHash, &FileHashJob::progress, this, [this](qint64 bytesDone, qint64 bytesTotal) {
+        ui->progressBar_FileHash->setValue(bytesTotal > 0 ? int(bytesDone * 100 / bytesTotal) : 100);
+    });
+    connect(fileHash, &FileHashJob::finished, this, &NumberConvertForm::onFileHashFinished);
+    connect(fileHash, &FileHashJob::failed, this, [this](const QString &errorString) {
+        onFileHashStopped();
+        QString errInfo = tr("读取文件 %1 失败！原因：%2.").arg(ui->lineEdit_File_Data_Source->text()).arg(errorString);
+        qWarning().noquote() << errInfo;
+        QMessageBox::warning(this, "警告", errInfo);
+    });
+    connect(fileHash, &FileHashJob::canceled, this, [this]() {
+        onFileHashStopped();
+        ui->progressBar_FileHash->setValue(0);
+    });
 
     // Checksum校验初始化
-    QMetaEnum me = QMetaEnum::fromType<NumberConvertForm::CHECKSUM_Mode>();
-    for(auto i = 0; i < me.keyCount(); ++i)
-        ui->comboBox_CheckSum->addItem(me.key(i));
+    const auto checksumAlgorithms = CheckAlgorithmRegistry::getCARInstance().list(CheckAlgorithm::Checksum);
+    for(auto algorithm : checksumAlgorithms)
+        ui->comboBox_CheckSum->addItem(algorithm->name);
     ui->checkBox_Checksum_ByteOrder->setCheckState(Qt::Checked);
     ui->lineEdit_Checksum->setPlaceholderText("Hex输出！");
     ui->lineEdit_Checksum->setFocusPolicy(Qt::NoFocus);
     ui->lineEdit_Checksum_Dec->setPlaceholderText("Dec输出！");
     ui->lineEdit_Checksum_Dec->setFocusPolicy(Qt::NoFocus);
     ui->textEdit_ChecksumInput->setPlaceholderText("请输入十六进制字符数据！");
+    // 字节数据缺省在字节间显示空格
+    ui->checkBox_Checksum_FormatData->setChecked(true);
 
     // CRC校验初始化
     ui->textEdit_CRCInput->setPlaceholderText("请输入十六进制字符数据！");
@@ -126,11 +161,32 @@ NumberConvertForm::NumberConvertForm(QWidget *parent) :
     ui->lineEdit_Checkcode->setFocusPolicy(Qt::NoFocus);
     ui->lineEdit_Checkcode_Dec->setPlaceholderText("Dec输出！");
     ui->lineEdit_Checkcode_Dec->setFocusPolicy(Qt::NoFocus);
+    // 文件校验码在后台多线程计算，结束时恢复按钮
+    fileCheck = new FileHashJob(this);
+    connect(fileCheck, &FileHashJob::progress, this, [this](qint64 bytesDone, qint64 bytesTotal) {
+        const int percent = bytesTotal > 0 ? int(bytesDone * 100 / bytesTotal) : 100;
+        ui->pushButton_Select_CheckFile->setText(QString("取消 %1%").arg(percent));
+    });
+    connect(fileCheck, &FileHashJob::finished, this, &NumberConvertForm::onFileCheckFinished);
+    connect(fileCheck, &FileHashJob::failed, this, [this](const QString &errorString) {
+        ui->pushButton_Select_CheckFile->setText("文件校验");
+        ui->lineEdit_Checkcode->setText("读取文件失败！");
+        qWarning().noquote() << "计算文件校验码失败：" << errorString;
+    });
+    connect(fileCheck, &FileHashJob::canceled, this, [this]() {
+        ui->pushButton_Select_CheckFile->setText("文件校验");
+    });
+    // CRC参数反推在后台进行，结束时在界面线程中填写表格
+    crcSearch = new QFutureWatcher<QPair<QVector<CrcSearchResult>, QString>>(this);
+    connect(crcSearch, &QFutureWatcherBase::finished, this, &NumberConvertForm::onCrcSearchFinished);
 
 }
 
 NumberConvertForm::~NumberConvertForm()
 {
+    // 后台搜索引用了本对象的取消标志，先结束搜索
+    crcSearchCancel.storeRelaxed(1);
+    crcSearch->waitForFinished();
     delete ui;
 }
 
@@ -146,107 +202,324 @@ void NumberConvertForm::on_pushButton_UpdateCRCParams_clicked()
 void NumberConvertForm::on_comboBox_ChecksumLength_currentIndexChanged(int index)
 {
     ui->comboBox_CheckAlgorithm->clear();
-    QMetaEnum me;
+    const CheckAlgorithmRegistry &registry = CheckAlgorithmRegistry::getCARInstance();
+    QVector<const CheckAlgorithm*> algorithms;
     switch (index)
     {
     case 0:
-        // 获得枚举类型的元数据对象
-        me = QMetaEnum::fromType<NumberConvertForm::CRC8_Mode>();
-        for(auto i = 0; i < me.keyCount(); ++i)
-            ui->comboBox_CheckAlgorithm->addItem(me.key(i));
+        // 1字节校验码：CRC8系列算法及8位Checksum
+        algorithms = registry.list(CheckAlgorithm::Crc, 8);
+        algorithms.append(registry.find("Checksum_8"));
         // 显示支持的CRC8算法配置列表
         DisPlay_CRC8_Configation_List();
         break;
     case 1:
-        me = QMetaEnum::fromType<NumberConvertForm::CRC16_Mode>();
-        for(auto i = 0; i < me.keyCount(); ++i)
-            ui->comboBox_CheckAlgorithm->addItem(me.key(i));
+        algorithms = registry.list(CheckAlgorithm::Crc, 16);
         // 显示支持的CRC16算法列表
         DisPlay_CRC16_Configation_List();
         break;
     case 2:
-        me = QMetaEnum::fromType<NumberConvertForm::CRC32_Mode>();
-        for(auto i = 0; i < me.keyCount(); ++i)
-            ui->comboBox_CheckAlgorithm->addItem(me.key(i));
+        algorithms = registry.list(CheckAlgorithm::Crc, 32);
         // 显示支持的CRC32算法配置列表
         DisPlay_CRC32_Configation_List();
         break;
     default:
         break;
     }
+    for(auto algorithm : algorithms)
+        ui->comboBox_CheckAlgorithm->addItem(algorithm->name);
+    // CRC参数配置表中未登记的自定义算法也加入列表，条目数据为该算法在配置表中的行号
+    int width = 0;
+    const QVector<QVector<QString>> *sheet = Current_CRC_Sheet(&width);
+    for(auto row = 0; sheet != nullptr && row + 1 < sheet->size(); ++row)
+    {
+        CrcParams params;
+        QString name;
+        if(CrcParamLoader::rowParams(*sheet, row, width, &params, &name) && registry.find(params) == nullptr)
+            ui->comboBox_CheckAlgorithm->addItem(name, row);
+    }
     emit ui->comboBox_CheckAlgorithm->activated(ui->comboBox_CheckAlgorithm->currentIndex());
 }
 
+// 切换校验算法时从注册表取得算法，产生校验码时直接调用；
+// 自定义算法按配置表中的参数从CrcModelCache取得模型，切换回来时不重新生成查找表
+void NumberConvertForm::on_comboBox_CheckAlgorithm_currentIndexChanged(int index)
+{
+    const QVariant row = ui->comboBox_CheckAlgorithm->itemData(index);
+    checkAlgorithm = row.isValid() ? nullptr : CheckAlgorithmRegistry::getCARInstance().find(ui->comboBox_CheckAlgorithm->itemText(index));
+    customCrc.reset();
+    if(!row.isValid())
+        return;
+    int width = 0;
+    const QVector<QVector<QString>> *sheet = Current_CRC_Sheet(&width);
+    CrcParams params;
+    if(sheet != nullptr && CrcParamLoader::rowParams(*sheet, row.toInt(), width, &params))
+        customCrc = CrcModelCache::get(params);
+}
 
-// 产生校验码函数  20221102
-void NumberConvertForm::on_pushButton_Generate_Checkcode_clicked()
+// 当前校验码长度对应的CRC参数配置表及其缺省宽度
+const QVector<QVector<QString>>* NumberConvertForm::Current_CRC_Sheet(int *width) const
 {
-    QString hexStr = ui->textEdit_CRCInput->toPlainText();
-    QByteArray ba = tcInstance.HexStringToByteArray(hexStr);
-    NumberConvertForm& pCRC = NumberConvertForm::getDCFInstance();
-    char* pCrcCheckSum = ba.data();    // QByteArray转char*
-    quint8 ret8 = 0;
-    quint16 ret16 = 0;
-    quint32 ret32 = 0;
-    QString methodName = ui->comboBox_CheckAlgorithm->currentText().toUpper();
-    bool callResult = false;
     switch (ui->comboBox_ChecksumLength->currentIndex())
     {
-    case 0: // 处理1字节校验码
-        callResult = QMetaObject::invokeMethod(&pCRC, methodName.toLatin1().data(), Qt :: AutoConnection,
-                                               Q_RETURN_ARG(quint8, ret8),
-                                               Q_ARG(char*, pCrcCheckSum), Q_ARG(quint16, ba.size()));
-        break;
-    case 1: // 处理2字节校验码
-        // Note：被调用QMetaObject::invokeMethod的参数类型必须严格一致。Q_ARG()宏不识别quint8类型，需要使用char
-        callResult = QMetaObject::invokeMethod(&pCRC, methodName.toLatin1().data(), Qt :: AutoConnection,
-                                               Q_RETURN_ARG(quint16, ret16),
-                                               Q_ARG(char*, pCrcCheckSum), Q_ARG(quint16, ba.size()));
-        break;
-    case 2: // 处理4字节校验码
-        qRegisterMetaType<quint32>("quint32");
-        callResult = QMetaObject::invokeMethod(&pCRC, methodName.toLatin1().data(), Qt :: AutoConnection,
-                                               Q_RETURN_ARG(quint32, ret32),
-                                               Q_ARG(char*, pCrcCheckSum), Q_ARG(quint16, ba.size()));
-        break;
+    case 0:
+        *width = 8;
+        return &crc8Data;
+    case 1:
+        *width = 16;
+        return &crc16Data;
+    case 2:
+        *width = 32;
+        return &crc32Data;
     default:
-        break;
+        return nullptr;
+    }
+}
+
+// 与上次计算的数据等长且算法相同时（如修改了帧中的某个字节），只取出变化的字节范围，
+// 由上次的校验码增量更新（见CrcEngine::patch），CRC的计算量只与变化范围有关；
+// 累加和类算法没有增量更新，完整计算
+quint64 NumberConvertForm::Compute_Checkcode(const QByteArray &data)
+{
+    const bool patchable = (checkAlgorithm == nullptr || checkAlgorithm->patch != nullptr)
+            && checkAlgorithm == lastCheckAlgorithm && customCrc == lastCustomCrc
+            && data.size() == lastCheckData.size();
+    quint64 ret;
+    if(patchable)
+    {
+        // 变化的字节范围[begin, end)，delta为新旧字节的异或
+        const int begin = int(std::mismatch(data.cbegin(), data.cend(), lastCheckData.cbegin()).first - data.cbegin());
+        const int end = data.size() - int(std::mismatch(data.crbegin(), data.crend() - begin,
+                                                        lastCheckData.crbegin()).first - data.crbegin());
+        QByteArray delta(end - begin, 0);
+        for(auto i = begin; i < end; ++i)
+            delta[i - begin] = char(data.at(i) ^ lastCheckData.at(i));
+        ret = checkAlgorithm != nullptr ? checkAlgorithm->patch(lastCheckcode, data.size(), begin, delta.constData(), delta.size())
+                                        : customCrc->patch(lastCheckcode, data.size(), begin, delta.constData(), delta.size());
+    }
+    else
+    {
+        ret = checkAlgorithm != nullptr ? checkAlgorithm->compute(data.constData(), data.size())
+                                        : customCrc->compute(data.constData(), data.size());
     }
-    if(!callResult)
+    lastCheckData = data;
+    lastCheckAlgorithm = checkAlgorithm;
+    lastCustomCrc = customCrc;
+    lastCheckcode = ret;
+    return ret;
+}
+
+// 产生校验码函数  20221102
+void NumberConvertForm::on_pushButton_Generate_Checkcode_clicked()
+{
+    if(checkAlgorithm == nullptr && customCrc.isNull())
     {
         ui->lineEdit_Checkcode->setText("调用校验函数失败！");
         return;
     }
+    QString hexStr = ui->textEdit_CRCInput->toPlainText();
+    QByteArray ba = tcInstance.HexStringToByteArray(hexStr);
+    // 输入为上次的数据（已修改部分字节）加上次产生的帧尾校验码时，去掉旧校验码，
+    // 对数据增量更新后换上新校验码；数据未修改时仍按原样把整帧作为数据
+    if(!lastCode.isEmpty() && checkAlgorithm == lastCheckAlgorithm && customCrc == lastCustomCrc
+            && ba.size() == lastCheckData.size() + lastCode.size() && ba.endsWith(lastCode)
+            && !ba.startsWith(lastCheckData))
+    {
+        ba.chop(lastCode.size());
+        hexStr = tcInstance.ByteArrayToHexString(ba);
+    }
+    const int width = checkAlgorithm != nullptr ? checkAlgorithm->width : customCrc->params().width;
+    const quint64 ret = Compute_Checkcode(ba);
     // 根据字节长度返回校验码
     QString checkcode = "";
-    switch (ui->comboBox_ChecksumLength->currentIndex())
+    switch (width)
     {
-    case 0:
-        ui->lineEdit_Checkcode_Dec->setText(QString::number(ret8));
-        checkcode = QString("%1").arg(ret8, 2, 16, QLatin1Char('0')).toUpper();
+    case 8:
+        ui->lineEdit_Checkcode_Dec->setText(QString::number(ret));
+        checkcode = QString("%1").arg(ret, 2, 16, QLatin1Char('0')).toUpper();
         ui->lineEdit_Checkcode->setText("0x" + checkcode);
         break;
-    case 1:
-        checkcode = tcInstance.DecToHexString(ret16, 2, false);
-        ui->lineEdit_Checkcode->setText("0x" + checkcode.remove(' '));
-        if(!crcByteOrder)
-            checkcode = tcInstance.DecToHexString(ret16, 2, !crcByteOrder);
-        ui->lineEdit_Checkcode_Dec->setText(QString::number(ret16));
-        break;
-    case 2:
-        // 输出十六进制格式：0xAABBCCDD
-        checkcode = tcInstance.DecToHexString(ret32, 4, false);
+    case 16:
+    case 32:
+        // 输出十六进制格式：0xAABB、0xAABBCCDD
+        checkcode = tcInstance.DecToHexString(quint32(ret), width / 8, false);
         ui->lineEdit_Checkcode->setText("0x" + checkcode.remove(' '));
         if(!crcByteOrder)
-            checkcode = tcInstance.DecToHexString(ret32, 4, !crcByteOrder);
-        ui->lineEdit_Checkcode_Dec->setText(QString::number(ret32));
+            checkcode = tcInstance.DecToHexString(quint32(ret), width / 8, !crcByteOrder);
+        ui->lineEdit_Checkcode_Dec->setText(QString::number(ret));
         break;
     default:
+    {
+        // 自定义宽度（1~64位）：按所占字节数输出
+        const int bytes = (width + 7) / 8;
+        QByteArray code(bytes, 0);
+        for(auto i = 0; i < bytes; ++i)
+            code[bytes - 1 - i] = char(ret >> (8 * i));
+        ui->lineEdit_Checkcode->setText("0x" + tcInstance.ByteArrayToHexString(code).remove(' '));
+        if(!crcByteOrder)
+            std::reverse(code.begin(), code.end());
+        checkcode = tcInstance.ByteArrayToHexString(code);
+        ui->lineEdit_Checkcode_Dec->setText(QString::number(ret));
         break;
     }
+    }
+    lastCode = tcInstance.HexStringToByteArray(checkcode);
     ui->textEdit_CRCInput->setText(tcInstance.StringNoNullToNull(hexStr+checkcode));
 }
 
+// 一次计算全部校验算法（含CRC参数配置表中的自定义算法），在表格中按大端、小端列出结果；
+// 切换校验码长度时表格恢复显示CRC参数配置列表
+void NumberConvertForm::on_pushButton_Generate_AllCheckcodes_clicked()
+{
+    const QByteArray ba = tcInstance.HexStringToByteArray(ui->textEdit_CRCInput->toPlainText());
+    const CheckAlgorithmRegistry &registry = CheckAlgorithmRegistry::getCARInstance();
+    QVector<QPair<QString, CrcParams>> custom;
+    const QVector<QVector<QString>> *sheets[] = { &crc8Data, &crc16Data, &crc32Data };
+    for(auto i = 0; i < 3; ++i)
+    {
+        for(auto row = 0; row + 1 < sheets[i]->size(); ++row)
+        {
+            CrcParams params;
+            QString name;
+            if(CrcParamLoader::rowParams(*sheets[i], row, 8 << i, &params, &name) && registry.find(params) == nullptr)
+                custom.append(qMakePair(name, params));
+        }
+    }
+    const QVector<ChecksumBatchResult> results = ChecksumBatch::computeAll(ba.constData(), ba.size(), custom);
+
+    ui->tableWidget->clear();
+    ui->tableWidget->setRowCount(0);
+    ui->tableWidget->setColumnCount(5);
+    ui->tableWidget->setHorizontalHeaderLabels(QStringList() << "校验算法" << "位数" << "大端存储" << "小端存储" << "十进制");
+    ui->tableWidget->setRowCount(results.size());
+    for(auto i = 0; i < results.size(); ++i)
+    {
+        const ChecksumBatchResult &result = results.at(i);
+        ui->tableWidget->setItem(i, 0, new QTableWidgetItem(result.name));
+        ui->tableWidget->setItem(i, 1, new QTableWidgetItem(QString::number(result.width)));
+        ui->tableWidget->setItem(i, 2, new QTableWidgetItem(tcInstance.ByteArrayToHexString(result.toBytes(true))));
+        ui->tableWidget->setItem(i, 3, new QTableWidgetItem(tcInstance.ByteArrayToHexString(result.toBytes(false))));
+        ui->tableWidget->setItem(i, 4, new QTableWidgetItem(QString::number(result.value)));
+        for(auto j = 1; j < 5; ++j)
+            ui->tableWidget->item(i, j)->setTextAlignment(Qt::AlignHCenter | Qt::AlignVCenter);
+    }
+}
+
+// 识别帧尾校验码使用的算法：输入框中每行一帧（数据+校验码），在表格中列出与全部帧一致的算法和字节序；
+// 注册表中的算法都不一致时改为反推CRC参数
+void NumberConvertForm::on_pushButton_Detect_Checkcode_clicked()
+{
+    // 反推CRC参数的过程中按钮用于取消
+    if(crcSearch->isRunning())
+    {
+        crcSearchCancel.storeRelaxed(1);
+        return;
+    }
+    QVector<QByteArray> frames;
+    const QStringList lines = ui->textEdit_CRCInput->toPlainText().split('\n');
+    for(const QString &line : lines)
+    {
+        const QByteArray text = line.toLatin1();
+        const QByteArray frame = HexStreamDecoder::decodeAll(text.constData(), text.size());
+        if(!frame.isEmpty())
+            frames.append(frame);
+    }
+    const QVector<ChecksumMatch> matches = ChecksumDetector::detect(frames);
+    // 注册表中没有一致的算法时，按当前选择的校验码长度反推CRC参数
+    if(matches.isEmpty() && !frames.isEmpty())
+    {
+        Detect_Crc_Params(frames);
+        return;
+    }
+
+    ui->tableWidget->clear();
+    ui->tableWidget->setRowCount(0);
+    ui->tableWidget->setColumnCount(4);
+    ui->tableWidget->setHorizontalHeaderLabels(QStringList() << "校验算法" << "位数" << "字节序" << "帧数");
+    if(matches.isEmpty())
+    {
+        ui->tableWidget->setRowCount(1);
+        ui->tableWidget->setItem(0, 0, new QTableWidgetItem("请输入帧数据，每行一帧！"));
+        return;
+    }
+    ui->tableWidget->setRowCount(matches.size());
+    for(auto i = 0; i < matches.size(); ++i)
+    {
+        const ChecksumMatch &match = matches.at(i);
+        ui->tableWidget->setItem(i, 0, new QTableWidgetItem(match.algorithm->name));
+        ui->tableWidget->setItem(i, 1, new QTableWidgetItem(QString::number(match.algorithm->width)));
+        ui->tableWidget->setItem(i, 2, new QTableWidgetItem(match.algorithm->bytes() == 1 ? "-" : (match.bigEndian ? "大端存储" : "小端存储")));
+        ui->tableWidget->setItem(i, 3, new QTableWidgetItem(QString::number(frames.size())));
+        for(auto j = 1; j < 4; ++j)
+            ui->tableWidget->item(i, j)->setTextAlignment(Qt::AlignHCenter | Qt::AlignVCenter);
+    }
+}
+
+// 由样本帧反推CRC参数（见CrcReveng）：在全局线程池中搜索，界面不阻塞；
+// 搜索过程中识别算法按钮用于取消，结束时由onCrcSearchFinished填写表格
+void NumberConvertForm::Detect_Crc_Params(const QVector<QByteArray> &frames)
+{
+    int width = 0;
+    Current_CRC_Sheet(&width);
+    crcSearchCancel.storeRelaxed(0);
+    crcSearch->setFuture(QtConcurrent::run([this, frames, width]() {
+        CrcSearchOptions options;
+        options.width = width;
+        options.cancel = &crcSearchCancel;
+        QString errorString;
+        const QVector<CrcSearchResult> results = CrcReveng::search(frames, options, &errorString);
+        return qMakePair(results, errorString);
+    }));
+    ui->pushButton_Detect_Checkcode->setText("取消识别");
+
+    ui->tableWidget->clear();
+    ui->tableWidget->setRowCount(1);
+    ui->tableWidget->setColumnCount(1);
+    ui->tableWidget->setHorizontalHeaderLabels(QStringList() << "校验算法");
+    ui->tableWidget->setItem(0, 0, new QTableWidgetItem("注册表中没有一致的算法，正在反推CRC参数……"));
+}
+
+void NumberConvertForm::onCrcSearchFinished()
+{
+    ui->pushButton_Detect_Checkcode->setText("识别算法");
+    const QVector<CrcSearchResult> results = crcSearch->result().first;
+    const QString errorString = crcSearch->result().second;
+    const bool canceled = crcSearchCancel.loadRelaxed() != 0;
+
+    ui->tableWidget->clear();
+    ui->tableWidget->setRowCount(0);
+    ui->tableWidget->setColumnCount(7);
+    ui->tableWidget->setHorizontalHeaderLabels(QStringList() << "多项式" << "初始值" << "输入反转" << "输出反转"
+                                               << "结果异或值" << "位数" << "字节序");
+    if(canceled || results.isEmpty())
+    {
+        ui->tableWidget->setRowCount(1);
+        const QString info = canceled ? "已取消反推CRC参数！"
+                                      : (errorString.isEmpty() ? "没有与全部帧一致的校验算法！" : errorString);
+        ui->tableWidget->setItem(0, 0, new QTableWidgetItem(info));
+        return;
+    }
+    const auto hex = [](quint64 value, int width) {
+        return "0x" + QString("%1").arg(value, (width + 3) / 4, 16, QLatin1Char('0')).toUpper();
+    };
+    ui->tableWidget->setRowCount(results.size());
+    for(auto i = 0; i < results.size(); ++i)
+    {
+        const CrcSearchResult &result = results.at(i);
+        const CrcParams &params = result.params;
+        // 样本帧等长时Init不能确定，显示的是取0时对应的XorOut
+        ui->tableWidget->setItem(i, 0, new QTableWidgetItem(hex(params.poly, params.width)));
+        ui->tableWidget->setItem(i, 1, new QTableWidgetItem(result.initAmbiguous ? "不确定" : hex(params.init, params.width)));
+        ui->tableWidget->setItem(i, 2, new QTableWidgetItem(params.refIn ? "true" : "false"));
+        ui->tableWidget->setItem(i, 3, new QTableWidgetItem(params.refOut ? "true" : "false"));
+        ui->tableWidget->setItem(i, 4, new QTableWidgetItem(hex(params.xorOut, params.width)));
+        ui->tableWidget->setItem(i, 5, new QTableWidgetItem(QString::number(params.width)));
+        ui->tableWidget->setItem(i, 6, new QTableWidgetItem(params.width == 8 ? "-" : (result.bigEndian ? "大端存储" : "小端存储")));
+        for(auto j = 0; j < 7; ++j)
+            ui->tableWidget->item(i, j)->setTextAlignment(Qt::AlignHCenter | Qt::AlignVCenter);
+    }
+}
+
 void NumberConvertForm::onRadioClickSelecByteOrder()
 {
     // 通过ID来获取选中的radioButton的方法
@@ -286,124 +559,29 @@ void NumberConvertForm::on_textEdit_CRCInput_textChanged()
     HexCharInput(ui->textEdit_CRCInput);
 }
 
-quint16 NumberConvertForm::CRC16_USB(char *data, quint16 dataLen)
+quint16 NumberConvertForm::CRC16_USB(char *data, qint64 dataLen)
 {
-    quint16 initValue = 0xFFFF;
-    quint16 poly = 0x8005;
-
-    InvertUint16(&poly, &poly);
-    while (dataLen--)
-    {
-        initValue ^= *(data++);
-        for(auto i = 0; i < 8; i++)
-        {
-            if(initValue & 0x01)
-            {
-                initValue = (initValue >> 1) ^ poly;
-            }
-            else
-            {
-                initValue = initValue >> 1;
-            }
-        }
-    }
-    return (initValue ^ 0xFFFF);
-
+    return Crc16Usb::compute(data, dataLen);
 }
 
-quint16 NumberConvertForm::CRC16_DNP(char *data, quint16 dataLen)
+quint16 NumberConvertForm::CRC16_DNP(char *data, qint64 dataLen)
 {
-    quint16 initValue = 0x0000;
-    quint16 poly = 0x3D65;
-
-    InvertUint16(&poly, &poly);
-    while (dataLen--)
-    {
-        initValue ^= *(data++);
-        for(int i = 0;i < 8;i++)
-        {
-            if(initValue & 0x01)
-            {
-                initValue = (initValue >> 1) ^ poly;
-            }
-            else
-            {
-                initValue = (initValue >> 1);
-            }
-        }
-    }
-
-    return (initValue ^ 0xFFFF);
+    return Crc16Dnp::compute(data, dataLen);
 }
 
-quint32 NumberConvertForm::CRC32_WINRAR(char *data, quint16 dataLen)
+quint32 NumberConvertForm::CRC32_WINRAR(char *data, qint64 dataLen)
 {
-    quint32 initValue = 0xFFFFFFFF;
-    quint32 poly = 0x04C11DB7;
-
-    InvertUint32(&poly, &poly);
-    while (dataLen--)
-    {
-        initValue ^= *(data++);
-        for(int i = 0;i < 8;i++)
-        {
-            if(initValue & 0x01)
-            {
-                initValue = (initValue >> 1) ^ poly;
-            }
-            else
-            {
-                initValue = initValue >> 1;
-            }
-        }
-    }
-
-    return (initValue ^ 0xFFFFFFFF) ;
+    return Crc32WinRar::compute(data, dataLen);
 }
 
-quint16 NumberConvertForm::CRC16_IBM(char *data, quint16 dataLen)
+quint16 NumberConvertForm::CRC16_IBM(char *data, qint64 dataLen)
 {
-    quint16 initValue = 0x0000;
-    quint16 poly = 0x8005;
-
-    InvertUint16(&poly, &poly);
-    while (dataLen--)
-    {
-        initValue ^= *(data++);
-        for(int i = 0;i < 8;i++)
-        {
-            if(initValue & 0x01)
-                initValue = (initValue >> 1) ^ poly;
-            else
-                initValue = initValue >> 1;
-        }
-    }
-    return initValue;
+    return Crc16Ibm::compute(data, dataLen);
 }
 
-quint16 NumberConvertForm::CRC16_MAXIM(char *data, quint16 dataLen)
+quint16 NumberConvertForm::CRC16_MAXIM(char *data, qint64 dataLen)
 {
-    quint16 initValue = 0x0000;
-    quint16 poly = 0x8005;
-
-    InvertUint16(&poly, &poly);
-    while (dataLen--)
-    {
-        initValue ^= *(data++);
-        for(auto i = 0; i < 8; i++)
-        {
-            if(initValue & 0x01)
-            {
-                initValue = (initValue >> 1) ^ poly;
-            }
-            else
-            {
-                initValue = initValue >> 1;
-            }
-        }
-    }
-
-    return (initValue ^ 0xFFFF);
+    return Crc16Maxim::compute(data, dataLen);
 }
 
 /****************************Info**********************************************
@@ -416,87 +594,47 @@ quint16 NumberConvertForm::CRC16_MAXIM(char *data, quint16 dataLen)
 * Xorout:  0x0000000
 * Note:
 *****************************************************************************/
-quint32 NumberConvertForm::CRC32_MPEG(char *data, quint16 dataLen)
+quint32 NumberConvertForm::CRC32_MPEG(char *data, qint64 dataLen)
 {
-    quint32 initValue = 0xFFFFFFFF;
-    quint32 poly = 0x04C11DB7;
-    quint8 uCh = 0;
-
-    while (dataLen--)
-    {
-        uCh = *(data++);
-        initValue ^= (uCh << 24);
-        for(auto i = 0; i < 8; i++)
-        {
-            if(initValue & 0x80000000)
-            {
-                initValue = (initValue << 1) ^ poly;
-            }
-            else
-            {
-                initValue = initValue << 1;
-            }
-        }
-    }
-
-    return initValue;
+    return Crc32Mpeg::compute(data, dataLen);
 }
 
 // MD5加密算法 20221107
 QByteArray NumberConvertForm::MD5(const QByteArray &data)
 {
-    QByteArray hashData = QCryptographicHash::hash(data, QCryptographicHash::Md5);
+    QByteArray hashData = HashContext::compute(HashContext::Md5, data.constData(), data.size());
     qInfo().noquote() << tcInstance.ByteArrayToHexString(hashData);
     return hashData;
 }
 
-quint8 NumberConvertForm::CRC8(char *data, quint16 dataLen)
+QByteArray NumberConvertForm::SHA256(const QByteArray &data)
 {
-    quint8 initValue = 0x00;
-    quint8 poly = 0x07;
+    return HashContext::compute(HashContext::Sha256, data.constData(), data.size());
+}
 
-    while (dataLen--)
-    {
-        initValue ^= *(data++);
-        for(auto i = 0; i < 8; i++)
-        {
-            if(initValue & 0x80)
-            {
-                initValue = (initValue << 1) ^ poly;
-            }
-            else
-            {
-                initValue = initValue << 1;
-            }
-        }
-    }
+QByteArray NumberConvertForm::XXH3_64(const QByteArray &data)
+{
+    return HashContext::compute(HashContext::Xxh3_64, data.constData(), data.size());
+}
 
-    return initValue;
+QByteArray NumberConvertForm::XXH3_128(const QByteArray &data)
+{
+    return HashContext::compute(HashContext::Xxh3_128, data.constData(), data.size());
 }
 
-quint8 NumberConvertForm::CRC8_MAXIM(char *data, quint16 dataLen)
+QByteArray NumberConvertForm::BLAKE3(const QByteArray &data)
 {
-    quint8 initValue = 0x00;
-    quint8 poly = 0x31;
+    return HashContext::compute(HashContext::Blake3_256, data.constData(), data.size());
+}
 
-    InvertUint8(&poly, &poly);
-    while (dataLen--)
-    {
-        initValue ^= *(data++);
-        for(auto i = 0; i < 8; i++)
-        {
-            if(initValue & 0x01)
-            {
-                initValue = (initValue >> 1) ^ poly;
-            }
-            else
-            {
-                initValue = initValue >> 1;
-            }
-        }
-    }
+quint8 NumberConvertForm::CRC8(char *data, qint64 dataLen)
+{
+    return Crc8::compute(data, dataLen);
+}
 
-    return initValue;
+quint8 NumberConvertForm::CRC8_MAXIM(char *data, qint64 dataLen)
+{
+    return Crc8Maxim::compute(data, dataLen);
 }
 
 /****************************Info**********************************************
@@ -509,28 +647,9 @@ quint8 NumberConvertForm::CRC8_MAXIM(char *data, quint16 dataLen)
 * Xorout:  0x55
 * Alias:   CRC-8/ATM
 *****************************************************************************/
-quint8 NumberConvertForm::CRC8_ITU(char *data, quint16 dataLen)
+quint8 NumberConvertForm::CRC8_ITU(char *data, qint64 dataLen)
 {
-    quint8 initValue = 0x00;
-    quint8 poly = 0x07;
-
-    while (dataLen--)
-    {
-        initValue ^= *(data++);
-        for(auto i = 0;i < 8;i++)
-        {
-            if(initValue & 0x80)
-            {
-                initValue = (initValue << 1) ^ poly;
-            }
-            else
-            {
-                initValue = initValue << 1;
-            }
-        }
-    }
-
-    return (initValue ^ 0x55);
+    return Crc8Itu::compute(data, dataLen);
 }
 
 /****************************Info**********************************************
@@ -543,29 +662,9 @@ quint8 NumberConvertForm::CRC8_ITU(char *data, quint16 dataLen)
 * Xorout:  0x00
 * Note:
 *****************************************************************************/
-quint8 NumberConvertForm::CRC8_ROHC(char *data, quint16 dataLen)
+quint8 NumberConvertForm::CRC8_ROHC(char *data, qint64 dataLen)
 {
-    quint8 initValue = 0xFF;
-    quint8 poly = 0x07;
-
-    InvertUint8(&poly, &poly);
-    while (dataLen--)
-    {
-        initValue ^= *(data++);
-        for(auto i = 0; i < 8; i++)
-        {
-            if(initValue & 0x01)
-            {
-                initValue = (initValue >> 1) ^ poly;
-            }
-            else
-            {
-                initValue = initValue >> 1;
-            }
-        }
-    }
-
-    return initValue;
+    return Crc8Rohc::compute(data, dataLen);
 }
 
 /***
@@ -573,18 +672,9 @@ quint8 NumberConvertForm::CRC8_ROHC(char *data, quint16 dataLen)
  * 思路：1、使用16位变量保存数据的累加和；
  *      2、将累加和的高8位和低8位相加；
  ***/
-quint8 NumberConvertForm::CHECKSUM_8(char *data, quint16 dataLen)
+quint8 NumberConvertForm::CHECKSUM_8(char *data, qint64 dataLen)
 {
-    quint16 sum = 0;
-
-    while (dataLen--)
-        sum += *(quint8*)(data++);
-
-    // 将16位校验和折算为8位（低8位+高8位）
-    while(sum >> 8)
-        sum = (sum & 0xFF) + (sum >> 8);
-
-    return (quint8)(sum);
+    return ChecksumCompute<Checksum8>(data, dataLen);
 }
 
 /***
@@ -593,117 +683,36 @@ quint8 NumberConvertForm::CHECKSUM_8(char *data, quint16 dataLen)
  *      2、将累加和的高8位和低8位相加；
  *      3、对累加和进行取反操作。
  ***/
-quint8 NumberConvertForm::CHECKSUM_8_REVERSE(char *data, quint16 dataLen)
+quint8 NumberConvertForm::CHECKSUM_8_REVERSE(char *data, qint64 dataLen)
 {
-    quint16 sum = 0;
-
-    while (dataLen--)
-        sum += *(quint8*)(data++);
-
-    // 将16位校验和折算为8位（低8位+高8位）
-    while(sum >> 8)
-        sum = (sum & 0xFF) + (sum >> 8);
-
-    return (quint8)(~sum);
+    return ChecksumCompute<Checksum8Reverse>(data, dataLen);
 }
 
-quint16 NumberConvertForm::CHECKSUM_16(char *data, quint16 dataLen)
+quint16 NumberConvertForm::CHECKSUM_16(char *data, qint64 dataLen)
 {
-    quint32 sum = 0;
-    quint16* addr = (quint16*)data;
-    quint16 count = dataLen;
-    while (count >= 2)
-    {
-        sum += *(quint16*)(addr++);
-        count -= 2;
-    }
-    if(count == 1)
-    {
-        addr++;
-        sum += *((quint8*)addr);
-    }
-
-    // 将16位校验和折算为8位（低8位+高8位）
-    while(sum >> 16)
-        sum = (sum & 0xFFFF) + (sum >> 16);
-
-    return (quint16)sum;
+    return ChecksumCompute<Checksum16>(data, dataLen);
 }
 
-quint16 NumberConvertForm::CHECKSUM_16_REVERSE(char *data, quint16 dataLen)
+quint16 NumberConvertForm::CHECKSUM_16_REVERSE(char *data, qint64 dataLen)
 {
-    quint32 sum = 0;
-    quint16* addr = (quint16*)data;
-    quint16 count = dataLen;
-    while (count >= 2)
-    {
-        sum += *(quint16*)(addr++);
-//        (quint16*)(addr++);
-        count -= 2;
-    }
-    if(count == 1)
-    {
-        addr++;
-        sum += *((quint8*)addr);
-    }
-
-    // 将16位校验和折算为8位（低8位+高8位）
-    while(sum >> 16)
-        sum = (sum & 0xFFFF) + (sum >> 16);
-
-    return (quint16)(~sum);
+    return ChecksumCompute<Checksum16Reverse>(data, dataLen);
 }
 
 // 和校验  20221114
-quint8 NumberConvertForm::SUMCHECK_8(char *data, quint16 dataLen)
+quint8 NumberConvertForm::SUMCHECK_8(char *data, qint64 dataLen)
 {
-    quint8 sum = 0;
-
-    while (dataLen--)
-        sum += *(quint8*)(data++);
-
-    return sum;
+    return ChecksumCompute<SumCheck8>(data, dataLen);
 }
 
 // 异或校验 20221114
-quint8 NumberConvertForm::XOR_8(char *data, quint16 dataLen)
+quint8 NumberConvertForm::XOR_8(char *data, qint64 dataLen)
 {
-    if(dataLen == 1)
-        return *(quint8*)data;
-
-    quint8 xorResult = *(quint8*)(data++);
-
-    while (--dataLen)
-        xorResult ^= *(quint8*)(data++);
-
-    return xorResult;
+    return ChecksumCompute<Xor8>(data, dataLen);
 }
 
-//这里为了效率，我们不需要将所有Refin和refout为true的输入输出数据移位转换
-//只需要将poly二项式转换后，运算时将左移变为右移
-quint16 NumberConvertForm::CRC16_CCITT_TRUE(char *data, quint16 dataLen)
+quint16 NumberConvertForm::CRC16_CCITT_TRUE(char *data, qint64 dataLen)
 {
-    quint16 initValue = 0x0000;     // 初始值
-    quint16 poly = 0x1021;          // 多项式
-
-    InvertUint16(&poly, &poly);
-    while (dataLen--)
-    {
-        initValue ^= *(data++);
-        for(int i = 0;i < 8;i++)
-        {
-            if(initValue & 0x01)
-            {
-                initValue = (initValue >> 1) ^ poly;
-            }
-            else
-            {
-                initValue = initValue >> 1;
-            }
-        }
-    }
-
-    return initValue;
+    return Crc16CcittTrue::compute(data, dataLen);
 }
 
 /****************************Info**********************************************
@@ -716,28 +725,9 @@ quint16 NumberConvertForm::CRC16_CCITT_TRUE(char *data, quint16 dataLen)
 * Xorout:  0x0000
 * Note:
 *****************************************************************************/
-quint16 NumberConvertForm::CRC16_CCITT_FALSE(char *data, quint16 dataLen)
+quint16 NumberConvertForm::CRC16_CCITT_FALSE(char *data, qint64 dataLen)
 {
-    quint16 initValue = 0xFFFF;
-    quint16 poly = 0x1021;
-
-    while (dataLen--)
-    {
-        initValue ^= *(data++) << 8;
-        for(int i = 0;i < 8; i++)
-        {
-            if(initValue & 0x8000)
-            {
-                initValue = (initValue << 1) ^ poly;
-            }
-            else
-            {
-                initValue = initValue << 1;
-            }
-        }
-    }
-
-    return initValue;
+    return Crc16CcittFalse::compute(data, dataLen);
 }
 
 /****************************Info**********************************************
@@ -750,128 +740,19 @@ quint16 NumberConvertForm::CRC16_CCITT_FALSE(char *data, quint16 dataLen)
 * Xorout:  0x0000
 * Alias:   CRC-16/ZMODEM,CRC-16/ACORN
 *****************************************************************************/
-quint16 NumberConvertForm::CRC16_XMODEM(char *data, quint16 dataLen)
-{
-    quint16 initValue = 0x0000;
-    quint16 poly = 0x1021;
-
-    while (dataLen--)
-    {
-        initValue ^= (*(data++) << 8);
-        for(int i = 0; i < 8; i++)
-        {
-            if(initValue & 0x8000)
-            {
-                initValue = (initValue << 1) ^ poly;
-            }
-            else
-            {
-                initValue = initValue << 1;
-            }
-        }
-    }
-
-    return initValue;
-}
-
-quint16 NumberConvertForm::CRC16_X25(char *data, quint16 dataLen)
-{
-    quint16 initValue = 0xFFFF;
-    quint16 poly = 0x1021;
-
-    InvertUint16(&poly, &poly);
-    while (dataLen--)
-    {
-        initValue ^= *(data++);
-        for(auto i = 0; i < 8; i++)
-        {
-            if(initValue & 0x01)
-            {
-                initValue = (initValue >> 1) ^ poly;
-            }
-            else
-            {
-                initValue = initValue >> 1;
-            }
-        }
-    }
-
-    return (initValue ^ 0xFFFF);
-}
-
-quint16 NumberConvertForm::CRC16_MODBUS(char *data, quint16 dataLen)
-{
-    quint16 initValue = 0xFFFF;
-    quint16 poly = 0x8005;
-
-    InvertUint16(&poly, &poly);
-    while (dataLen--)
-    {
-        initValue ^= *(data++);
-        for(int i = 0;i < 8;i++)
-        {
-            if(initValue & 0x01)
-            {
-                initValue = (initValue >> 1) ^ poly;
-            }
-            else
-            {
-                initValue = initValue >> 1;
-            }
-        }
-    }
-
-    return initValue;
-}
-
-// 把quint16数（十六bit）颠倒过来，算法同InvertUint8
-void NumberConvertForm::InvertUint16(quint16 *destUShort, quint16 *srcUShort)
+quint16 NumberConvertForm::CRC16_XMODEM(char *data, qint64 dataLen)
 {
-    quint16 uShort = 0;
-
-    for(auto i = 0; i < 16; i++)
-    {
-        if(*srcUShort & (1 << i))
-        {
-            uShort |= 1 << (15 - i);
-        }
-    }
-
-    *destUShort = uShort;
+    return Crc16Xmodem::compute(data, dataLen);
 }
 
-/****************************Info**********************************************
-* Name: InvertUint8
-* Note: 把字节颠倒过来，如0x12变成0x48
-*       0x12: 0001 0010
-*       0x48: 0100 1000
-*****************************************************************************/
-void NumberConvertForm::InvertUint8(quint8 *destUch, quint8 *srcUch)
+quint16 NumberConvertForm::CRC16_X25(char *data, qint64 dataLen)
 {
-    quint8 uCh = 0;  // 临时变量，暂存翻转后的值
-
-    for(auto i = 0; i < 8; i++)
-    {
-        if(*srcUch & (1 << i))
-        {   // 判断srcUch的第i位，若为1，则翻转后的第7-i位置1
-            uCh |= 1 << (7-i);   // 将ch的第7-i位置1
-        }
-    }
-
-    *destUch = uCh;
+    return Crc16X25::compute(data, dataLen);
 }
 
-void NumberConvertForm::InvertUint32(quint32 *destUInt, quint32 *srcUInt)
+quint16 NumberConvertForm::CRC16_MODBUS(char *data, qint64 dataLen)
 {
-    quint32 uInt = 0;
-
-    for(auto i=0; i< 32; i++)
-    {
-        if(*srcUInt & (1 << i))
-            uInt |= 1 << (31 - i);
-    }
-
-    *destUInt = uInt;
+    return Crc16Modbus::compute(data, dataLen);
 }
 
 // 显示CRC8配置列表 20221106
@@ -1070,7 +951,7 @@ void NumberConvertForm::HexCharInput(QTextEdit *textEdit)
 }
 
 // 初始化CRC校验配置参数 20221115
-// 由于读取Excel文件速度慢，所以打开窗体前读取CRC配置文件一次，保存到Vector中
+// 优先读取CRC.xlsx，没有时读取等价的CRC.csv；解析结果缓存在源文件旁，源文件未修改时直接读缓存
 void NumberConvertForm::Init_CRC_Config_Params()
 {
     //  每次更新CRC配置参数前，先清空之前保存的数据 20221115
@@ -1079,114 +960,45 @@ void NumberConvertForm::Init_CRC_Config_Params()
     crc32Data.clear();
 
     QString fileName = tr("%1/config/data/CRC.xlsx").arg(QDir::currentPath());
-    QFile file(fileName);
-    if(!file.exists())
+    if(!QFile::exists(fileName))
+        fileName = tr("%1/config/data/CRC.csv").arg(QDir::currentPath());
+    if(!QFile::exists(fileName))
     {
         qInfo().noquote() << fileName << "文件不存在！";
         return;
     }
 
-    // Excel应用程序
-    QAxObject *excel = new QAxObject("Excel.Application");
-    // true：操作文件时Excel可见，false：操作文件时Excel不可见
-    excel->dynamicCall("SetVisible(bool)", false);
-    // 所有Excel文件
-    QAxObject *workBooks = excel->querySubObject("WorkBooks");
-    // 按照路径获取文件
-    QAxObject *workBook = workBooks->querySubObject("Open(QString&）", fileName);
-    // 获取文件的所有Sheet页
-    QAxObject *sheets = workBook->querySubObject("WorkSheets");
-    // 获取文件Sheet页
-    QAxObject *usedRange = nullptr;
-    QAxObject *sheet = nullptr;
-    sheet = sheets->querySubObject("Item(QString)", "CRC16");
-    if(nullptr == sheet)
+    CrcParamTables tables;
+    QString errorString;
+    if(!CrcParamLoader::load(fileName, &tables, &errorString))
     {
-        qInfo().noquote() << "CRC16 Sheet页不存在!";
-    }
-    else
-    {
-        // 有数据的矩形区域
-        usedRange = sheet->querySubObject("UsedRange");
-        // 获取Sheet中数据，并保存到QVector<QVector<QString>>中
-        QVariant var = usedRange->dynamicCall("Value");
-        // 保存CRC16配置参数
-        foreach(QVariant varRow, var.toList())
-        {
-            QVector<QString> vecDataRow;
-            foreach(QVariant var, varRow.toList())
-            {
-                vecDataRow.push_back(var.toString());
-            }
-            crc16Data.push_back(vecDataRow);
-        }
-    }
-
-    // 初始化CRC8算法配置QVector
-    sheet = sheets->querySubObject("Item(QString)", "CRC8");
-    if(nullptr == sheet)
-    {
-        qInfo().noquote() << "CRC8 Sheet页不存在!";
-    }
-    else
-    {
-        // 有数据的矩形区域
-        usedRange = sheet->querySubObject("UsedRange");
-        // 获取Sheet中数据，并保存到QVector<QVector<QString>>中
-        QVariant var = usedRange->dynamicCall("Value");
-        // 保存CRC8配置参数
-        foreach(QVariant varRow, var.toList())
-        {
-            QVector<QString> vecDataRow;
-            foreach(QVariant var, varRow.toList())
-            {
-                vecDataRow.push_back(var.toString());
-            }
-            crc8Data.push_back(vecDataRow);
-        }
+        qWarning().noquote() << "读取CRC配置文件失败：" << errorString;
+        return;
     }
+    crc8Data = tables.crc8;
+    crc16Data = tables.crc16;
+    crc32Data = tables.crc32;
+}
 
-    // 初始化CRC32算法配置QVector
-    sheet = sheets->querySubObject("Item(QString)", "CRC32");
-    if(nullptr == sheet)
-    {
-        qInfo().noquote() << "CRC32 Sheet页不存在!";
-    }
-    else
-    {
-        // 有数据的矩形区域
-        usedRange = sheet->querySubObject("UsedRange");
-        // 获取Sheet中数据，并保存到QVector<QVector<QString>>中
-        QVariant var = usedRange->dynamicCall("Value");
-        // 保存CRC32配置参数
-        foreach(QVariant varRow, var.toList())
-        {
-            QVector<QString> vecDataRow;
-            foreach(QVariant var, varRow.toList())
-            {
-                vecDataRow.push_back(var.toString());
-            }
-            crc32Data.push_back(vecDataRow);
-        }
-    }
+HashContext::Algorithm NumberConvertForm::Current_Hash_Algorithm() const
+{
+    return HashContext::Algorithm(ui->comboBox_HashAlgorithm->currentData().toInt());
+}
 
-    // 关闭文件
-    workBook->dynamicCall("Close()");
-    excel->dynamicCall("Quit()");
-    if(excel)
-    {
-        delete excel;
-        excel = nullptr;
-    }
+void NumberConvertForm::Show_Hash_Speed(qint64 bytes, qint64 nsecs)
+{
+    // 字节/纳秒 × 1000 = MB/s
+    const double speed = nsecs > 0 ? bytes * 1000.0 / nsecs : 0;
+    ui->label_HashSpeed->setText(QString("%1 MB/s").arg(speed, 0, 'f', 1));
 }
 
-// 产生MD5校验码 20221107
+// 产生摘要 20221107
 void NumberConvertForm::on_pushButton_Generate_MD5_clicked()
 {
     QString inputStr = ui->textEdit_MD5Input->toPlainText();
     if(inputStr.isEmpty())
     {
-        QMessageBox::information(this, "信息提示", "请输入MD5校验数据！");
+        QMessageBox::information(this, "信息提示", "请输入摘要校验数据！");
         return;
     }
 
@@ -1195,7 +1007,16 @@ void NumberConvertForm::on_pushButton_Generate_MD5_clicked()
         ba = tcInstance.HexStringToByteArray(inputStr);
     else
         ba = inputStr.toUtf8();
-    ba = QCryptographicHash::hash(ba, QCryptographicHash::Md5);
+    // 只计算一次；耗时太短时计时误差大，不显示速度（吞吐量见Benchmark）
+    QElapsedTimer timer;
+    timer.start();
+    const QByteArray digest = HashContext::compute(Current_Hash_Algorithm(), ba.constData(), ba.size());
+    const qint64 nsecs = timer.nsecsElapsed();
+    if(nsecs >= MinHashSpeedNsecs)
+        Show_Hash_Speed(ba.size(), nsecs);
+    else
+        ui->label_HashSpeed->clear();
+    ba = digest;
     // 缺省为大端存储，如果勾选小端存储，则逆序排列校验码
     if(!ui->checkBox_ByteOrder->isChecked())
         std::reverse(ba.begin(), ba.end());
@@ -1204,103 +1025,106 @@ void NumberConvertForm::on_pushButton_Generate_MD5_clicked()
     ui->textEdit_MD5Input->setText(tcInstance.StringNoNullToNull(inputStr + md5Result));
 }
 
-// 选择MD5输入文件，计算文件的MD5校验码 20221116
+// 选择摘要输入文件，计算文件的摘要 20221116
 void NumberConvertForm::on_pushButton_Select_File_clicked()
 {
+    // 计算过程中按钮用于取消
+    if(fileHash->isRunning())
+    {
+        fileHash->cancel();
+        return;
+    }
     QString fileName = QFileDialog::getOpenFileName(this, "打开文件数据源", "", "所有文件(*.*)");
     ui->lineEdit_File_Data_Source->setText(fileName);
     if(fileName.isEmpty())
         return;
 
-    QFile file(fileName);
-    QFileInfo fileInfo(fileName);
-    if(!file.open(QIODevice::ReadOnly/* | QIODevice::Text*/))
-    {   // 文件读取失败
-        QString errInfo = tr("读取文件 %1 失败！原因：%2.").arg(fileName).arg(file.errorString());
-        qWarning().noquote() << errInfo;
-        QMessageBox::warning(this, "警告", errInfo);
-        return;
-    }
-
-    qint64 fileSize = fileInfo.size();
-    QByteArray ba;
+    FileHashJob::Filter filter;
     QMimeDatabase mimeDatabase;
     QMimeType mimeType = mimeDatabase.mimeTypeForFile(fileName, QMimeDatabase::MatchDefault);
     if(mimeType.name().startsWith("text/"))
     { // 处理文本文件
-        // Note：fileInfo.size()返回的是文本文件的字符个数，包括空格符 20221109
         qInfo().noquote() << "文本文件类型：" << mimeType.name();
-        if(fileSize < loadSize)
-        {
-            QTextStream ts(&file);
-            ts.setCodec("UTF-8");
-            QString hexStr = ts.readAll();
-            if(md5DataType)
-                // Hex输入，即对文件内容的十六进制字节串进行MD5校验
-                ba = tcInstance.HexStringToByteArray(hexStr);
-            else
-                // ASCII输入，即对文件进行MD5校验
-                ba = hexStr.toUtf8();
-            ba = QCryptographicHash::hash(ba, QCryptographicHash::Md5);
-            // 缺省为大端存储，如果勾选小端存储，则逆序排列校验码
-            if(!ui->checkBox_ByteOrder->isChecked())
-                std::reverse(ba.begin(), ba.end());
-        }
-        else
+        if(md5DataType)
         {
-            QCryptographicHash hash(QCryptographicHash::Md5);
-            qint64 bytesToWrite = fileSize;
-            QByteArray buf;
-            while(bytesToWrite > 0)
-            {
-                buf = file.read(qMin(bytesToWrite, loadSize));
-                bytesToWrite -= buf.length();
-                if(md5DataType)
-                    // 将读取的ASCII字符转换为十六进制字节串，再计算MD5
-                    buf = tcInstance.HexStringToByteArray(QString(buf));
-                hash.addData(buf);
-                buf.resize(0);
-            }
-            QByteArray ba = hash.result();
-            // 缺省为大端存储，如果勾选小端存储，则逆序排列校验码
-            if(!ui->checkBox_ByteOrder->isChecked())
-                std::reverse(ba.begin(), ba.end());
-        }
-        ui->textEdit_MD5Output->setText(tcInstance.StringNoNullToNull(tcInstance.ByteArrayToHexString(ba)));
-    }
-    else if(mimeType.name().startsWith("application/"))
-    { // 处理二进制文件
-        qInfo().noquote() << "二进制文件类型：" << mimeType.name();
-        QCryptographicHash hash(QCryptographicHash::Md5);
-        char* buf = new char[loadSize];
-        qint64 ret = 0;
-        QDataStream in(&file);
-        if(fileSize < loadSize)
-        {
-            ret = in.readRawData(buf, fileSize);
-            hash.addData(buf, ret);
-        }
-        else
-        {
-            qint64 bytesToWrite = fileSize;
-            while(bytesToWrite > 0)
-            {
-                ret = in.readRawData(buf, qMin(bytesToWrite, loadSize));
-                hash.addData(buf, ret);
-                bytesToWrite -= ret;
-            }
+            // Hex输入，即对文件内容的十六进制字节串计算摘要；ASCII输入直接对文件计算摘要。
+            // 解码器保存跨越分段边界的半个字节，每次选择文件各用一个
+            QSharedPointer<HexStreamDecoder> decoder(new HexStreamDecoder);
+            filter = [decoder](const char *data, qint64 dataLen, QByteArray *out) {
+                if(dataLen > 0)
+                    decoder->decode(data, dataLen, out);
+                else
+                    decoder->finish(out);
+            };
         }
-        delete []buf;
-        ba = hash.result();
-        // 缺省为大端存储，如果勾选小端存储，则逆序排列校验码
-        if(!ui->checkBox_ByteOrder->isChecked())
-            std::reverse(ba.begin(), ba.end());
-        ui->textEdit_MD5Output->setText(tcInstance.StringNoNullToNull(tcInstance.ByteArrayToHexString(ba)));
     }
     else
+    { // 二进制及其它类型的文件直接对文件内容计算摘要
+        qInfo().noquote() << "文件类型：" << mimeType.name();
+    }
+
+    ui->textEdit_MD5Output->clear();
+    ui->label_HashSpeed->clear();
+    ui->progressBar_FileHash->setValue(0);
+    if(fileHash->start(fileName, Current_Hash_Algorithm(), filter))
+    {
+        fileHashTimer.start();
+        ui->pushButton_Select_File->setText("取消计算");
+    }
+}
+
+void NumberConvertForm::onFileHashFinished(const QByteArray &digest)
+{
+    onFileHashStopped();
+    // 按读取的文件长度计算速度，包含读取文件的时间
+    Show_Hash_Speed(QFileInfo(ui->lineEdit_File_Data_Source->text()).size(), fileHashTimer.nsecsElapsed());
+    QByteArray ba = digest;
+    // 缺省为大端存储，如果勾选小端存储，则逆序排列校验码
+    if(!ui->checkBox_ByteOrder->isChecked())
+        std::reverse(ba.begin(), ba.end());
+    ui->textEdit_MD5Output->setText(tcInstance.StringNoNullToNull(tcInstance.ByteArrayToHexString(ba)));
+}
+
+// 文件摘要计算结束（完成、失败或取消），恢复选择文件按钮
+void NumberConvertForm::onFileHashStopped()
+{
+    ui->pushButton_Select_File->setText("选择生成摘要的文件...");
+}
+
+// 用当前选择的校验算法（注册表中的算法或配置表中的自定义算法）计算文件的校验码，
+// 文件内容按二进制参与计算
+void NumberConvertForm::on_pushButton_Select_CheckFile_clicked()
+{
+    // 计算过程中按钮用于取消
+    if(fileCheck->isRunning())
     {
-        qInfo().noquote() << "其它文件类型：" << mimeType.name();
+        fileCheck->cancel();
+        return;
+    }
+    if(checkAlgorithm == nullptr && customCrc.isNull())
+    {
+        ui->lineEdit_Checkcode->setText("调用校验函数失败！");
+        return;
     }
+    const QString fileName = QFileDialog::getOpenFileName(this, "打开文件数据源", "", "所有文件(*.*)");
+    if(fileName.isEmpty())
+        return;
+    ui->lineEdit_Checkcode->clear();
+    ui->lineEdit_Checkcode_Dec->clear();
+    const bool started = checkAlgorithm != nullptr ? fileCheck->start(fileName, checkAlgorithm)
+                                                   : fileCheck->start(fileName, customCrc);
+    if(started)
+        ui->pushButton_Select_CheckFile->setText("取消计算");
+}
+
+void NumberConvertForm::onFileCheckFinished(const QByteArray &code)
+{
+    ui->pushButton_Select_CheckFile->setText("文件校验");
+    quint64 value = 0;
+    for(const char c : code)
+        value = (value << 8) | uchar(c);
+    ui->lineEdit_Checkcode->setText("0x" + tcInstance.ByteArrayToHexString(code).remove(' '));
+    ui->lineEdit_Checkcode_Dec->setText(QString::number(value));
 }
 
 void NumberConvertForm::onRadioClickSelecDataType()
@@ -1354,58 +1178,39 @@ void NumberConvertForm::on_checkBox_FormatData_2_stateChanged(int arg1)
 // 产生校验和 20221112
 void NumberConvertForm::on_pushButton_Generate_Checksum_clicked()
 {
-    QString hexStr = ui->textEdit_ChecksumInput->toPlainText();
-    QByteArray ba = tcInstance.HexStringToByteArray(hexStr);
-    char* pCheckSum = ba.data();    // QByteArray转char*
-    quint8 ret8 = 0;
-    quint16 ret16 = 0;
-    QString methodName = ui->comboBox_CheckSum->currentText().toUpper();
-    bool callResult = false;
+    if(checksumAlgorithm == nullptr)
+    {
+        ui->lineEdit_Checksum->setText("调用校验函数失败！");
+        return;
+    }
+    // 直接按编辑框分段表中的各段字节计算，不经过十六进制文本
+    const QVector<ChecksumSegment> segments = ui->textEdit_ChecksumInput->bytes().segments();
+    const quint64 ret = checksumAlgorithm->computeSegments(segments.constData(), segments.size());
+    ui->lineEdit_Checksum_Dec->setText(QString::number(ret));
     QString checksum = "";
-    switch (ui->comboBox_CheckSum->currentIndex())
+    switch (checksumAlgorithm->width)
     {
-    case 0: // 处理Checksum_8
-    case 1: // 处理CHECKSUM_8_REVERSE
-        callResult = QMetaObject::invokeMethod(&NumberConvertForm::getDCFInstance(), methodName.toLatin1().data(),
-                                               Qt :: AutoConnection, Q_RETURN_ARG(quint8, ret8),
-                                               Q_ARG(char*, pCheckSum), Q_ARG(quint16, ba.size()));
-        ui->lineEdit_Checksum_Dec->setText(QString::number(ret8));
-        checksum = QString("%1").arg(ret8, 2, 16, QLatin1Char('0')).toUpper();
-        ui->textEdit_ChecksumInput->setText(tcInstance.StringNoNullToNull(hexStr+checksum));
-        ui->lineEdit_Checksum->setText("0x" + checksum);
-        break;
-    case 2: // 处理Checksum_16
-    case 3: // 处理CHECKSUM_16_REVERSE
-        callResult = QMetaObject::invokeMethod(&NumberConvertForm::getDCFInstance(), methodName.toLatin1().data(),
-                                               Qt :: AutoConnection, Q_RETURN_ARG(quint16, ret16),
-                                               Q_ARG(char*, pCheckSum), Q_ARG(quint16, ba.size()));
-        ui->lineEdit_Checksum_Dec->setText(QString::number(ret16));
-        checksum = tcInstance.DecToHexString(ret16, 2, !checksumByteOrder);
-        ui->textEdit_ChecksumInput->setText(tcInstance.StringNoNullToNull(hexStr+checksum));
-        checksum = QString("%1").arg(ret16, 4, 16, QLatin1Char('0')).toUpper();
+    case 8: // 处理Checksum_8、CHECKSUM_8_REVERSE、和校验、异或校验
+        checksum = QString("%1").arg(ret, 2, 16, QLatin1Char('0')).toUpper();
+        ui->textEdit_ChecksumInput->appendData(tcInstance.HexStringToByteArray(checksum));
         ui->lineEdit_Checksum->setText("0x" + checksum);
         break;
-    case 4: // 处理和校验
-    case 5: // 处理异或校验
-        callResult = QMetaObject::invokeMethod(&NumberConvertForm::getDCFInstance(), methodName.toLatin1().data(),
-                                               Qt :: AutoConnection, Q_RETURN_ARG(quint8, ret8),
-                                               Q_ARG(char*, pCheckSum), Q_ARG(quint16, ba.size()));
-        ui->lineEdit_Checksum_Dec->setText(QString::number(ret8));
-        checksum = tcInstance.DecToHexString(ret8, 1, checksumByteOrder);
-        ui->textEdit_ChecksumInput->setText(tcInstance.StringNoNullToNull(hexStr+checksum));
-        checksum = QString("%1").arg(ret8, 2, 16, QLatin1Char('0')).toUpper();
+    case 16: // 处理Checksum_16、CHECKSUM_16_REVERSE
+        checksum = tcInstance.DecToHexString(quint32(ret), 2, !checksumByteOrder);
+        ui->textEdit_ChecksumInput->appendData(tcInstance.HexStringToByteArray(checksum));
+        checksum = QString("%1").arg(ret, 4, 16, QLatin1Char('0')).toUpper();
         ui->lineEdit_Checksum->setText("0x" + checksum);
         break;
     default:
         break;
     }
-    if(!callResult)
-    {
-        ui->lineEdit_Checkcode->setText("调用校验函数失败！");
-        return;
-    }
 }
 
+// 切换校验和算法时从注册表取得算法
+void NumberConvertForm::on_comboBox_CheckSum_currentIndexChanged(int index)
+{
+    checksumAlgorithm = CheckAlgorithmRegistry::getCARInstance().find(ui->comboBox_CheckSum->itemText(index));
+}
 
 void NumberConvertForm::on_checkBox_Checksum_ByteOrder_stateChanged(int arg1)
 {
@@ -1421,19 +1226,10 @@ void NumberConvertForm::on_checkBox_Checksum_ByteOrder_stateChanged(int arg1)
     }
 }
 
+// 格式化只改变字节间是否显示空格，不需要重新解析和设置内容
 void NumberConvertForm::on_checkBox_Checksum_FormatData_stateChanged(int arg1)
 {
-    QString sendStr = ui->textEdit_ChecksumInput->toPlainText();
-    if(arg1 == 2)
-    {
-        QByteArray ba = tcInstance.HexStringToByteArray(sendStr);
-        sendStr = ba.toHex(' ').data();
-    }
-    else if(arg1 == 0)
-    {
-        sendStr = sendStr.remove(" ");
-    }
-    ui->textEdit_ChecksumInput->setText(sendStr.toUpper());
+    ui->textEdit_ChecksumInput->setSpaced(arg1 == 2);
 }
 
 // 清空Checksum输入和输出文本框 20221114
@@ -1444,11 +1240,6 @@ void NumberConvertForm::on_pushButton_Clear_Checksum_clicked()
     ui->lineEdit_Checksum_Dec->clear();
 }
 
-void NumberConvertForm::on_textEdit_ChecksumInput_textChanged()
-{
-    HexCharInput(ui->textEdit_ChecksumInput);
-}
-
 // 清空CRC输入和输出文本框
 void NumberConvertForm::on_pushButton_Clear_Checkcode_clicked()
 {
@@ -1460,7 +1251,9 @@ void NumberConvertForm::on_pushButton_Clear_Checkcode_clicked()
 // 根据当前选择的CRC算法，切换到对应的CRC配置参数行显示 20221115
 void NumberConvertForm::on_comboBox_CheckAlgorithm_activated(int index)
 {
-    ui->tableWidget->selectRow(index);
+    // 自定义算法的条目数据即配置表中的行号
+    const QVariant row = ui->comboBox_CheckAlgorithm->itemData(index);
+    ui->tableWidget->selectRow(row.isValid() ? row.toInt() : index);
 }
 
 void NumberConvertForm::on_pushButton_Clear_MD5_clicked()
@@ -3,7 +3,13 @@
 
 #include <QWidget>
 #include <QButtonGroup>
+#include <QElapsedTimer>
+#include <QFutureWatcher>
 #include "typeconvert.h"
+#include "checkalgorithm.h"
+#include "crcmodel.h"
+#include "filehashjob.h"
+#include "crcreveng.h"
 #include <QTextEdit>
 
 namespace Ui {
@@ -15,13 +21,6 @@ class NumberConvertForm : public QWidget
     Q_OBJECT
 
 public:
-    /***** Singleton pattern class definition *******/
-    static NumberConvertForm& getDCFInstance()
-    {
-        static NumberConvertForm instance;
-        return instance;
-    }
-
     explicit NumberConvertForm(QWidget *parent = nullptr);
     ~NumberConvertForm();
 
@@ -52,7 +51,11 @@ public:
     };
     enum Hash_Mode
     {
-        md5 = 0
+        md5 = 0,
+        sha256,
+        xxh3_64,
+        xxh3_128,
+        blake3,
     };
 
     enum CHECKSUM_Mode
@@ -72,34 +75,39 @@ public:
     Q_ENUM(CHECKSUM_Mode)
 
     // Qt反射：就是运行时把字符串映射为类，函数声明时必须使用Q_INVOKABLE
-    Q_INVOKABLE quint8 CRC8(char *data, quint16 dataLen);
-    Q_INVOKABLE quint8 CRC8_MAXIM(char *data, quint16 dataLen);
-    Q_INVOKABLE quint8 CRC8_ITU(char *data, quint16 dataLen);
-    Q_INVOKABLE quint8 CRC8_ROHC(char *data, quint16 dataLen);
-
-    Q_INVOKABLE quint16 CRC16_CCITT_TRUE(char *data, quint16 dataLen);
-    Q_INVOKABLE quint16 CRC16_CCITT_FALSE(char *data, quint16 dataLen);
-    Q_INVOKABLE quint16 CRC16_XMODEM(char *data, quint16 dataLen);
-    Q_INVOKABLE quint16 CRC16_X25(char *data, quint16 dataLen);
-    Q_INVOKABLE quint16 CRC16_MODBUS(char *data, quint16 dataLen);
-    Q_INVOKABLE quint16 CRC16_IBM(char* data, quint16 dataLen);
-    Q_INVOKABLE quint16 CRC16_MAXIM(char *data, quint16 dataLen);
-    Q_INVOKABLE quint16 CRC16_USB(char* data, quint16 dataLen);
-    Q_INVOKABLE quint16 CRC16_DNP(char *data, quint16 dataLen);
-
-    Q_INVOKABLE quint32 CRC32_WINRAR(char *data, quint16 dataLen);         // WinRar使用该校验算法
-    Q_INVOKABLE quint32 CRC32_MPEG(char *data, quint16 dataLen);    // MPEG使用该校验算法
+    Q_INVOKABLE quint8 CRC8(char *data, qint64 dataLen);
+    Q_INVOKABLE quint8 CRC8_MAXIM(char *data, qint64 dataLen);
+    Q_INVOKABLE quint8 CRC8_ITU(char *data, qint64 dataLen);
+    Q_INVOKABLE quint8 CRC8_ROHC(char *data, qint64 dataLen);
+
+    Q_INVOKABLE quint16 CRC16_CCITT_TRUE(char *data, qint64 dataLen);
+    Q_INVOKABLE quint16 CRC16_CCITT_FALSE(char *data, qint64 dataLen);
+    Q_INVOKABLE quint16 CRC16_XMODEM(char *data, qint64 dataLen);
+    Q_INVOKABLE quint16 CRC16_X25(char *data, qint64 dataLen);
+    Q_INVOKABLE quint16 CRC16_MODBUS(char *data, qint64 dataLen);
+    Q_INVOKABLE quint16 CRC16_IBM(char* data, qint64 dataLen);
+    Q_INVOKABLE quint16 CRC16_MAXIM(char *data, qint64 dataLen);
+    Q_INVOKABLE quint16 CRC16_USB(char* data, qint64 dataLen);
+    Q_INVOKABLE quint16 CRC16_DNP(char *data, qint64 dataLen);
+
+    Q_INVOKABLE quint32 CRC32_WINRAR(char *data, qint64 dataLen);         // WinRar使用该校验算法
+    Q_INVOKABLE quint32 CRC32_MPEG(char *data, qint64 dataLen);    // MPEG使用该校验算法
 
     // MD5加密算法
     Q_INVOKABLE QByteArray MD5(const QByteArray &data);
+    // SHA-256、BLAKE3加密算法，XXH3非加密摘要（64位、128位）
+    Q_INVOKABLE QByteArray SHA256(const QByteArray &data);
+    Q_INVOKABLE QByteArray XXH3_64(const QByteArray &data);
+    Q_INVOKABLE QByteArray XXH3_128(const QByteArray &data);
+    Q_INVOKABLE QByteArray BLAKE3(const QByteArray &data);
 
     // 校验和系列算法
-    Q_INVOKABLE quint8 CHECKSUM_8(char *data, quint16 dataLen);
-    Q_INVOKABLE quint8 CHECKSUM_8_REVERSE(char *data, quint16 dataLen);
-    Q_INVOKABLE quint16 CHECKSUM_16(char *data, quint16 dataLen);
-    Q_INVOKABLE quint16 CHECKSUM_16_REVERSE(char *data, quint16 dataLen);
-    Q_INVOKABLE quint8 SUMCHECK_8(char *data, quint16 dataLen);
-    Q_INVOKABLE quint8 XOR_8(char *data, quint16 dataLen);
+    Q_INVOKABLE quint8 CHECKSUM_8(char *data, qint64 dataLen);
+    Q_INVOKABLE quint8 CHECKSUM_8_REVERSE(char *data, qint64 dataLen);
+    Q_INVOKABLE quint16 CHECKSUM_16(char *data, qint64 dataLen);
+    Q_INVOKABLE quint16 CHECKSUM_16_REVERSE(char *data, qint64 dataLen);
+    Q_INVOKABLE quint8 SUMCHECK_8(char *data, qint64 dataLen);
+    Q_INVOKABLE quint8 XOR_8(char *data, qint64 dataLen);
 
 
 private slots:
@@ -107,8 +115,14 @@ private slots:
 
     void on_comboBox_ChecksumLength_currentIndexChanged(int index);
 
+    void on_comboBox_CheckAlgorithm_currentIndexChanged(int index);
+
     void on_pushButton_Generate_Checkcode_clicked();
 
+    void on_pushButton_Generate_AllCheckcodes_clicked();
+
+    void on_pushButton_Detect_Checkcode_clicked();
+
     // 选择CRC校验码字节序的多个QRadioButton控件的槽函数
     void onRadioClickSelecByteOrder();
 
@@ -120,7 +134,17 @@ private slots:
 
     void on_pushButton_Select_File_clicked();
 
-    // 选择MD5校验码输入数据类型的两个QRadioButton控件的槽函数
+    // 文件摘要计算结束
+    void onFileHashFinished(const QByteArray &digest);
+    void onFileHashStopped();
+
+    void on_pushButton_Select_CheckFile_clicked();
+
+    void onFileCheckFinished(const QByteArray &code);
+
+    void onCrcSearchFinished();
+
+    // 选择摘要输入数据类型的两个QRadioButton控件的槽函数
     void onRadioClickSelecDataType();
 
     void on_checkBox_ByteOrder_stateChanged(int arg1);
@@ -129,14 +153,14 @@ private slots:
 
     void on_pushButton_Generate_Checksum_clicked();
 
+    void on_comboBox_CheckSum_currentIndexChanged(int index);
+
     void on_checkBox_Checksum_ByteOrder_stateChanged(int arg1);
 
     void on_checkBox_Checksum_FormatData_stateChanged(int arg1);
 
     void on_pushButton_Clear_Checksum_clicked();
 
-    void on_textEdit_ChecksumInput_textChanged();
-
     void on_pushButton_Clear_Checkcode_clicked();
 
     void on_comboBox_CheckAlgorithm_activated(int index);
@@ -146,9 +170,6 @@ private slots:
     void on_textEdit_MD5Input_textChanged();
 
 private:
-    void InvertUint16(quint16 *destUShort, quint16 *srcUShort);
-    void InvertUint8(quint8 *destUch, quint8 *srcUch);
-    void InvertUint32(quint32 *destUInt, quint32 *srcUInt);
     // 显示CRC8校验配置列表
     void DisPlay_CRC8_Configation_List();
     void DisPlay_CRC16_Configation_List();
@@ -157,6 +178,18 @@ private:
     void HexCharInput(QTextEdit* textEdit);
     // 初始化CRC校验配置参数
     void Init_CRC_Config_Params();
+    // 当前校验码长度对应的CRC参数配置表，width返回该表的缺省CRC宽度
+    const QVector<QVector<QString>>* Current_CRC_Sheet(int *width) const;
+    // 用当前选择的CRC算法计算data的校验码，与上次计算的数据等长时增量更新
+    quint64 Compute_Checkcode(const QByteArray &data);
+    // 识别校验算法时注册表中没有一致的算法，在后台由样本帧反推当前校验码长度的CRC参数
+    void Detect_Crc_Params(const QVector<QByteArray> &frames);
+    // 摘要算法下拉框当前选择的算法
+    HashContext::Algorithm Current_Hash_Algorithm() const;
+    // 显示摘要计算速度：bytes字节用时nsecs纳秒
+    void Show_Hash_Speed(qint64 bytes, qint64 nsecs);
+    // 单次摘要计算的耗时达到该值（纳秒）才显示速度
+    static constexpr qint64 MinHashSpeedNsecs = 1000000;
 
     Ui::NumberConvertForm *ui;
 
@@ -165,7 +198,7 @@ private:
     QVector<QVector<QString>> crc8Data;
     QVector<QVector<QString>> crc32Data;
 
-    TypeConvert tcInstance = TypeConvert::getTCInstance();
+    TypeConvert &tcInstance = TypeConvert::getTCInstance();
     // false：小端存储；true：大端存储。缺省为小端存储
     bool  crcByteOrder = false;
     QButtonGroup *sendModeGroup = nullptr;
@@ -176,8 +209,27 @@ private:
     // false：小端存储；true：大端存储。缺省为大端存储
     bool  checksumByteOrder = true;
 
-    // MD5输入文件大小，小于loadSize，一次性读取所有内容计算MD5值；大于则分段读取文件内容，计算MD5值
-    const qint64 loadSize = 1024*10;
+    // 当前选择的CRC校验算法和校验和算法
+    const CheckAlgorithm *checkAlgorithm = nullptr;
+    // 当前选择的是配置表中的自定义CRC算法时，按参数生成的模型
+    QSharedPointer<const CrcModel> customCrc;
+    // 上次产生校验码的数据、算法、校验码及追加到帧尾的校验码字节，供Compute_Checkcode增量更新
+    QByteArray lastCheckData;
+    const CheckAlgorithm *lastCheckAlgorithm = nullptr;
+    QSharedPointer<const CrcModel> lastCustomCrc;
+    quint64 lastCheckcode = 0;
+    QByteArray lastCode;
+    const CheckAlgorithm *checksumAlgorithm = nullptr;
+
+    // 在后台计算所选文件的摘要
+    FileHashJob *fileHash = nullptr;
+    // 文件摘要的计时
+    QElapsedTimer fileHashTimer;
+    // 在后台用当前选择的校验算法计算所选文件的校验码
+    FileHashJob *fileCheck = nullptr;
+    // 后台反推CRC参数：结果及失败原因；置为非0时请求取消
+    QFutureWatcher<QPair<QVector<CrcSearchResult>, QString>> *crcSearch = nullptr;
+    QAtomicInt crcSearchCancel;
 
 
 };
@@ -1,8 +1,11 @@
 #include "typeconvert.h"
+#include "hexcodec.h"
+#include <QDebug>
 
 /*********************************************************************************
 ** 函数名称：       HexStringToByteArray
-** 函数描述：       十六进制字符串转QByteArray
+** 函数描述：       十六进制字符串转QByteArray，空白字符（空格、制表符、换行等）作为分隔跳过；
+**                含非法字符时去掉空白后每两个字符一组，含非法字符的组整组丢弃
 ** 函数输入参数：    hexStr：十六进制字符串
 ** 函数输出参数：    无
 ** 函数返回值：      QByteArray
@@ -11,32 +14,57 @@
 **********************************************************************************/
 QByteArray TypeConvert::HexStringToByteArray(const QString &hexStr)
 {
-    bool ok;
-    QString str = hexStr;   // 先转换为函数内局部变量，再使用
-    QByteArray ret; // 定义返回变量
+    QByteArray ret;
+    HexStringToByteArray(hexStr, &ret);
 
-    str = str.remove(" ");  // 去除开始和结尾的空格
-//    str = str.simplified(); // 去除开始和结尾的空格，并且将内部空格变成单个空格，也包括去除ASCII码字符
-    str = StringNoNullToNull(str);  // 无空格的十六进制字符串转为有空格的字符串，如12 AD EE，即在字节间插入空格
-    QStringList list = str.split(" ");  // 通过空格" "分隔字符串
+    return ret;
+}
+
+// 跳过空白字符（空格、制表符、换行等），十六进制数字两两组成一个字节，整段交给SIMD解码，
+// 直接写入out的缓冲区。含非法字符时按原来逐组转换的规则重新转换：去掉空白后每两个字符一组，
+// 含非十六进制字符的组整组丢弃，末尾单个数字按低4位输出，如“1G23”得到0x23
+bool TypeConvert::HexStringToByteArray(const QString &hexStr, QByteArray *out)
+{
+    out->resize(int(HexCodec::maxDecodedSize(hexStr.size())));
+    qint64 invalidPos = -1;
+    const qint64 len = HexCodec::decode(reinterpret_cast<const ushort*>(hexStr.constData()), hexStr.size(),
+                                        reinterpret_cast<uchar*>(out->data()), &invalidPos);
+    if(invalidPos < 0)
+    {
+        out->resize(int(len));
+        return true;
+    }
 
-    foreach(QString s, list)
+    qDebug() << "非法的十六进制字符：" << hexStr.mid(int(invalidPos), 1) << "位置" << invalidPos;
+    char *p = out->data();
+    int value = 0;
+    auto digits = 0;
+    bool valid = true;
+    for(const QChar ch : hexStr)
     {
-        if(!s.isEmpty())
+        const ushort c = ch.unicode();
+        if(c == ' ' || (c >= '\t' && c <= '\r'))
+            continue;
+        const ushort lower = c | 0x20;
+        if(c >= '0' && c <= '9')
+            value = (value << 4) | (c - '0');
+        else if(lower >= 'a' && lower <= 'f')
+            value = (value << 4) | (lower - 'a' + 10);
+        else
+            valid = false;
+        if(++digits == 2)
         {
-            char ch = s.toInt(&ok, 16) & 0xFF;
-            if(ok)
-            {
-                ret.append(ch);
-            }
-            else
-            {
-                qDebug() << "非法的十六进制字符：" << s;
-            }
+            if(valid)
+                *p++ = char(value);
+            value = 0;
+            digits = 0;
+            valid = true;
         }
     }
-
-    return ret;
+    if(digits == 1 && valid)
+        *p++ = char(value);
+    out->resize(int(p - out->data()));
+    return false;
 }
 
 /*********************************************************************************
@@ -50,23 +78,28 @@ QByteArray TypeConvert::HexStringToByteArray(const QString &hexStr)
 **********************************************************************************/
 QString TypeConvert::StringNoNullToNull(const QString &hexStr)
 {
-    QString ret = hexStr;
-    auto len = 0;
-    ret = ret.remove(' ');  // 删除空格符，没有也无影响
-    if(ret.length() % 2 == 0)
-    {
-        len = ret.length()/2;
-    }
-    else if(ret.length() % 2 == 1)
-    {   // 处理字符串长度为奇数
-        len = ret.length() / 2 + 1;
-    }
-    for(auto i = 1; i < len; i++)
+    QString ret;
+    StringNoNullToNull(hexStr, &ret);
+
+    return ret;
+}
+
+// 先统计非空格字符数，一次确定输出长度，再顺序写入，避免逐个insert造成的平方级复制
+void TypeConvert::StringNoNullToNull(const QString &hexStr, QString *out)
+{
+    const int count = hexStr.length() - int(hexStr.count(' '));   // 删除空格符，没有也无影响
+    out->resize(count > 0 ? count + (count - 1) / 2 : 0);
+    QChar *p = out->data();
+    auto n = 0;
+    for(const QChar ch : hexStr)
     {
-       ret.insert(3*i - 1, " ");
+        if(ch == ' ')
+            continue;
+        if(n > 0 && n % 2 == 0)
+            *p++ = ' ';
+        *p++ = ch.toUpper();
+        ++n;
     }
-
-    return ret.toUpper();
 }
 
 /*********************************************************************************
@@ -78,40 +111,48 @@ QString TypeConvert::StringNoNullToNull(const QString &hexStr)
 ** 作者：           zjk
 ** 日期：          ‎2020‎年‎3‎月9‎日 21:28
 **********************************************************************************/
-QString TypeConvert::ByteArrayToHexString(QByteArray baData)
+QString TypeConvert::ByteArrayToHexString(const QByteArray &baData)
 {
-    QString ret(baData.toHex().toUpper());
-    int len = ret.length()/2;
-    for(auto i = 1; i < len; i++)
-    {
-        ret.insert(3*i-1, " ");
-    }
+    QString ret;
+    ByteArrayToHexString(baData.constData(), baData.size(), &ret);
 
     return ret;
 }
 
+void TypeConvert::ByteArrayToHexString(const char *data, int len, QString *out)
+{
+    out->resize(int(HexCodec::encodedLength(len, HexCodec::Spaced)));
+    HexCodec::encode(reinterpret_cast<const uchar*>(data), len, reinterpret_cast<ushort*>(out->data()),
+                     HexCodec::Spaced);
+}
+
 // 整数转换为十六进制字符串，缺省高字节在前、低字节在后 zjk--20210415
-const QString TypeConvert::DecToHexString(quint32 dec, quint16 len, const bool isLittleEndian)
+QString TypeConvert::DecToHexString(quint32 dec, quint16 len, const bool isLittleEndian)
 {
-    QString ret = ""; //  替换字符串
-    quint8 hexArray[len];
-    DecToHex(dec, hexArray, len);
-    QByteArray ba = QByteArray((char*)hexArray, len);
-    if(isLittleEndian)
-    {   // 小端模式，需要高低字节转换
-        char ch = ' ';
-        for (auto i = 0; i < ba.size()/2; i++)
-        {
-            ch = ba.at(i);
-            ba[i] = ba.at(ba.size()-i-1);
-            ba[ba.size()-i-1] = ch;
-        }
-    }
-    ret = ByteArrayToHexString(ba);
+    QString ret;
+    DecToHexString(dec, len, isLittleEndian, &ret);
 
     return ret;
 }
 
+// 按字节序直接从整数中取出各字节写入out，不需要中间的字节数组
+void TypeConvert::DecToHexString(quint32 dec, quint16 len, const bool isLittleEndian, QString *out)
+{
+    static const char digits[] = "0123456789ABCDEF";
+    out->resize(int(HexCodec::encodedLength(len, HexCodec::Spaced)));
+    QChar *p = out->data();
+    for(auto i = 0; i < len; i++)
+    {
+        // 高字节在前时第i个字节为右移8·(len-1-i)位的低8位，超出4字节的部分为0
+        const int shift = 8 * (isLittleEndian ? i : len - 1 - i);
+        const uint byte = shift < 32 ? (dec >> shift) & 0xFF : 0;
+        if(i > 0)
+            *p++ = ' ';
+        *p++ = QLatin1Char(digits[byte >> 4]);
+        *p++ = QLatin1Char(digits[byte & 0x0F]);
+    }
+}
+
 /*********************************************************************************
 ** 函数名称：       DecToHex
 ** 函数描述：       十进制转十六进制
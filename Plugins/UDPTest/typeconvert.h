@@ -1,12 +1,20 @@
 #ifndef TYPECONVERT_H
 #define TYPECONVERT_H
 
-#include <QObject>
-#include <QDebug>
+#include <QByteArray>
+#include <QString>
 
-class TypeConvert : public QObject
+/*********************************************************************************
+** 文件描述：       十六进制字符串、字节数组、整数之间的转换
+** 设计：          无状态，不是QObject，全部为静态函数；getTCInstance()只为兼容原有的调用方式，
+**                各窗体保存单例的引用，不再各自复制一个对象。
+**                带输出指针参数的重载把结果写入调用方的对象：对象没有共享且容量足够时只修改长度，
+**                不分配内存，逐帧收发时复用同一个输出对象即可避免反复分配；
+**                返回值版本在其基础上创建新对象，便于一次性调用。输出对象不能同时作为输入。
+**********************************************************************************/
+
+class TypeConvert
 {
-    Q_OBJECT
 public:
     /***** Singleton pattern class definition *******/
     static TypeConvert& getTCInstance()
@@ -15,26 +23,29 @@ public:
         return instance;
     }
 
-    TypeConvert(QObject *parent = nullptr): QObject(parent)
-    {
-    }
-
-    TypeConvert(const TypeConvert&, QObject *parent = nullptr): QObject(parent)
-    {
-    }
+    TypeConvert(const TypeConvert&) = delete;
+    TypeConvert& operator=(const TypeConvert&) = delete;
 
     /***** Function definition *******/
     // 十六进制字符串转QByteArray
-    QByteArray HexStringToByteArray(const QString &hexStr);
+    static QByteArray HexStringToByteArray(const QString &hexStr);
+    // 十六进制字符串转字节写入out（替换原有内容），含非法字符时丢弃所在的两字符组并返回false
+    static bool HexStringToByteArray(const QString &hexStr, QByteArray *out);
     // 无空格的十六进制字符串转有空格的十六进制字符串
-    QString StringNoNullToNull(const QString &hexStr);
+    static QString StringNoNullToNull(const QString &hexStr);
+    static void StringNoNullToNull(const QString &hexStr, QString *out);
     // QByteArray转十六进制字符串
-    QString ByteArrayToHexString(QByteArray baData);
+    static QString ByteArrayToHexString(const QByteArray &baData);
+    // len个字节转十六进制字符串写入out（替换原有内容）
+    static void ByteArrayToHexString(const char *data, int len, QString *out);
     // 缺省转换为4Bytes长度
-    const QString DecToHexString(quint32, quint16 len = 4, const bool isLittleEndian = false);
+    static QString DecToHexString(quint32 dec, quint16 len = 4, const bool isLittleEndian = false);
+    static void DecToHexString(quint32 dec, quint16 len, const bool isLittleEndian, QString *out);
     // 十进制转十六进制
-    void DecToHex(int dec, quint8 *hex, int len);
+    static void DecToHex(int dec, quint8 *hex, int len);
 
+private:
+    TypeConvert() = default;
 };
 
 #endif // TYPECONVERT_H